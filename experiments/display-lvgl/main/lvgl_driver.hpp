@@ -4,6 +4,7 @@
 #include "lvgl.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 // Global display instance
 extern LGFX display;
@@ -11,24 +12,102 @@ extern LGFX display;
 // TFT power pin - MUST be enabled for display to work
 #define TFT_I2C_POWER 7
 
-// LVGL flush callback - draws the buffer to the screen
+// Draw buffer size as a fraction of the screen (1 = full screen)
+#define LVGL_BUF_DIVISOR 10
+
+// Run the full-screen invalidation FPS sweep at startup
+#define LVGL_FLUSH_BENCHMARK 0
+
+static lv_display_t *lvgl_display = NULL;
+static uint8_t *lvgl_buf1 = NULL;
+static uint8_t *lvgl_buf2 = NULL;
+
+// LVGL flush callback - starts a DMA transfer of the buffer and returns
+// immediately, so LVGL can render into the other buffer meanwhile.
+// LovyanGFX has no transfer-done callback; completion is reported from
+// lvgl_flush_wait_cb, which LVGL calls before it needs this buffer again.
 void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
 
-    // Use LovyanGFX to draw the buffer
-    display.startWrite();
-    display.setAddrWindow(area->x1, area->y1, w, h);
-    display.writePixels((lgfx::rgb565_t *)px_map, w * h);
-    display.endWrite();
+    // Keep the bus transaction open across flushes so DMA isn't waited on in endWrite
+    if (display.getStartCount() == 0) {
+        display.startWrite();
+    }
+    display.pushImageDMA(area->x1, area->y1, w, h, (lgfx::rgb565_t *)px_map);
+}
 
-    // Inform LVGL that flushing is complete
+// LVGL flush wait callback - blocks until the in-flight DMA has finished
+void lvgl_flush_wait_cb(lv_display_t *disp)
+{
+    display.waitDMA();
     lv_display_flush_ready(disp);
 }
 
-// Initialize LVGL with LovyanGFX backend
-void lvgl_init(void)
+// (Re)allocate both draw buffers at 1/divisor of the screen and hand them to
+// LVGL. On failure the buffers LVGL already has are kept.
+bool lvgl_set_draw_buffers(uint32_t divisor)
+{
+    uint32_t pixel_size = lv_color_format_get_size(lv_display_get_color_format(lvgl_display));
+    uint32_t buf_bytes = display.width() * display.height() / divisor * pixel_size;
+
+    uint8_t *buf1 = (uint8_t *)heap_caps_malloc(buf_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    uint8_t *buf2 = (uint8_t *)heap_caps_malloc(buf_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!buf1 || !buf2) {
+        ESP_LOGE("LVGL_DRIVER", "Failed to allocate 2x %lu byte draw buffers", (unsigned long)buf_bytes);
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        return false;
+    }
+
+    // Old buffers may still be in flight
+    display.waitDMA();
+    lv_display_set_buffers(lvgl_display, buf1, buf2, buf_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    heap_caps_free(lvgl_buf1);
+    heap_caps_free(lvgl_buf2);
+    lvgl_buf1 = buf1;
+    lvgl_buf2 = buf2;
+    return true;
+}
+
+// Measure full-screen invalidation FPS for 1/10, 1/4 and full-screen buffers
+void lvgl_benchmark_flush(void)
+{
+    static const uint32_t divisors[] = {10, 4, 1};
+    const int frames = 50;
+
+    for (uint32_t divisor : divisors) {
+        if (!lvgl_set_draw_buffers(divisor)) {
+            continue;
+        }
+
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < frames; i++) {
+            lv_obj_invalidate(lv_screen_active());
+            lv_refr_now(lvgl_display);
+        }
+        display.waitDMA();
+        int64_t elapsed = esp_timer_get_time() - start;
+
+        ESP_LOGI("LVGL_DRIVER", "Flush benchmark: buffer 1/%lu screen -> %.1f FPS (%lld us/frame)",
+                 (unsigned long)divisor, frames * 1e6f / elapsed, elapsed / frames);
+    }
+
+    // Restore the configured buffer size (the last one that fit stays otherwise)
+    if (!lvgl_set_draw_buffers(LVGL_BUF_DIVISOR)) {
+        ESP_LOGW("LVGL_DRIVER", "Keeping the benchmark's last draw buffers");
+    }
+}
+
+// LVGL tick source - timer deadlines returned by lv_timer_handler depend on it
+uint32_t lvgl_tick_cb(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// Initialize LVGL with LovyanGFX backend; false if the draw buffers don't fit
+bool lvgl_init(void)
 {
     // Enable TFT power (GPIO7 must be HIGH)
     ESP_LOGI("LVGL_DRIVER", "Enabling TFT power on GPIO%d...", TFT_I2C_POWER);
@@ -51,23 +130,22 @@ void lvgl_init(void)
 
     // Initialize LVGL
     lv_init();
+    lv_tick_set_cb(lvgl_tick_cb);
 
     // Get display dimensions
     uint32_t screen_width = display.width();
     uint32_t screen_height = display.height();
 
     // Create LVGL display
-    lv_display_t *lv_disp = lv_display_create(screen_width, screen_height);
-
-    // Allocate draw buffers (1/10th of screen size for each buffer)
-    uint32_t buf_size = screen_width * screen_height / 10;
-
-    static lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-    static lv_color_t *buf2 = (lv_color_t *)heap_caps_malloc(buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    lvgl_display = lv_display_create(screen_width, screen_height);
 
-    // Set the buffers
-    lv_display_set_buffers(lv_disp, buf1, buf2, buf_size * sizeof(lv_color_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    // Allocate double draw buffers (1/LVGL_BUF_DIVISOR of screen size each)
+    if (!lvgl_set_draw_buffers(LVGL_BUF_DIVISOR)) {
+        return false;
+    }
 
-    // Set the flush callback
-    lv_display_set_flush_cb(lv_disp, lvgl_flush_cb);
+    // Set the flush callbacks (DMA start + completion wait)
+    lv_display_set_flush_cb(lvgl_display, lvgl_flush_cb);
+    lv_display_set_flush_wait_cb(lvgl_display, lvgl_flush_wait_cb);
+    return true;
 }
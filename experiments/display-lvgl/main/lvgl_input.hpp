@@ -0,0 +1,215 @@
+#pragma once
+
+#include "lvgl.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Interrupt-driven LVGL button input device
+//
+// GPIO any-edge interrupts push (button, level, timestamp) into a ring
+// consumed by the LVGL task and notify it. Each pin is debounced in the ISR
+// with a time gate: an edge within LVGL_INPUT_DEBOUNCE_US of the last
+// accepted one is contact bounce and ignored. The indev runs in
+// LV_INDEV_MODE_EVENT, so LVGL only reads it when the task calls
+// lvgl_input_process() after a notification - no polling while idle. Long
+// press and repeat need reads while a key is held, so an LVGL timer reads
+// the indev every LVGL_INPUT_HOLD_PERIOD_MS until all keys are up; it also
+// queues a release the debounce gate swallowed.
+
+#define LVGL_INPUT_MAX_BUTTONS    3
+#define LVGL_INPUT_RING_SIZE      16     // Must be a power of two
+#define LVGL_INPUT_DEBOUNCE_US    20000  // Edges closer than this are bounce
+#define LVGL_INPUT_HOLD_PERIOD_MS 30     // Indev read period while a key is held
+
+struct LvglInputButton {
+    gpio_num_t gpio;
+    bool active_low;
+};
+
+struct LvglInputEvent {
+    uint8_t button_id;
+    bool pressed;
+    int64_t timestamp_us;  // esp_timer time at the ISR
+};
+
+// Press latency is ISR timestamp -> LVGL read callback
+struct LvglInputStats {
+    uint32_t events;
+    uint32_t dropped;          // Ring full
+    int64_t latency_total_us;
+    int64_t latency_max_us;
+};
+
+static LvglInputButton input_buttons[LVGL_INPUT_MAX_BUTTONS];
+static uint32_t input_button_count = 0;
+static bool input_last_pressed[LVGL_INPUT_MAX_BUTTONS];
+static int64_t input_last_edge_us[LVGL_INPUT_MAX_BUTTONS];
+
+// Producers (ISR, hold timer) push under input_lock; the LVGL task consumes
+static LvglInputEvent input_ring[LVGL_INPUT_RING_SIZE];
+static volatile uint32_t input_ring_head = 0;  // Written under input_lock
+static volatile uint32_t input_ring_tail = 0;  // Written by LVGL task only
+static portMUX_TYPE input_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t input_notify_task = NULL;
+static lv_indev_t *input_indev = NULL;
+static lv_timer_t *input_hold_timer = NULL;
+static LvglInputStats input_stats = {};
+
+// Last state reported to LVGL (held between events)
+static uint32_t input_current_id = 0;
+static bool input_current_pressed = false;
+
+// Queue a level change of one button unless it is bounce or repeats the
+// level last queued; call with input_lock held. True if queued.
+static bool IRAM_ATTR lvgl_input_push(uint32_t id, bool pressed, int64_t now)
+{
+    if (pressed == input_last_pressed[id] || now - input_last_edge_us[id] < LVGL_INPUT_DEBOUNCE_US) {
+        return false;
+    }
+
+    uint32_t head = input_ring_head;
+    if (head - input_ring_tail >= LVGL_INPUT_RING_SIZE) {
+        input_stats.dropped++;
+        return false;
+    }
+    input_last_pressed[id] = pressed;
+    input_last_edge_us[id] = now;
+    input_ring[head & (LVGL_INPUT_RING_SIZE - 1)] = {(uint8_t)id, pressed, now};
+    input_ring_head = head + 1;
+    return true;
+}
+
+static void IRAM_ATTR lvgl_input_isr(void *arg)
+{
+    uint32_t id = (uint32_t)arg;
+    bool pressed = (gpio_get_level(input_buttons[id].gpio) == 0) == input_buttons[id].active_low;
+
+    portENTER_CRITICAL_ISR(&input_lock);
+    bool queued = lvgl_input_push(id, pressed, esp_timer_get_time());
+    portEXIT_CRITICAL_ISR(&input_lock);
+    if (!queued) {
+        return;
+    }
+
+    BaseType_t high_task_awoken = pdFALSE;
+    vTaskNotifyGiveFromISR(input_notify_task, &high_task_awoken);
+    portYIELD_FROM_ISR(high_task_awoken);
+}
+
+static bool lvgl_input_any_pressed(void)
+{
+    for (uint32_t i = 0; i < input_button_count; i++) {
+        if (input_last_pressed[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs while a key is held: in event mode LVGL reads only when asked, and
+// long press / repeat are timed across reads
+static void lvgl_input_hold_cb(lv_timer_t *timer)
+{
+    // A release inside the debounce gate raised no later edge; queue it now
+    int64_t now = esp_timer_get_time();
+    for (uint32_t i = 0; i < input_button_count; i++) {
+        bool pressed = (gpio_get_level(input_buttons[i].gpio) == 0) == input_buttons[i].active_low;
+        portENTER_CRITICAL(&input_lock);
+        lvgl_input_push(i, pressed, now);
+        portEXIT_CRITICAL(&input_lock);
+    }
+
+    lv_indev_read(input_indev);
+    if (!lvgl_input_any_pressed() && input_ring_tail == input_ring_head) {
+        lv_timer_pause(timer);
+    }
+}
+
+// LVGL read callback - consumes one ring event per call
+static void lvgl_input_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    uint32_t tail = input_ring_tail;
+    if (tail != input_ring_head) {
+        const LvglInputEvent &event = input_ring[tail & (LVGL_INPUT_RING_SIZE - 1)];
+        input_current_id = event.button_id;
+        input_current_pressed = event.pressed;
+
+        int64_t latency = esp_timer_get_time() - event.timestamp_us;
+        input_stats.events++;
+        input_stats.latency_total_us += latency;
+        if (latency > input_stats.latency_max_us) {
+            input_stats.latency_max_us = latency;
+        }
+
+        input_ring_tail = ++tail;
+        data->continue_reading = (tail != input_ring_head);
+
+        if (event.pressed) {
+            lv_timer_resume(input_hold_timer);
+        }
+    }
+
+    data->btn_id = input_current_id;
+    data->state = input_current_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+// Create the indev and attach GPIO interrupts. notify_task is woken on input.
+void lvgl_input_init(const LvglInputButton *buttons, uint32_t count, TaskHandle_t notify_task)
+{
+    input_button_count = count < LVGL_INPUT_MAX_BUTTONS ? count : LVGL_INPUT_MAX_BUTTONS;
+    input_notify_task = notify_task;
+
+    gpio_install_isr_service(0);
+
+    for (uint32_t i = 0; i < input_button_count; i++) {
+        input_buttons[i] = buttons[i];
+
+        gpio_config_t io_conf = {};
+        io_conf.intr_type = GPIO_INTR_ANYEDGE;
+        io_conf.mode = GPIO_MODE_INPUT;
+        io_conf.pin_bit_mask = (1ULL << buttons[i].gpio);
+        io_conf.pull_up_en = buttons[i].active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
+        io_conf.pull_down_en = buttons[i].active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE;
+        gpio_config(&io_conf);
+
+        input_last_pressed[i] = (gpio_get_level(buttons[i].gpio) == 0) == buttons[i].active_low;
+        input_last_edge_us[i] = -LVGL_INPUT_DEBOUNCE_US;
+        gpio_isr_handler_add(buttons[i].gpio, lvgl_input_isr, (void *)i);
+    }
+
+    input_indev = lv_indev_create();
+    lv_indev_set_type(input_indev, LV_INDEV_TYPE_BUTTON);
+    lv_indev_set_read_cb(input_indev, lvgl_input_read_cb);
+    lv_indev_set_mode(input_indev, LV_INDEV_MODE_EVENT);
+
+    input_hold_timer = lv_timer_create(lvgl_input_hold_cb, LVGL_INPUT_HOLD_PERIOD_MS, NULL);
+    if (!lvgl_input_any_pressed()) {
+        lv_timer_pause(input_hold_timer);
+    }
+
+    ESP_LOGI("LVGL_INPUT", "Interrupt-driven input: %lu buttons", (unsigned long)input_button_count);
+}
+
+// Screen points "pressed" by each button (index = button id); must stay valid
+void lvgl_input_set_points(const lv_point_t *points)
+{
+    lv_indev_set_button_points(input_indev, points);
+}
+
+// Feed pending ring events to LVGL (call from the LVGL task after a notification)
+void lvgl_input_process(void)
+{
+    if (input_ring_tail != input_ring_head) {
+        lv_indev_read(input_indev);
+    }
+}
+
+LvglInputStats lvgl_input_get_stats(void)
+{
+    return input_stats;
+}
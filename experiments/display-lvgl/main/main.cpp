@@ -4,6 +4,7 @@
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "lvgl_driver.hpp"
+#include "lvgl_input.hpp"
 
 static const char *TAG = "LVGL_DEMO";
 
@@ -20,112 +21,64 @@ LGFX display;
 #define BUTTON_WIDTH 60  // Configurable button width
 #define BUTTON_SPACING 5 // Spacing between buttons
 
+// LVGL task runs on the second core, leaving core 0 to WiFi/ISRs
+#define LVGL_TASK_CORE 1
+
 // LVGL button objects
 static lv_obj_t *btn_d0 = NULL;
 static lv_obj_t *btn_d1 = NULL;
 static lv_obj_t *btn_d2 = NULL;
 
-// Initialize GPIO pins for button inputs (polling mode)
-void init_gpio_buttons(void)
-{
-    // Configure D0 (active low with pull-up)
-    gpio_config_t io_conf_d0 = {};
-    io_conf_d0.intr_type = GPIO_INTR_DISABLE;  // No interrupts, use polling
-    io_conf_d0.mode = GPIO_MODE_INPUT;
-    io_conf_d0.pin_bit_mask = (1ULL << GPIO_D0);
-    io_conf_d0.pull_up_en = GPIO_PULLUP_ENABLE;
-    io_conf_d0.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    gpio_config(&io_conf_d0);
-
-    // Configure D1 (active high with pull-down)
-    gpio_config_t io_conf_d1 = {};
-    io_conf_d1.intr_type = GPIO_INTR_DISABLE;  // No interrupts, use polling
-    io_conf_d1.mode = GPIO_MODE_INPUT;
-    io_conf_d1.pin_bit_mask = (1ULL << GPIO_D1);
-    io_conf_d1.pull_up_en = GPIO_PULLUP_DISABLE;
-    io_conf_d1.pull_down_en = GPIO_PULLDOWN_ENABLE;
-    gpio_config(&io_conf_d1);
-
-    // Configure D2 (active high with pull-down)
-    gpio_config_t io_conf_d2 = {};
-    io_conf_d2.intr_type = GPIO_INTR_DISABLE;  // No interrupts, use polling
-    io_conf_d2.mode = GPIO_MODE_INPUT;
-    io_conf_d2.pin_bit_mask = (1ULL << GPIO_D2);
-    io_conf_d2.pull_up_en = GPIO_PULLUP_DISABLE;
-    io_conf_d2.pull_down_en = GPIO_PULLDOWN_ENABLE;
-    gpio_config(&io_conf_d2);
-
-    ESP_LOGI(TAG, "GPIO buttons initialized (polling mode): D0=%d, D1=%d, D2=%d", GPIO_D0, GPIO_D1, GPIO_D2);
-}
+// Hardware buttons, index = LVGL button id
+static const LvglInputButton input_buttons_config[] = {
+    {(gpio_num_t)GPIO_D0, true},   // D0 - active low
+    {(gpio_num_t)GPIO_D1, false},  // D1 - active high
+    {(gpio_num_t)GPIO_D2, false},  // D2 - active high
+};
 
-// LVGL timer task with GPIO polling
+// Screen point each hardware button presses (centre of its on-screen button)
+static lv_point_t input_button_points[3];
+
+// LVGL timer task - blocks until input arrives or the next LVGL timer is due
 void lvgl_timer_task(void *pvParameter)
 {
-    static bool last_d0_state = false;
-    static bool last_d1_state = false;
-    static bool last_d2_state = false;
-    static int poll_count = 0;
-
     ESP_LOGI(TAG, "LVGL timer task started");
 
-    while (1) {
-        // Poll GPIO states
-        int d0_level = gpio_get_level((gpio_num_t)GPIO_D0);
-        int d1_level = gpio_get_level((gpio_num_t)GPIO_D1);
-        int d2_level = gpio_get_level((gpio_num_t)GPIO_D2);
-
-        // Debug: Log GPIO levels periodically
-        if (++poll_count % 200 == 0) {
-            ESP_LOGI(TAG, "GPIO levels: D0=%d D1=%d D2=%d", d0_level, d1_level, d2_level);
-        }
-
-        // Determine current button states
-        bool d0_pressed = (d0_level == 0);  // Active low
-        bool d1_pressed = (d1_level == 1);  // Active high
-        bool d2_pressed = (d2_level == 1);  // Active high
-
-        // Update button visual states if they changed
-        if (d0_pressed != last_d0_state) {
-            last_d0_state = d0_pressed;
-            if (d0_pressed) {
-                lv_obj_add_state(btn_d0, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D0 PRESSED");
-            } else {
-                lv_obj_remove_state(btn_d0, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D0 RELEASED");
-            }
-            lv_obj_invalidate(btn_d0);  // Force redraw
-        }
+    lvgl_input_init(input_buttons_config, 3, xTaskGetCurrentTaskHandle());
+    lvgl_input_set_points(input_button_points);
 
-        if (d1_pressed != last_d1_state) {
-            last_d1_state = d1_pressed;
-            if (d1_pressed) {
-                lv_obj_add_state(btn_d1, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D1 PRESSED");
-            } else {
-                lv_obj_remove_state(btn_d1, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D1 RELEASED");
-            }
-            lv_obj_invalidate(btn_d1);  // Force redraw
-        }
+    // Load statistics (wakeups and time spent awake per report window)
+    uint32_t wakeups = 0;
+    int64_t busy_us = 0;
+    int64_t report_start = esp_timer_get_time();
 
-        if (d2_pressed != last_d2_state) {
-            last_d2_state = d2_pressed;
-            if (d2_pressed) {
-                lv_obj_add_state(btn_d2, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D2 PRESSED");
-            } else {
-                lv_obj_remove_state(btn_d2, LV_STATE_PRESSED);
-                ESP_LOGI(TAG, "D2 RELEASED");
-            }
-            lv_obj_invalidate(btn_d2);  // Force redraw
-        }
+    while (1) {
+        int64_t wake_time = esp_timer_get_time();
 
-        // Update LVGL timers and tasks
+        // Feed queued button events, then run LVGL timers
+        lvgl_input_process();
         uint32_t delay = lv_timer_handler();
 
-        // Sleep for the time recommended by LVGL (or minimum 5ms for responsive button polling)
-        vTaskDelay(pdMS_TO_TICKS(delay < 5 ? 5 : delay));
+        int64_t now = esp_timer_get_time();
+        wakeups++;
+        busy_us += now - wake_time;
+
+        if (now - report_start >= 5000000) {
+            LvglInputStats stats = lvgl_input_get_stats();
+            int64_t window_us = now - report_start;
+            ESP_LOGI(TAG, "Load: %.1f wakeups/s, %.2f%% busy | Input: %lu events, latency avg %lld us max %lld us, %lu dropped",
+                     wakeups * 1e6f / window_us, busy_us * 100.0f / window_us,
+                     (unsigned long)stats.events,
+                     stats.events ? stats.latency_total_us / stats.events : 0,
+                     stats.latency_max_us, (unsigned long)stats.dropped);
+            wakeups = 0;
+            busy_us = 0;
+            report_start = now;
+        }
+
+        // Sleep until the next LVGL deadline or an input notification
+        TickType_t wait = (delay == LV_NO_TIMER_READY) ? portMAX_DELAY : pdMS_TO_TICKS(delay);
+        ulTaskNotifyTake(pdTRUE, wait > 0 ? wait : 1);
     }
 }
 
@@ -135,11 +88,11 @@ extern "C" void app_main(void)
     vTaskDelay(pdMS_TO_TICKS(500));
     ESP_LOGI(TAG, "Starting LVGL button display...");
 
-    // Initialize GPIO buttons
-    init_gpio_buttons();
-
     // Initialize LVGL with LovyanGFX backend
-    lvgl_init();
+    if (!lvgl_init()) {
+        ESP_LOGE(TAG, "LVGL init failed, no display");
+        return;
+    }
 
     ESP_LOGI(TAG, "LVGL initialized, creating UI...");
 
@@ -194,10 +147,19 @@ extern "C" void app_main(void)
     lv_label_set_text(label_d0, "D0");
     lv_obj_center(label_d0);
 
+    // Hardware buttons press the centre of their on-screen counterparts
+    input_button_points[0] = {button_x_pos + BUTTON_WIDTH / 2, BUTTON_SPACING * 3 + button_height * 2 + button_height / 2};
+    input_button_points[1] = {button_x_pos + BUTTON_WIDTH / 2, BUTTON_SPACING * 2 + button_height + button_height / 2};
+    input_button_points[2] = {button_x_pos + BUTTON_WIDTH / 2, BUTTON_SPACING + button_height / 2};
+
     ESP_LOGI(TAG, "UI created successfully!");
 
+#if LVGL_FLUSH_BENCHMARK
+    lvgl_benchmark_flush();
+#endif
+
     // Create LVGL timer task
-    xTaskCreate(lvgl_timer_task, "lvgl_timer", 4096, NULL, 5, NULL);
+    xTaskCreatePinnedToCore(lvgl_timer_task, "lvgl_timer", 4096, NULL, 5, NULL, LVGL_TASK_CORE);
 
     ESP_LOGI(TAG, "Button display running...");
 }
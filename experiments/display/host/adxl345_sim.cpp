@@ -0,0 +1,200 @@
+#include "adxl345_sim.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static constexpr float RAD_PER_DEG = (float)M_PI / 180.0f;
+
+Adxl345Sim::Adxl345Sim(const Config& config_param)
+    : config(config_param), rng(config_param.seed), noise(0.0f, 1.0f), regs(),
+      fifo(), fifo_head(0), fifo_count(0), latest(), next_sample_us(0), last_time_us(0),
+      overflows(0), samples(0), act_reference(), act_reference_valid(false), inactive_since_us(0) {
+    regs[adxl345::REG_DEVID] = adxl345::DEVID;
+    regs[adxl345::REG_BW_RATE] = adxl345::RATE_100_HZ;
+
+    // Z-Y-X mounting rotation, transposed to map frame axes into the sensor.
+    // Firmware convention: pitch turns about X, roll about Y.
+    float cr = cosf(config.mount_pitch_deg * RAD_PER_DEG), sr = sinf(config.mount_pitch_deg * RAD_PER_DEG);
+    float cp = cosf(config.mount_roll_deg * RAD_PER_DEG), sp = sinf(config.mount_roll_deg * RAD_PER_DEG);
+    float cy = cosf(config.mount_yaw_deg * RAD_PER_DEG), sy = sinf(config.mount_yaw_deg * RAD_PER_DEG);
+    float r[3][3] = {
+        {cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+        {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+        {-sp, cp * sr, cp * cr},
+    };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            mount[i][j] = r[j][i];
+        }
+    }
+}
+
+int64_t Adxl345Sim::samplePeriodUs() const {
+    return (int64_t)(1e6f / adxl345::rate_hz(regs[adxl345::REG_BW_RATE]));
+}
+
+Adxl345Sim::Sample Adxl345Sim::measure(int64_t t_us) {
+    Vec3 a = config.source(t_us);
+    float v[3] = {a.x, a.y, a.z};
+    float bias[3] = {config.bias_g.x, config.bias_g.y, config.bias_g.z};
+
+    // Noise over the output bandwidth (ODR / 2)
+    float bandwidth = adxl345::rate_hz(regs[adxl345::REG_BW_RATE]) * 0.5f;
+    float sigma_g = config.noise_ug_per_rt_hz * 1e-6f * sqrtf(bandwidth);
+
+    // Full resolution: 3.9 mg/LSB, clamped to the selected range
+    int range_g = 2 << (regs[adxl345::REG_DATA_FORMAT] & 0x03);
+    int limit = range_g * (int)adxl345::LSB_PER_G;
+
+    int16_t out[3];
+    for (int i = 0; i < 3; i++) {
+        float g = mount[i][0] * v[0] + mount[i][1] * v[1] + mount[i][2] * v[2];
+        g += bias[i] + sigma_g * noise(rng);
+        int raw = (int)lrintf(g * adxl345::LSB_PER_G);
+        raw += (int8_t)regs[adxl345::REG_OFSX + i] * adxl345::OFS_TO_RAW;
+        raw = raw >= limit ? limit - 1 : raw < -limit ? -limit : raw;
+        out[i] = (int16_t)raw;
+    }
+    return Sample{out[0], out[1], out[2]};
+}
+
+void Adxl345Sim::pushSample(const Sample& sample, int64_t t_us) {
+    latest = sample;
+    samples++;
+
+    if ((regs[adxl345::REG_FIFO_CTL] & 0xC0) == adxl345::FIFO_MODE_STREAM) {
+        if (fifo_count == adxl345::FIFO_DEPTH) {
+            // Stream mode: oldest entry is overwritten
+            fifo_head = (fifo_head + 1) % adxl345::FIFO_DEPTH;
+            fifo_count--;
+            overflows++;
+        }
+        fifo[(fifo_head + fifo_count) % adxl345::FIFO_DEPTH] = sample;
+        fifo_count++;
+    }
+    updateMotion(sample, t_us);
+}
+
+void Adxl345Sim::updateMotion(const Sample& sample, int64_t t_us) {
+    uint8_t enabled = regs[adxl345::REG_INT_ENABLE];
+    if (!(enabled & (adxl345::INT_ACTIVITY | adxl345::INT_INACTIVITY))) {
+        return;
+    }
+
+    // AC-coupled: thresholds apply to the change from a reference sample
+    if (!act_reference_valid) {
+        act_reference = sample;
+        act_reference_valid = true;
+        inactive_since_us = t_us;
+    }
+    int delta = abs(sample.x - act_reference.x);
+    delta = abs(sample.y - act_reference.y) > delta ? abs(sample.y - act_reference.y) : delta;
+    delta = abs(sample.z - act_reference.z) > delta ? abs(sample.z - act_reference.z) : delta;
+    float delta_mg = delta * 1000.0f / adxl345::LSB_PER_G;
+
+    float act_mg = regs[adxl345::REG_THRESH_ACT] * adxl345::THRESH_MG_PER_LSB;
+    float inact_mg = regs[adxl345::REG_THRESH_INACT] * adxl345::THRESH_MG_PER_LSB;
+
+    if ((enabled & adxl345::INT_ACTIVITY) && delta_mg > act_mg) {
+        regs[adxl345::REG_INT_SOURCE] |= adxl345::INT_ACTIVITY;
+        act_reference = sample;
+        inactive_since_us = t_us;
+    } else if (delta_mg > inact_mg) {
+        act_reference = sample;
+        inactive_since_us = t_us;
+    } else if ((enabled & adxl345::INT_INACTIVITY) &&
+               t_us - inactive_since_us >= regs[adxl345::REG_TIME_INACT] * 1000000LL) {
+        regs[adxl345::REG_INT_SOURCE] |= adxl345::INT_INACTIVITY;
+        inactive_since_us = t_us;
+    }
+}
+
+void Adxl345Sim::advance(int64_t t_us) {
+    if (!measuring()) {
+        next_sample_us = t_us;
+        last_time_us = t_us;
+        return;
+    }
+
+    int64_t period = samplePeriodUs();
+    while (next_sample_us <= t_us) {
+        pushSample(measure(next_sample_us), next_sample_us);
+        next_sample_us += period;
+    }
+    last_time_us = t_us;
+}
+
+uint8_t Adxl345Sim::readRegister(uint8_t reg) {
+    switch (reg) {
+        case adxl345::REG_FIFO_STATUS:
+            return (uint8_t)fifo_count;
+        case adxl345::REG_INT_SOURCE: {
+            // Reading clears activity/inactivity
+            uint8_t value = regs[reg];
+            regs[reg] = 0;
+            return value;
+        }
+        default:
+            return regs[reg];
+    }
+}
+
+bool Adxl345Sim::write(const uint8_t* data, size_t len) {
+    if (len < 1) {
+        return false;
+    }
+
+    bool was_measuring = measuring();
+    uint8_t reg = data[0];
+    for (size_t i = 1; i < len && reg < sizeof(regs); i++, reg++) {
+        // Read-only registers ignore writes inside a burst
+        if (reg == adxl345::REG_DEVID || reg == 0x2B || reg == adxl345::REG_INT_SOURCE ||
+            (reg >= adxl345::REG_DATAX0 && reg < adxl345::REG_DATAX0 + adxl345::SAMPLE_BYTES) ||
+            reg == adxl345::REG_FIFO_STATUS) {
+            continue;
+        }
+        regs[reg] = data[i];
+        if (reg == adxl345::REG_FIFO_CTL) {
+            fifo_head = 0;
+            fifo_count = 0;
+        }
+        if (reg == adxl345::REG_ACT_INACT_CTL || reg == adxl345::REG_INT_ENABLE) {
+            act_reference_valid = false;
+        }
+    }
+
+    // Start sampling from now when measurement is switched on
+    if (!was_measuring && measuring()) {
+        next_sample_us = last_time_us + samplePeriodUs();
+    }
+    return true;
+}
+
+bool Adxl345Sim::writeRead(const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+    if (wlen != 1) {
+        return false;
+    }
+
+    uint8_t reg = wdata[0];
+    if (reg == adxl345::REG_DATAX0) {
+        // Burst from DATAX0 pops one FIFO entry (or reads the latest sample)
+        Sample sample = latest;
+        if (fifo_count > 0) {
+            sample = fifo[fifo_head];
+            fifo_head = (fifo_head + 1) % adxl345::FIFO_DEPTH;
+            fifo_count--;
+        }
+        uint8_t bytes[adxl345::SAMPLE_BYTES] = {
+            (uint8_t)(sample.x & 0xFF), (uint8_t)(sample.x >> 8),
+            (uint8_t)(sample.y & 0xFF), (uint8_t)(sample.y >> 8),
+            (uint8_t)(sample.z & 0xFF), (uint8_t)(sample.z >> 8),
+        };
+        memcpy(rdata, bytes, rlen < sizeof(bytes) ? rlen : sizeof(bytes));
+        return true;
+    }
+
+    for (size_t i = 0; i < rlen; i++) {
+        rdata[i] = readRegister((uint8_t)(reg + i));
+    }
+    return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include "adxl345_regs.hpp"
+#include "frame_sim.hpp"
+
+// ============================================================================
+// Adxl345Sim - Register-level ADXL345 fed by a simulated acceleration
+// ============================================================================
+// Answers the same register transfers AccelSensor issues: DEVID, the config
+// burst, FIFO stream mode (32 entries, oldest dropped on overflow), FIFO
+// status, DATAX0 pops, offset registers and AC-coupled activity/inactivity
+// in INT_SOURCE. Samples are produced at the programmed data rate as the
+// simulation clock advances, passed through the mounting rotation, white
+// noise at the configured density, the offset registers and 3.9 mg
+// quantization clamped to the selected range.
+class Adxl345Sim {
+public:
+    // Acceleration in g (frame body axes) at time t_us
+    typedef std::function<Vec3(int64_t t_us)> source_fn;
+
+    struct Config {
+        uint8_t address;
+        source_fn source;
+        float mount_roll_deg;        // Sensor rotation relative to the frame (about Y)
+        float mount_pitch_deg;       // About X
+        float mount_yaw_deg;
+        float noise_ug_per_rt_hz;    // Output noise density
+        Vec3 bias_g;                 // Zero-g offset (what calibration removes)
+        uint32_t seed;
+    };
+
+    explicit Adxl345Sim(const Config& config);
+
+    uint8_t getAddress() const { return config.address; }
+
+    // Produce every sample due up to t_us
+    void advance(int64_t t_us);
+
+    // Register transfers (return false = NACK)
+    bool write(const uint8_t* data, size_t len);
+    bool writeRead(const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen);
+
+    // Samples dropped because the FIFO was full
+    uint32_t getOverflowCount() const { return overflows; }
+    uint32_t getSampleCount() const { return samples; }
+
+private:
+    struct Sample {
+        int16_t x, y, z;
+    };
+
+    Config config;
+    float mount[3][3];             // Frame -> sensor rotation
+    std::mt19937 rng;
+    std::normal_distribution<float> noise;
+
+    uint8_t regs[0x40];
+    Sample fifo[adxl345::FIFO_DEPTH];
+    int fifo_head;
+    int fifo_count;
+    Sample latest;
+    int64_t next_sample_us;
+    int64_t last_time_us;
+    uint32_t overflows;
+    uint32_t samples;
+
+    // Activity / inactivity detection state
+    Sample act_reference;
+    bool act_reference_valid;
+    int64_t inactive_since_us;
+
+    bool measuring() const { return regs[adxl345::REG_POWER_CTL] & adxl345::POWER_MEASURE; }
+    int64_t samplePeriodUs() const;
+    Sample measure(int64_t t_us);
+    void pushSample(const Sample& sample, int64_t t_us);
+    void updateMotion(const Sample& sample, int64_t t_us);
+    uint8_t readRegister(uint8_t reg);
+};
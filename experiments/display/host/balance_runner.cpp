@@ -0,0 +1,252 @@
+// Runs planned moves through MotorSupervisor on the four CyberGear models,
+// as motor_task does (planner on the supervisor's clock, positions tracked
+// from feedback), with one corner overloaded or jammed part way, and checks
+// detection time, how far the frame racks and whether the move completes.
+#include <cmath>
+#include <cstdio>
+#include "config.hpp"
+#include "motor_controller.hpp"
+#include "motor_homing.hpp"
+#include "motor_supervisor.hpp"
+#include "pins.hpp"
+#include "trajectory_planner.hpp"
+#include "virtual_can_bus.hpp"
+
+static constexpr int64_t STEP_US = 1000;
+static constexpr float TARGET_RAD = 30.0f;
+static const uint8_t MOTOR_IDS[MOTOR_COUNT] = MOTOR_CAN_IDS;
+static const int8_t DIRECTIONS[MOTOR_COUNT] = MOTOR_DIRECTIONS;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+struct Scenario {
+    const char* name;
+    int motor;                 // Disturbed motor
+    float load_nm;             // Opposing load on it for the whole move
+    int64_t jam_from_us;       // Shaft blocked from..to (-1: never)
+    int64_t jam_to_us;
+};
+
+struct Result {
+    bool aborted;
+    int64_t end_us;            // Move done or aborted
+    int64_t detect_us;         // Jam -> event (-1: none)
+    float final_position[MOTOR_COUNT];
+    MotorSupervisor::Stats stats;
+};
+
+static Result run(const Scenario& scenario) {
+    VirtualCanBus can({
+        .bitrate = CAN_BITRATE,
+        .tx_queue_len = CAN_TX_QUEUE_LEN,
+        .rx_queue_len = CAN_RX_QUEUE_LEN,
+        .response_latency_us = 200,
+        .error_rate = 0.0f,
+        .seed = 1,
+    });
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        can.addMotor(CyberGearModel::defaults(MOTOR_IDS[i]));
+    }
+    CyberGearModel* disturbed = can.getMotor(MOTOR_IDS[scenario.motor]);
+    disturbed->setLoadTorque(scenario.load_nm * DIRECTIONS[scenario.motor]);
+
+    MotorController motors({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&can](const CanFrame* frames, int count) { return can.transmit(frames, count); },
+    });
+    MotorHoming tracker({
+        .motor_count = MOTOR_COUNT,
+        .speed_rad_s = -MOTOR_HOMING_RAD_S,
+        .stall_speed_rad_s = MOTOR_HOMING_STALL_RAD_S,
+        .stall_torque_nm = MOTOR_HOMING_STALL_NM,
+        .stall_samples = MOTOR_HOMING_STALL_SAMPLES,
+        .spinup_us = MOTOR_HOMING_SPINUP_MS * 1000LL,
+        .max_feedback_age_us = MOTOR_FEEDBACK_MAX_AGE_MS * 1000LL,
+        .timeout_us = MOTOR_HOMING_TIMEOUT_MS * 1000LL,
+        .home_position_rad = 0.0f,
+    });
+    MotorSupervisor supervisor({
+        .motor_count = MOTOR_COUNT,
+        .overload_torque_nm = MOTOR_OVERLOAD_NM,
+        .stall_speed_ratio = MOTOR_STALL_SPEED_RATIO,
+        .min_command_rad_s = MOTOR_STALL_MIN_RAD_S,
+        .detect_samples = MOTOR_STALL_SAMPLES,
+        .lag_deadband_rad = MOTOR_LAG_DEADBAND_RAD,
+        .lag_gain = MOTOR_LAG_SLOWDOWN_PER_RAD,
+        .catch_up_gain = MOTOR_CATCH_UP_GAIN,
+        .max_catch_up_rad_s = MOTOR_CATCH_UP_RAD_S,
+        .min_scale = MOTOR_BALANCE_MIN_SCALE,
+        .scale_rate = MOTOR_BALANCE_RATE,
+        .stall_timeout_us = MOTOR_STALL_TIMEOUT_MS * 1000LL,
+    });
+    TrajectoryPlanner::Config planner_config = {};
+    planner_config.axis_count = MOTOR_COUNT;
+    float targets[MOTOR_COUNT];
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        planner_config.max_velocity[i] = MOTOR_SPEED_RAD_S;
+        planner_config.max_acceleration[i] = MOTOR_ACCEL_RAD_S2;
+        targets[i] = TARGET_RAD;
+    }
+    TrajectoryPlanner planner(planner_config);
+    float zero[MOTOR_COUNT] = {};
+    planner.reset(zero);
+    planner.plan(0, targets);
+
+    MotorState states[MOTOR_COUNT] = {};
+    bool valid[MOTOR_COUNT] = {};
+    Result result = {};
+    result.detect_us = -1;
+    int64_t plan_clock = 0;
+    int64_t last_cycle = 0;
+    bool moving = true;
+    int64_t now = 0;
+    int64_t settle_until = -1;
+
+    while (settle_until < 0 || now < settle_until) {
+        now += STEP_US;
+        if (scenario.jam_from_us >= 0) {
+            disturbed->setBlocked(now >= scenario.jam_from_us && now < scenario.jam_to_us);
+        }
+        can.advance(now);
+        CanFrame frame;
+        while (can.receive(&frame)) {
+            int motor;
+            MotorState state;
+            if (motors.decode(frame, now, &motor, &state)) {
+                states[motor] = state;
+                valid[motor] = true;
+            }
+        }
+        if (now % (MOTOR_CYCLE_MS * 1000) != 0) {
+            continue;
+        }
+
+        // motor_task's cycle
+        plan_clock += (int64_t)((now - last_cycle) * supervisor.getScale());
+        last_cycle = now;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (valid[i]) {
+                tracker.track(i, states[i]);
+            }
+        }
+        TrajectoryPlanner::Setpoint setpoint;
+        planner.sample(plan_clock, &setpoint);
+        if (!moving || setpoint.done) {
+            supervisor.idle(now);
+            motors.stopAll();
+        } else {
+            const MotorSupervisor::Output& out =
+                supervisor.update(now, setpoint.position, setpoint.velocity, tracker.getPositions(), states, valid);
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                motors.setVelocity(i, out.motor_rad_s[i]);
+            }
+            if (out.abort) {
+                result.aborted = true;
+                planner.reset(tracker.getPositions());
+            }
+            if (result.detect_us < 0 && scenario.jam_from_us >= 0 && supervisor.getConditions(scenario.motor)) {
+                result.detect_us = now - scenario.jam_from_us;
+            }
+        }
+        motors.cycle();
+        if (moving && (setpoint.done || result.aborted)) {
+            moving = false;
+            result.end_us = now;
+            result.stats = supervisor.takeStats();
+            settle_until = now + 500000;
+        }
+        if (now > 120000000) {
+            break;
+        }
+    }
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        result.final_position[i] = can.getMotor(MOTOR_IDS[i])->getPosition() * DIRECTIONS[i];
+    }
+    return result;
+}
+
+static float spread(const float* positions) {
+    float low = INFINITY, high = -INFINITY;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        low = fminf(low, positions[i]);
+        high = fmaxf(high, positions[i]);
+    }
+    return high - low;
+}
+
+static void report(const Scenario& scenario, const Result& result) {
+    const MotorSupervisor::Stats& stats = result.stats;
+    printf("%s\n", scenario.name);
+    printf("  %s after %.2f s; %lu events, %lu avoided, balancing %.2f s, %.2f s lost, worst spread %.2f rad\n",
+           result.aborted ? "aborted" : "done", result.end_us * 1e-6f, (unsigned long)stats.events,
+           (unsigned long)stats.stalls_avoided, stats.balancing_us * 1e-6f, stats.time_lost_us * 1e-6f,
+           stats.max_lag_spread_rad);
+    printf("  final %.2f %.2f %.2f %.2f rad, peak torque %.2f Nm", result.final_position[0],
+           result.final_position[1], result.final_position[2], result.final_position[3],
+           stats.peak_torque_nm[scenario.motor]);
+    if (result.detect_us >= 0) {
+        printf(", jam detected after %.0f ms", result.detect_us / 1000.0);
+    }
+    printf("\n");
+}
+
+int main() {
+    // A plain move takes TARGET / speed plus one ramp
+    const float nominal_s = TARGET_RAD / MOTOR_SPEED_RAD_S + MOTOR_SPEED_RAD_S / MOTOR_ACCEL_RAD_S2;
+    const int64_t detect_limit_us = (MOTOR_STALL_SAMPLES + 2) * MOTOR_CYCLE_MS * 1000LL;
+
+    Scenario even = {"even load", 1, 0.3f, -1, -1};
+    Result result = run(even);
+    report(even, result);
+    check(!result.aborted && result.stats.events == 0, "no events");
+    check(result.stats.time_lost_us == 0, "no time lost");
+    check(fabsf(result.end_us * 1e-6f - nominal_s) < 0.1f, "move takes its planned time");
+    check(spread(result.final_position) < 0.1f, "frame level at the end");
+
+    Scenario heavy = {"heavy corner (2.8 Nm on motor 2)", 1, 2.8f, -1, -1};
+    result = run(heavy);
+    report(heavy, result);
+    check(result.stats.events >= 1, "overload detected");
+    check(!result.aborted, "move completes, no abort");
+    check(result.stats.stalls_avoided == 0, "never slowed: no stall avoided counted");
+    check(result.stats.max_lag_spread_rad < MOTOR_LAG_DEADBAND_RAD + 0.2f, "frame stays level while moving");
+
+    Scenario jam = {"motor 3 jammed for 1 s", 2, 0.3f, 2000000, 3000000};
+    result = run(jam);
+    report(jam, result);
+    check(result.detect_us >= 0 && result.detect_us <= detect_limit_us, "jam detected within a few cycles");
+    check(!result.aborted, "move completes, no abort");
+    check(result.stats.stalls_avoided >= 1, "stall avoided");
+    check(result.stats.max_lag_spread_rad < 1.0f, "leaders wait (spread under 1 rad)");
+    check(result.stats.time_lost_us > 500000, "time lost reported");
+    float worst_end = 0;
+    for (float position : result.final_position) {
+        worst_end = fmaxf(worst_end, fabsf(position - TARGET_RAD));
+    }
+    check(worst_end < MOTOR_LAG_DEADBAND_RAD + 0.1f, "every motor reaches the target");
+
+    Scenario stuck = {"motor 4 jammed for good", 3, 0.3f, 2000000, INT64_MAX};
+    result = run(stuck);
+    report(stuck, result);
+    check(result.aborted, "move aborted");
+    check(result.end_us - stuck.jam_from_us <= MOTOR_STALL_TIMEOUT_MS * 1000LL + 2 * detect_limit_us,
+          "after the stall timeout");
+    check(spread(result.final_position) < 1.5f, "frame racked under 1.5 rad at the stop");
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Runs a LEVEL calibration the way the accelerometer task does (drain every
+// ACCEL_TASK_PERIOD_MS, ACCEL_CALIBRATION_SAMPLES per sensor) on simulated
+// ADXL345s with a known mounting tilt and zero-g bias, and checks the
+// OFSX/OFSY/OFSZ values AccelCalibrator computes against the ones that
+// mounting predicts, that the sensor then reads level, and that a repeat
+// calibration over the written offsets lands on the same registers.
+#include <cmath>
+#include <cstdio>
+#include "accel_calibration.hpp"
+#include "accel_sensor.hpp"
+#include "adxl345_sim.hpp"
+#include "config.hpp"
+#include "sim_i2c_bus.hpp"
+
+static constexpr int64_t SAMPLE_US = 10000;   // 100 Hz
+static constexpr double RAD_PER_DEG = M_PI / 180.0;
+
+struct Mounting {
+    const char* name;
+    float roll_deg;
+    float pitch_deg;
+    float yaw_deg;
+    Vec3 bias_g;
+};
+
+static const Mounting MOUNTINGS[] = {
+    {"front: 3 deg roll, -2 deg pitch", 3.0f, -2.0f, 0.0f, {0.040f, -0.030f, 0.050f}},
+    {"rear: -4 deg roll, 2.5 deg pitch, yawed", -4.0f, 2.5f, 3.0f, {-0.050f, 0.020f, -0.060f}},
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// Offset registers that bring the mounted, biased sensor to (0, 0, 1 g) on a
+// level frame: gravity in the sensor's axes after a Z-Y-X mounting rotation
+static AccelOffsets expected_offsets(const Mounting& mounting) {
+    double roll = mounting.roll_deg * RAD_PER_DEG, pitch = mounting.pitch_deg * RAD_PER_DEG;
+    double g[3] = {-sin(roll), cos(roll) * sin(pitch), cos(roll) * cos(pitch)};
+    double bias[3] = {mounting.bias_g.x, mounting.bias_g.y, mounting.bias_g.z};
+    double level[3] = {0, 0, 1};
+    int8_t ofs[3];
+    for (int i = 0; i < 3; i++) {
+        double error_lsb = (level[i] - g[i] - bias[i]) * adxl345::LSB_PER_G;
+        ofs[i] = (int8_t)lround(error_lsb / adxl345::OFS_TO_RAW);
+    }
+    return {ofs[0], ofs[1], ofs[2]};
+}
+
+struct Rig {
+    Adxl345Sim sim;
+    SimI2cBus bus;
+    AccelSensor sensor;
+    int64_t now = 0;
+
+    explicit Rig(const Mounting& mounting)
+        : sim({
+              .address = 0x53,
+              .source = [](int64_t) { return Vec3{0.0f, 0.0f, 1.0f}; },
+              .mount_roll_deg = mounting.roll_deg,
+              .mount_pitch_deg = mounting.pitch_deg,
+              .mount_yaw_deg = mounting.yaw_deg,
+              .noise_ug_per_rt_hz = 290.0f,
+              .bias_g = mounting.bias_g,
+              .seed = 3,
+          }),
+          sensor({
+              .device_address = 0x53,
+              .write = [this](uint8_t addr, const uint8_t* data, size_t len) { return bus.write(addr, data, len); },
+              .write_read = [this](uint8_t addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+                  return bus.write_read(addr, wdata, wlen, rdata, rlen);
+              },
+              .wait = [this]() { return bus.wait(); },
+          }) {
+        bus.addDevice(&sim);
+    }
+
+    // Drain at the task period until the calibrator has its samples
+    void capture(AccelCalibrator* calibrator) {
+        AccelBlock block;
+        while (calibrator->getSampleCount() < ACCEL_CALIBRATION_SAMPLES) {
+            now += SAMPLE_US;
+            sim.advance(now);
+            if (now % (ACCEL_TASK_PERIOD_MS * 1000) == 0 && sensor.drain(&block, now)) {
+                calibrator->addBlock(block);
+            }
+        }
+    }
+
+    // Mean of n samples, raw LSB
+    Vec3 mean(int n) {
+        AccelBlock block;
+        double sum[3] = {};
+        int count = 0;
+        while (count < n) {
+            now += SAMPLE_US;
+            sim.advance(now);
+            if (now % (ACCEL_TASK_PERIOD_MS * 1000) == 0 && sensor.drain(&block, now)) {
+                for (int i = 0; i < block.count; i++) {
+                    sum[0] += block.x[i];
+                    sum[1] += block.y[i];
+                    sum[2] += block.z[i];
+                }
+                count += block.count;
+            }
+        }
+        return {(float)(sum[0] / count), (float)(sum[1] / count), (float)(sum[2] / count)};
+    }
+};
+
+static void run(const Mounting& mounting) {
+    printf("%s\n", mounting.name);
+    Rig rig(mounting);
+    check(rig.sensor.init(adxl345::RATE_100_HZ, ACCEL_FIFO_WATERMARK, {}), "sensor up, offsets cleared");
+
+    AccelCalibrator calibrator;
+    calibrator.reset(rig.sensor.getOffsets());
+    calibrator.beginOrientation(AccelCalibrator::LEVEL);
+    rig.capture(&calibrator);
+    AccelOffsets offsets = {};
+    bool computed = calibrator.compute(&offsets);
+
+    AccelOffsets expected = expected_offsets(mounting);
+    printf("  OFS (%d, %d, %d), expected (%d, %d, %d)\n", offsets.x, offsets.y, offsets.z, expected.x, expected.y,
+           expected.z);
+    check(computed && offsets.x == expected.x && offsets.y == expected.y && offsets.z == expected.z,
+          "OFSX/OFSY/OFSZ match the mounting");
+
+    // Written like apply_accel_calibration, then the level frame reads level
+    rig.sensor.setOffsets(offsets);
+    rig.bus.wait();
+    Vec3 level = rig.mean(ACCEL_CALIBRATION_SAMPLES);
+    printf("  reads (%.2f, %.2f, %.2f) LSB\n", level.x, level.y, level.z);
+    float half_step = adxl345::OFS_TO_RAW / 2.0f + 0.5f;
+    check(fabsf(level.x) <= half_step && fabsf(level.y) <= half_step &&
+              fabsf(level.z - adxl345::LSB_PER_G) <= half_step,
+          "level within half an OFS step");
+
+    // Calibrating again over the written offsets keeps them
+    calibrator.reset(rig.sensor.getOffsets());
+    calibrator.beginOrientation(AccelCalibrator::LEVEL);
+    rig.capture(&calibrator);
+    AccelOffsets again = {};
+    calibrator.compute(&again);
+    check(again.x == offsets.x && again.y == offsets.y && again.z == offsets.z, "recalibration is stable");
+}
+
+int main() {
+    for (const Mounting& mounting : MOUNTINGS) {
+        run(mounting);
+    }
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
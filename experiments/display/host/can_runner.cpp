@@ -0,0 +1,421 @@
+// Exercises VirtualCanBus and CyberGearModel: position_test's command
+// sequence and polling loop, wire timing and arbitration, error injection
+// into bus off, an over-temperature fault, CanTelemetry against the bus's
+// own accounting, and a ten-minute MotorController duty cycle timed against
+// the wall clock.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "can_telemetry.hpp"
+#include "config.hpp"
+#include "motor_controller.hpp"
+#include "pins.hpp"
+#include "virtual_can_bus.hpp"
+
+using cybergear::CommType;
+
+static constexpr uint8_t MASTER = 0;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static VirtualCanBus::Config bus_config(int64_t latency_us, float error_rate) {
+    return {
+        .bitrate = 1000000,
+        .tx_queue_len = CAN_TX_QUEUE_LEN,
+        .rx_queue_len = CAN_RX_QUEUE_LEN,
+        .response_latency_us = latency_us,
+        .error_rate = error_rate,
+        .seed = 7,
+    };
+}
+
+// An 8-byte extended frame, for wire time
+static CanFrame frame_for_rtt() {
+    CanFrame frame;
+    cybergear::encode_enable(&frame, MASTER, 1);
+    return frame;
+}
+
+static void position_test() {
+    printf("position_test sequence: POSITION mode to 10 rad at 3 rad/s\n");
+    VirtualCanBus bus(bus_config(200, 0.0f));
+    bus.addMotor(CyberGearModel::defaults(0x7F));
+
+    CanFrame setup[6];
+    cybergear::encode_stop(&setup[0], MASTER, 0x7F, false);
+    cybergear::encode_write_u8(&setup[1], MASTER, 0x7F, cybergear::PARAM_RUN_MODE,
+                               (uint8_t)cybergear::RunMode::POSITION);
+    cybergear::encode_write_float(&setup[2], MASTER, 0x7F, cybergear::PARAM_LIMIT_SPD, 3.0f);
+    cybergear::encode_write_float(&setup[3], MASTER, 0x7F, cybergear::PARAM_LIMIT_CUR, 5.0f);
+    cybergear::encode_enable(&setup[4], MASTER, 0x7F);
+    cybergear::encode_write_float(&setup[5], MASTER, 0x7F, cybergear::PARAM_LOC_REF, 10.0f);
+    check(bus.transmit(setup, 6) == 6, "setup frames queued");
+
+    // Poll as position_test does: request status, read alerts, drain
+    uint32_t polls = 0, replies = 0, seen_alerts = 0;
+    float peak_speed = 0;
+    cybergear::Feedback last = {};
+    for (int64_t now = 0; now < 6000000; now += 10000) {
+        CanFrame request;
+        cybergear::encode_request_status(&request, MASTER, 0x7F);
+        polls += bus.transmit(&request, 1);
+        bus.advance(now + 10000);
+        seen_alerts |= bus.takeAlerts();
+        CanFrame frame;
+        while (bus.receive(&frame)) {
+            if (cybergear::decode_feedback(frame, &last)) {
+                replies++;
+                peak_speed = fmaxf(peak_speed, fabsf(last.velocity));
+            }
+        }
+    }
+    CanFrame read;
+    cybergear::encode_read_param(&read, MASTER, 0x7F, cybergear::PARAM_LIMIT_SPD);
+    bus.transmit(&read, 1);
+    bus.advance(bus.getTime() + 2000);
+    CanFrame answer = {};
+    float limit = 0;
+    if (bus.receive(&answer) && cybergear::comm_type(answer) == CommType::READ_PARAM) {
+        memcpy(&limit, &answer.data[4], sizeof(limit));
+    }
+
+    printf("  %u polls, %u status replies, position %.3f rad, peak %.2f rad/s, %.1f C\n", polls, replies,
+           last.position, peak_speed, last.temperature);
+    check(replies == polls + 6, "every command and poll answered");
+    check(last.state == cybergear::MotorState::RUNNING && fabsf(last.position - 10.0f) < 0.01f,
+          "motor holds 10 rad");
+    check(peak_speed < 3.0f + 0.05f && peak_speed > 2.9f, "speed capped at LIMIT_SPD");
+    check((seen_alerts & (VirtualCanBus::ALERT_RX_DATA | VirtualCanBus::ALERT_TX_SUCCESS |
+                          VirtualCanBus::ALERT_TX_IDLE)) == (VirtualCanBus::ALERT_RX_DATA |
+                                                             VirtualCanBus::ALERT_TX_SUCCESS |
+                                                             VirtualCanBus::ALERT_TX_IDLE),
+          "RX_DATA, TX_SUCCESS and TX_IDLE raised");
+    check(limit == 3.0f, "LIMIT_SPD reads back");
+}
+
+static void timing_and_arbitration() {
+    printf("Wire timing and arbitration, 300 us motor latency\n");
+    VirtualCanBus bus(bus_config(300, 0.0f));
+    for (uint8_t id = 1; id <= 4; id++) {
+        bus.addMotor(CyberGearModel::defaults(id));
+    }
+
+    // One command: 8-byte extended frame there, latency, frame back
+    CanFrame command;
+    cybergear::encode_enable(&command, MASTER, 1);
+    int64_t frame_us = bus.frameTimeUs(command);
+    int64_t due = 2 * frame_us + 300;
+    bus.transmit(&command, 1);
+    CanFrame reply;
+    bus.advance(due - 1);
+    bool early = bus.receive(&reply);
+    bus.advance(due);
+    bool on_time = bus.receive(&reply);
+    printf("  %lld us per frame, reply after %lld us\n", (long long)frame_us, (long long)due);
+    check(!early && on_time, "reply arrives after both frames and the latency");
+
+    // Commands to 4..1 then a long tail: replies (type 2) beat queued
+    // WRITE_PARAMs (type 18) and come back as they were produced
+    VirtualCanBus busy(bus_config(0, 0.0f));
+    for (uint8_t id = 1; id <= 4; id++) {
+        busy.addMotor(CyberGearModel::defaults(id));
+    }
+    CanFrame burst[16];
+    for (int i = 0; i < 16; i++) {
+        cybergear::encode_write_float(&burst[i], MASTER, 4 - i % 4, cybergear::PARAM_SPD_REF, 0.0f);
+    }
+    busy.transmit(burst, 16);
+    busy.advance(10000);
+    uint8_t order[16];
+    int received = 0;
+    while (received < 16 && busy.receive(&reply)) {
+        order[received++] = (reply.id >> 8) & 0xFF;
+    }
+    bool in_order = received == 16;
+    for (int i = 0; in_order && i < 16; i++) {
+        in_order = order[i] == 4 - i % 4;
+    }
+    VirtualCanBus::Status status = busy.getStatus();
+    printf("  %u arbitrations lost by the host\n", status.arb_lost_count);
+    check(in_order, "every command answered, in order");
+    check(status.arb_lost_count >= 15, "replies win arbitration over queued commands");
+}
+
+static void error_injection() {
+    printf("Error injection\n");
+    VirtualCanBus bus(bus_config(200, 0.05f));
+    bus.addMotor(CyberGearModel::defaults(1));
+    CanFrame command;
+    cybergear::encode_write_float(&command, MASTER, 1, cybergear::PARAM_SPD_REF, 0.0f);
+    uint32_t replies = 0;
+    for (int i = 0; i < 1000; i++) {
+        bus.transmit(&command, 1);
+        bus.advance((i + 1) * 1000LL);
+        CanFrame reply;
+        while (bus.receive(&reply)) {
+            replies++;
+        }
+    }
+    VirtualCanBus::Status status = bus.getStatus();
+    printf("  5%% corruption: %u bus errors, %u replies, TEC %u\n", status.bus_error_count, replies,
+           status.tx_error_counter);
+    check(status.bus_error_count > 50 && replies >= 999, "errors retransmitted, nothing lost");
+    check(status.state == VirtualCanBus::State::RUNNING, "still error active");
+
+    bus.setErrorRate(1.0f);
+    bus.transmit(&command, 1);
+    bus.advance(bus.getTime() + 20000);
+    uint32_t alerts = bus.takeAlerts();
+    status = bus.getStatus();
+    check((alerts & VirtualCanBus::ALERT_ERR_PASS) && (alerts & VirtualCanBus::ALERT_BUS_OFF) &&
+              status.state == VirtualCanBus::State::BUS_OFF,
+          "a dead wire goes error passive, then bus off");
+    check(bus.transmit(&command, 1) == 0 && status.tx_failed_count == 1, "bus off refuses and fails frames");
+
+    bus.setErrorRate(0.0f);
+    bus.recover();
+    bus.transmit(&command, 1);
+    bus.advance(bus.getTime() + 2000);
+    CanFrame reply;
+    check(bus.receive(&reply), "traffic resumes after recovery");
+}
+
+static void over_temperature() {
+    printf("Blocked motor at full current\n");
+    VirtualCanBus bus(bus_config(200, 0.0f));
+    CyberGearModel* motor = bus.addMotor(CyberGearModel::defaults(1));
+    motor->setBlocked(true);
+    CanFrame start[4];
+    cybergear::encode_write_u8(&start[0], MASTER, 1, cybergear::PARAM_RUN_MODE, (uint8_t)cybergear::RunMode::SPEED);
+    cybergear::encode_write_float(&start[1], MASTER, 1, cybergear::PARAM_LIMIT_CUR, 23.0f);
+    cybergear::encode_enable(&start[2], MASTER, 1);
+    cybergear::encode_write_float(&start[3], MASTER, 1, cybergear::PARAM_SPD_REF, 5.0f);
+    bus.transmit(start, 4);
+
+    bool fault_frame = false;
+    int64_t tripped_us = 0;
+    float stall_torque = 0;
+    cybergear::Feedback feedback = {};
+    for (int64_t now = 100000; now <= 120000000 && !fault_frame; now += 100000) {
+        bus.advance(now);
+        stall_torque = fmaxf(stall_torque, motor->getTorque());
+        CanFrame frame;
+        while (bus.receive(&frame)) {
+            if (cybergear::comm_type(frame) == CommType::FAULT) {
+                fault_frame = true;
+                tripped_us = now;
+            }
+        }
+    }
+    printf("  stall torque %.1f Nm, tripped after %.1f s\n", stall_torque, tripped_us * 1e-6f);
+    check(fault_frame && (motor->getFaults() & cybergear::FAULT_OVER_TEMPERATURE), "over-temperature latched");
+
+    CanFrame enable;
+    cybergear::encode_enable(&enable, MASTER, 1);
+    bus.transmit(&enable, 1);
+    bus.advance(bus.getTime() + 2000);
+    CanFrame frame;
+    bool answered = bus.receive(&frame) && cybergear::decode_feedback(frame, &feedback);
+    check(answered && !motor->isEnabled() && (feedback.faults & cybergear::FAULT_OVER_TEMPERATURE),
+          "ENABLE refused while the fault is latched");
+
+    CanFrame clear[2];
+    cybergear::encode_stop(&clear[0], MASTER, 1, true);
+    cybergear::encode_enable(&clear[1], MASTER, 1);
+    bus.transmit(clear, 2);
+    bus.advance(bus.getTime() + 2000);
+    check(motor->isEnabled() && motor->getFaults() == 0, "fault-clearing STOP re-arms the motor");
+}
+
+static void telemetry() {
+    printf("Telemetry: 5 s streaming, motor 4 unplugged, 1%% frame corruption\n");
+    VirtualCanBus bus(bus_config(300, 0.01f));
+    static const uint8_t ids[MOTOR_COUNT] = MOTOR_CAN_IDS;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        bus.addMotor(CyberGearModel::defaults(ids[i]));
+    }
+    bus.getMotor(ids[3])->setOffline(true);
+    CanTelemetry telemetry({
+        .bitrate = 1000000,
+        .id_mask = CAN_TELEMETRY_ID_MASK,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .reply_timeout_us = CAN_REPLY_TIMEOUT_MS * 1000,
+    });
+    MotorController controller({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&](const CanFrame* frames, int count) {
+            // As can_transmit() in main.cpp
+            int sent = bus.transmit(frames, count);
+            telemetry.onTransmit(frames, sent, bus.getTime());
+            CanBusStatus status;
+            if (bus.readStatus(&status)) {
+                telemetry.onStatus(status);
+            }
+            return sent;
+        },
+    });
+
+    // Receive every millisecond, as the alert-driven dispatcher would
+    const int64_t window_us = 1000000;
+    CanTelemetry::Report report = {};
+    int64_t busy_start = 0;
+    float busy_pct = 0;
+    uint32_t errors_start = 0, errors = 0;
+    for (int64_t now = 1000; now <= 5000000; now += 1000) {
+        bus.advance(now);
+        CanFrame frame;
+        while (bus.receive(&frame)) {
+            telemetry.onReceive(frame, now);
+        }
+        if (now % (MOTOR_CYCLE_MS * 1000) == 0) {
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                controller.setVelocity(i, MOTOR_SPEED_RAD_S);
+            }
+            controller.cycle();
+            if (telemetry.roll(now, window_us)) {
+                busy_pct = 100.0f * (bus.getBusyUs() - busy_start) / window_us;
+                busy_start = bus.getBusyUs();
+                errors = bus.getStatus().bus_error_count - errors_start;
+                errors_start = bus.getStatus().bus_error_count;
+            }
+        }
+    }
+    check(telemetry.read(&report), "report published");
+    printf("  load %.2f%% (bus busy %.2f%%), %.0f tx/s, %.0f rx/s, high-water %u, %u bus errors\n",
+           report.load_pct, busy_pct, report.tx_per_second, report.rx_per_second, report.tx_queue_high_water,
+           report.bus_errors);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const CanTelemetry::RoundTrip& trip = report.round_trip[i];
+        printf("  motor %d: %u replies, %u lost, %u/%u/%u us\n", i + 1, trip.samples, trip.lost, trip.min_us,
+               trip.avg_us, trip.max_us);
+    }
+    int tx_ids = 0, rx_ids = 0;
+    bool rates_ok = true;
+    for (int i = 0; i < report.id_count; i++) {
+        tx_ids += !report.ids[i].received;
+        rx_ids += report.ids[i].received;
+        rates_ok = rates_ok && fabsf(report.ids[i].per_second - 1000.0f / MOTOR_CYCLE_MS) < 2.0f;
+    }
+    // Error frames occupy the wire without being counted as frames
+    check(fabsf(report.load_pct - busy_pct) < 0.2f, "load matches the wire's busy time");
+    check(tx_ids == 4 && rx_ids == 3 && rates_ok, "one rate per command and status identifier");
+    check(report.tx_queue_high_water == MOTOR_COUNT, "TX high-water is one batch");
+    int64_t floor_us = 2 * bus.frameTimeUs(frame_for_rtt()) + 300;
+    bool rtt_ok = true;
+    for (int i = 0; i < 3; i++) {
+        const CanTelemetry::RoundTrip& trip = report.round_trip[i];
+        rtt_ok = rtt_ok && trip.samples >= 49 && trip.lost == 0 && trip.min_us >= floor_us &&
+                 trip.max_us <= floor_us + 1000 + 600;
+    }
+    check(rtt_ok, "round trips of wire time, latency and polling");
+    check(report.round_trip[3].samples == 0 && report.round_trip[3].lost >= 49, "unplugged motor's commands lost");
+    check(report.bus_errors == errors && errors > 0, "bus errors over the window");
+
+    // Cost per frame on both sides
+    CanFrame batch[4];
+    for (int i = 0; i < 4; i++) {
+        cybergear::encode_write_float(&batch[i], MASTER, ids[i], cybergear::PARAM_SPD_REF, 1.0f);
+    }
+    cybergear::Feedback reply = {};
+    CanFrame replies[4];
+    for (int i = 0; i < 4; i++) {
+        reply.motor_id = ids[i];
+        cybergear::encode_feedback(&replies[i], MASTER, reply);
+    }
+    const int rounds = 200000;
+    auto begin = std::chrono::steady_clock::now();
+    for (int n = 0; n < rounds; n++) {
+        telemetry.onTransmit(batch, 4, n * 20);
+        for (int i = 0; i < 4; i++) {
+            telemetry.onReceive(replies[i], n * 20 + 10);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() /
+                (rounds * 8.0);
+    printf("  %.0f ns per frame recorded\n", ns);
+    check(ns < 200, "recording costs under 200 ns per frame");
+}
+
+static void long_run() {
+    printf("Ten minutes of Up/Down moves, 0.1%% frame corruption\n");
+    VirtualCanBus bus(bus_config(200, 0.001f));
+    static const uint8_t ids[MOTOR_COUNT] = MOTOR_CAN_IDS;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        bus.addMotor(CyberGearModel::defaults(ids[i]));
+    }
+    MotorController controller({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&bus](const CanFrame* frames, int count) { return bus.transmit(frames, count); },
+    });
+
+    const int64_t duration_us = 600LL * 1000000;
+    uint32_t feedback = 0;
+    auto begin = std::chrono::steady_clock::now();
+    CanFrame frame;
+    int motor;
+    MotorState state;
+    for (int64_t now = MOTOR_CYCLE_MS * 1000; now < duration_us; now += MOTOR_CYCLE_MS * 1000) {
+        bus.advance(now);
+        while (bus.receive(&frame)) {
+            feedback += controller.decode(frame, now, &motor, &state);
+        }
+        // 10 s up, 5 s rest, 10 s down, 5 s rest
+        int64_t phase = now % 30000000;
+        float speed = 0;
+        if (phase < 10000000) {
+            speed = MOTOR_SPEED_RAD_S;
+        } else if (phase >= 15000000 && phase < 25000000) {
+            speed = -MOTOR_SPEED_RAD_S;
+        }
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            controller.setVelocity(i, speed);
+        }
+        controller.cycle();
+    }
+    bus.advance(duration_us);
+    while (bus.receive(&frame)) {
+        feedback += controller.decode(frame, duration_us, &motor, &state);
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    MotorController::Stats stats = controller.takeStats();
+    VirtualCanBus::Status status = bus.getStatus();
+    double factor = duration_us * 1e-6 / wall_s;
+    printf("  %u frames sent, %u feedback, %u bus errors, bus load %.1f%%\n", stats.frames_sent, feedback,
+           status.bus_error_count, 100.0 * bus.getBusyUs() / duration_us);
+    printf("  %.0f s simulated in %.3f s wall (%.0fx real time)\n", duration_us * 1e-6, wall_s, factor);
+    float drift = 0;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        drift = fmaxf(drift, fabsf(bus.getMotor(ids[i])->getPosition()));
+    }
+    check(stats.frames_dropped == 0 && feedback == stats.frames_sent, "every frame delivered and answered");
+    check(drift < 0.5f, "motors back near where they started");
+    check(factor > 100.0, "runs over 100x faster than real time");
+}
+
+int main() {
+    position_test();
+    timing_and_arbitration();
+    error_injection();
+    over_temperature();
+    telemetry();
+    long_run();
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+#include "cybergear_model.hpp"
+#include <cmath>
+#include <cstring>
+
+using cybergear::CommType;
+using cybergear::RunMode;
+
+static float clampf(float value, float limit) {
+    return value > limit ? limit : value < -limit ? -limit : value;
+}
+
+static float u16_to_float(const uint8_t* data, float range) {
+    return ((data[0] << 8) | data[1]) * (2.0f * range) / 65535.0f - range;
+}
+
+CyberGearModel::Config CyberGearModel::defaults(uint8_t can_id) {
+    return {
+        .can_id = can_id,
+        .velocity_tau_s = 0.02f,
+        .position_gain = 20.0f,
+        .torque_constant = 0.6f,
+        .inertia = 0.002f,
+        .ambient_c = 25.0f,
+        .heating_c_per_a2_s = 0.008f,
+        .cooling_tau_s = 200.0f,
+        .over_temperature_c = 90.0f,
+    };
+}
+
+CyberGearModel::CyberGearModel(const Config& config_param)
+    : config(config_param), enabled(false), run_mode(RunMode::MOTION), master_id(0), speed_ref(0),
+      position_ref(0), current_ref(0), speed_limit(10.0f), current_limit(23.0f),
+      torque_limit(cybergear::TORQUE_MAX), motion_torque(0), motion_position(0), motion_velocity(0), motion_kp(0),
+      motion_kd(0), position(0), velocity(0), torque(0), temperature(config_param.ambient_c), load_torque(0),
+      blocked(false), travel_min(-INFINITY), travel_max(INFINITY), offline(false), faults(0), reported_faults(0),
+      commands(0), time_us(0) {}
+
+void CyberGearModel::setTravel(float min_position, float max_position) {
+    travel_min = min_position;
+    travel_max = max_position;
+}
+
+void CyberGearModel::injectFault(uint8_t fault_bits) {
+    faults |= fault_bits;
+    enabled = false;
+}
+
+float CyberGearModel::readParam(uint16_t index) const {
+    switch (index) {
+        case cybergear::PARAM_IQ_REF:
+            return current_ref;
+        case cybergear::PARAM_SPD_REF:
+            return speed_ref;
+        case cybergear::PARAM_LIMIT_TORQUE:
+            return torque_limit;
+        case cybergear::PARAM_LOC_REF:
+            return position_ref;
+        case cybergear::PARAM_LIMIT_SPD:
+            return speed_limit;
+        case cybergear::PARAM_LIMIT_CUR:
+            return current_limit;
+        default:
+            return 0.0f;
+    }
+}
+
+void CyberGearModel::writeParam(uint16_t index, const uint8_t* value) {
+    float number;
+    memcpy(&number, value, sizeof(number));
+    switch (index) {
+        case cybergear::PARAM_RUN_MODE:
+            // Mode changes only take while disabled
+            if (!enabled && value[0] <= (uint8_t)RunMode::CURRENT) {
+                run_mode = (RunMode)value[0];
+            }
+            break;
+        case cybergear::PARAM_IQ_REF:
+            current_ref = number;
+            break;
+        case cybergear::PARAM_SPD_REF:
+            speed_ref = clampf(number, cybergear::VELOCITY_MAX);
+            break;
+        case cybergear::PARAM_LIMIT_TORQUE:
+            torque_limit = fabsf(number);
+            break;
+        case cybergear::PARAM_LOC_REF:
+            position_ref = number;
+            break;
+        case cybergear::PARAM_LIMIT_SPD:
+            speed_limit = fabsf(number);
+            break;
+        case cybergear::PARAM_LIMIT_CUR:
+            current_limit = fabsf(number);
+            break;
+        default:
+            break;
+    }
+}
+
+void CyberGearModel::encodeFeedback(CanFrame* frame) const {
+    cybergear::Feedback feedback = {};
+    feedback.motor_id = config.can_id;
+    feedback.state = enabled ? cybergear::MotorState::RUNNING : cybergear::MotorState::RESET;
+    feedback.faults = faults;
+    // The position field wraps at +-4 pi
+    float span = 2.0f * cybergear::POSITION_MAX;
+    feedback.position = position - span * floorf((position + cybergear::POSITION_MAX) / span);
+    feedback.velocity = velocity;
+    feedback.torque = torque;
+    feedback.temperature = temperature;
+    cybergear::encode_feedback(frame, master_id, feedback);
+}
+
+int CyberGearModel::handle(const CanFrame& frame, CanFrame* replies) {
+    if (offline || !frame.extended || (frame.id & 0xFF) != config.can_id) {
+        return 0;
+    }
+    CommType type = cybergear::comm_type(frame);
+    uint16_t index = frame.data[0] | (frame.data[1] << 8);
+    int count = 0;
+    commands++;
+    if (type != CommType::MOTION) {
+        master_id = (frame.id >> 8) & 0xFF;  // MOTION carries torque there instead
+    }
+
+    switch (type) {
+        case CommType::ENABLE:
+            // A latched fault keeps the motor off until it is cleared
+            enabled = faults == 0;
+            break;
+        case CommType::STOP:
+            enabled = false;
+            if (frame.data[0] == 1) {
+                faults = 0;
+                reported_faults = 0;
+            }
+            break;
+        case CommType::SET_ZERO:
+            position = 0.0f;
+            break;
+        case CommType::WRITE_PARAM:
+            writeParam(index, &frame.data[4]);
+            break;
+        case CommType::MOTION: {
+            uint8_t torque_bytes[2] = {(uint8_t)(frame.id >> 16), (uint8_t)(frame.id >> 8)};
+            motion_torque = u16_to_float(torque_bytes, cybergear::TORQUE_MAX);
+            motion_position = u16_to_float(&frame.data[0], cybergear::POSITION_MAX);
+            motion_velocity = u16_to_float(&frame.data[2], cybergear::VELOCITY_MAX);
+            motion_kp = ((frame.data[4] << 8) | frame.data[5]) * cybergear::KP_MAX / 65535.0f;
+            motion_kd = ((frame.data[6] << 8) | frame.data[7]) * cybergear::KD_MAX / 65535.0f;
+            break;
+        }
+        case CommType::READ_PARAM: {
+            // Reply: index echoed in data[0..1], value in data[4..7]
+            CanFrame& reply = replies[count++];
+            reply.id = cybergear::make_id(CommType::READ_PARAM, config.can_id, master_id);
+            reply.extended = true;
+            reply.len = 8;
+            memset(reply.data, 0, sizeof(reply.data));
+            reply.data[0] = frame.data[0];
+            reply.data[1] = frame.data[1];
+            if (index == cybergear::PARAM_RUN_MODE) {
+                reply.data[4] = (uint8_t)run_mode;
+            } else {
+                float value = readParam(index);
+                memcpy(&reply.data[4], &value, sizeof(value));
+            }
+            return count;
+        }
+        default:
+            break;
+    }
+
+    encodeFeedback(&replies[count++]);
+    return count;
+}
+
+void CyberGearModel::step(float dt) {
+    float max_torque = fminf(current_limit * config.torque_constant, torque_limit);
+    float drive = 0.0f;
+
+    if (enabled) {
+        float target;
+        switch (run_mode) {
+            case RunMode::SPEED:
+                drive = config.inertia * (speed_ref - velocity) / config.velocity_tau_s + load_torque;
+                break;
+            case RunMode::POSITION:
+                target = clampf(config.position_gain * (position_ref - position), speed_limit);
+                drive = config.inertia * (target - velocity) / config.velocity_tau_s + load_torque;
+                break;
+            case RunMode::CURRENT:
+                drive = current_ref * config.torque_constant;
+                break;
+            case RunMode::MOTION:
+                drive = motion_torque + motion_kp * (motion_position - position) +
+                        motion_kd * (motion_velocity - velocity);
+                max_torque = fminf(torque_limit, cybergear::TORQUE_MAX);
+                break;
+        }
+    }
+    // A blocked shaft, or one pushed into a stop, winds the speed loop up
+    // to its torque limit
+    bool held = blocked || (position <= travel_min && drive < load_torque) ||
+                (position >= travel_max && drive > load_torque);
+    bool winding_up = held && (run_mode == RunMode::SPEED || run_mode == RunMode::POSITION);
+    if (winding_up && fabsf(drive - load_torque) > 1e-3f) {
+        drive = drive > load_torque ? max_torque : -max_torque;
+    }
+    torque = clampf(drive, max_torque);
+
+    // Disabled, the lead screw holds the load
+    if (!enabled || held) {
+        velocity = 0.0f;
+    } else {
+        velocity += (torque - load_torque) / config.inertia * dt;
+    }
+    position += velocity * dt;
+    if (position < travel_min || position > travel_max) {
+        position = position < travel_min ? travel_min : travel_max;
+        velocity = 0.0f;
+    }
+
+    float current = torque / config.torque_constant;
+    float cooling = (temperature - config.ambient_c) / config.cooling_tau_s;
+    temperature += (config.heating_c_per_a2_s * current * current - cooling) * dt;
+    if (temperature > config.over_temperature_c) {
+        faults |= cybergear::FAULT_OVER_TEMPERATURE;
+        enabled = false;
+    }
+}
+
+bool CyberGearModel::takeFaultFrame(CanFrame* frame) {
+    uint8_t latched = faults & ~reported_faults;
+    if (!latched) {
+        return false;
+    }
+    reported_faults = faults;
+    // FAULT: 32-bit fault word, little-endian
+    frame->id = cybergear::make_id(CommType::FAULT, config.can_id, master_id);
+    frame->extended = true;
+    frame->len = 8;
+    memset(frame->data, 0, sizeof(frame->data));
+    frame->data[0] = faults;
+    return true;
+}
+
+void CyberGearModel::advance(int64_t t_us) {
+    while (time_us < t_us) {
+        int64_t step_us = t_us - time_us < STEP_US ? t_us - time_us : STEP_US;
+        step(step_us * 1e-6f);
+        time_us += step_us;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include "can_frame.hpp"
+#include "cybergear.hpp"
+
+// ============================================================================
+// CyberGearModel - One CyberGear motor behind its CAN protocol
+// ============================================================================
+// Answers the frames the firmware and position_test send: STOP (optionally
+// clearing faults), run mode and limit writes, ENABLE, SET_ZERO, speed,
+// position and current references, MOTION and parameter reads. Every
+// command is answered with a FEEDBACK frame, as the motor does (parameter
+// reads with the value instead); a newly latched fault is announced with a
+// FAULT frame.
+//
+// Dynamics are first order: the speed loop pulls the velocity towards its
+// reference with time constant velocity_tau_s, position mode feeds a
+// proportional loop into the same speed loop capped at LIMIT_SPD, and the
+// torque this takes is clamped to LIMIT_CUR x torque constant and
+// LIMIT_TORQUE. An external load torque opposes the output; a blocked
+// shaft, or one driven into either end of its travel (the actuator's hard
+// stops), is held still while the speed loop winds up to the torque limit. Winding temperature follows I^2 heating
+// with first-order cooling and latches FAULT_OVER_TEMPERATURE, which
+// disables the motor until a fault-clearing STOP.
+class CyberGearModel {
+public:
+    struct Config {
+        uint8_t can_id;
+        float velocity_tau_s;        // Speed loop time constant
+        float position_gain;         // 1/s, position mode error -> speed
+        float torque_constant;       // Nm/A at the output shaft
+        float inertia;               // kg m^2 at the output, load included
+        float ambient_c;
+        float heating_c_per_a2_s;    // Winding temperature rise per A^2 per second
+        float cooling_tau_s;
+        float over_temperature_c;
+    };
+
+    // A CyberGear turning one actuator's lead screw
+    static Config defaults(uint8_t can_id);
+
+    explicit CyberGearModel(const Config& config);
+
+    uint8_t getCanId() const { return config.can_id; }
+
+    // Apply a frame addressed to this motor; returns the number of replies
+    // written to replies (at most one)
+    int handle(const CanFrame& frame, CanFrame* replies);
+
+    // Integrate the dynamics up to t_us
+    void advance(int64_t t_us);
+
+    // FAULT frame for a fault latched since the last call
+    bool takeFaultFrame(CanFrame* frame);
+
+    // Environment and fault injection
+    void setLoadTorque(float nm) { load_torque = nm; }
+    void setBlocked(bool blocked_param) { blocked = blocked_param; }
+    void setTravel(float min_position, float max_position);             // Hard stops (default none)
+    void setPosition(float position_param) { position = position_param; }
+    void setOffline(bool offline_param) { offline = offline_param; }  // Unpowered: ignores the bus
+    void injectFault(uint8_t fault_bits);
+
+    bool isEnabled() const { return enabled; }
+    cybergear::RunMode getRunMode() const { return run_mode; }
+    float getPosition() const { return position; }
+    float getVelocity() const { return velocity; }
+    float getTorque() const { return torque; }
+    float getTemperature() const { return temperature; }
+    uint8_t getFaults() const { return faults; }
+    uint32_t getCommandCount() const { return commands; }
+
+    // The feedback frame it answers with (position wrapped into +-4 pi)
+    void encodeFeedback(CanFrame* frame) const;
+
+private:
+    static constexpr int64_t STEP_US = 1000;   // Integration step
+
+    Config config;
+    bool enabled;
+    cybergear::RunMode run_mode;
+    uint8_t master_id;        // Taken from the last command
+    float speed_ref;
+    float position_ref;
+    float current_ref;
+    float speed_limit;
+    float current_limit;
+    float torque_limit;
+    // MOTION mode set-points
+    float motion_torque;
+    float motion_position;
+    float motion_velocity;
+    float motion_kp;
+    float motion_kd;
+
+    float position;
+    float velocity;
+    float torque;
+    float temperature;
+    float load_torque;
+    bool blocked;
+    float travel_min;
+    float travel_max;
+    bool offline;
+    uint8_t faults;
+    uint8_t reported_faults;
+    uint32_t commands;
+    int64_t time_us;
+
+    void step(float dt);
+    float readParam(uint16_t index) const;
+    void writeParam(uint16_t index, const uint8_t* value);
+};
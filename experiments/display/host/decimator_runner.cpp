@@ -0,0 +1,191 @@
+// Checks Decimator (the scalar kernel, as built off-target) at the firmware's
+// ACCEL_DECIMATOR_* settings and 800 Hz / 8: sample-for-sample against a
+// double-precision FIR of the same design, the stopband getStopbandDb()
+// reports against the >70 dB the config promises, and how far tones that
+// fold onto the 0..25 Hz band are actually rejected.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "accel_sensor.hpp"
+#include "config.hpp"
+#include "decimator.hpp"
+
+static constexpr int FACTOR = 8;
+static constexpr double INPUT_HZ = 800.0;
+static constexpr double OUTPUT_HZ = INPUT_HZ / FACTOR;
+static constexpr float PROMISED_DB = -70.0f;   // config.hpp: ">70 dB down"
+static constexpr double AMPLITUDE = 4000.0;    // Under the kernel's 2^12 input bound
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static Decimator make_decimator() {
+    Decimator decimator;
+    decimator.init({
+        .factor = FACTOR,
+        .taps = ACCEL_DECIMATOR_TAPS,
+        .cutoff = ACCEL_DECIMATOR_CUTOFF,
+    });
+    return decimator;
+}
+
+// Decimator::init's Blackman-windowed sinc, unquantized
+static std::vector<double> reference_taps() {
+    int taps = ACCEL_DECIMATOR_TAPS;
+    double fc = ACCEL_DECIMATOR_CUTOFF / FACTOR;
+    double center = (taps - 1) / 2.0;
+    std::vector<double> h(taps);
+    double sum = 0;
+    for (int i = 0; i < taps; i++) {
+        double n = i - center;
+        double sinc = n == 0 ? 2.0 * fc : sin(2.0 * M_PI * fc * n) / (M_PI * n);
+        double phase = 2.0 * M_PI * i / (taps - 1);
+        h[i] = sinc * (0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase));
+        sum += h[i];
+    }
+    for (double& tap : h) {
+        tap /= sum;
+    }
+    return h;
+}
+
+// Run input through the decimator in blocks of block_size, x axis only kept
+static std::vector<int16_t> decimate(Decimator& decimator, const std::vector<int16_t>& input, int block_size) {
+    std::vector<int16_t> output;
+    AccelBlock in = {}, out = {};
+    for (size_t start = 0; start < input.size(); start += block_size) {
+        int count = (int)std::min<size_t>(block_size, input.size() - start);
+        in.sample_period_us = (uint32_t)(1e6 / INPUT_HZ);
+        in.count = (uint8_t)count;
+        for (int i = 0; i < count; i++) {
+            in.x[i] = input[start + i];
+            in.y[i] = (int16_t)-input[start + i];
+            in.z[i] = 0;
+        }
+        decimator.process(in, &out);
+        for (int i = 0; i < out.count; i++) {
+            output.push_back(out.x[i]);
+        }
+    }
+    return output;
+}
+
+// Amplitude of one frequency in the settled output (single-bin DFT)
+static double tone_amplitude(const std::vector<int16_t>& output, double hz) {
+    int settled = ACCEL_DECIMATOR_TAPS / FACTOR + 1;
+    double re = 0, im = 0;
+    for (size_t o = settled; o < output.size(); o++) {
+        re += output[o] * cos(2 * M_PI * hz * o / OUTPUT_HZ);
+        im += output[o] * sin(2 * M_PI * hz * o / OUTPUT_HZ);
+    }
+    return 2.0 * sqrt(re * re + im * im) / (output.size() - settled);
+}
+
+static std::vector<int16_t> tone(double hz, int outputs) {
+    std::vector<int16_t> input((size_t)outputs * FACTOR);
+    for (size_t n = 0; n < input.size(); n++) {
+        input[n] = (int16_t)lrint(AMPLITUDE * sin(2 * M_PI * hz * n / INPUT_HZ));
+    }
+    return input;
+}
+
+static void against_reference() {
+    printf("scalar kernel vs double-precision FIR\n");
+    std::vector<double> h = reference_taps();
+    int taps = (int)h.size();
+
+    // Broadband input: noise plus a passband and a stopband tone
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> noise(-0.4, 0.4);
+    std::vector<int16_t> input(8000);
+    for (size_t n = 0; n < input.size(); n++) {
+        double t = n / INPUT_HZ;
+        double value = 0.3 * sin(2 * M_PI * 3.0 * t) + 0.3 * sin(2 * M_PI * 170.0 * t) + noise(rng);
+        input[n] = (int16_t)lrint(AMPLITUDE * value);
+    }
+
+    // Odd block sizes exercise the staging between blocks
+    const int sizes[] = {adxl345::FIFO_DEPTH, 13, 1};
+    for (int size : sizes) {
+        Decimator decimator = make_decimator();
+        std::vector<int16_t> output = decimate(decimator, input, size);
+
+        double max_error = 0, sum_sq = 0;
+        for (size_t o = 0; o < output.size(); o++) {
+            // Output o ends on input (o + 1) * FACTOR - 1; the delay line starts zeroed
+            long newest = (long)(o + 1) * FACTOR - 1;
+            double expected = 0;
+            for (int t = 0; t < taps; t++) {
+                long n = newest - (taps - 1) + t;
+                expected += n >= 0 ? h[t] * input[n] : 0;
+            }
+            double error = fabs(output[o] - expected);
+            max_error = fmax(max_error, error);
+            sum_sq += error * error;
+        }
+        double rms = sqrt(sum_sq / output.size());
+        printf("  blocks of %2d: %zu outputs, max error %.2f LSB, rms %.2f LSB\n", size, output.size(), max_error,
+               rms);
+        check(output.size() == input.size() / FACTOR, "one output per FACTOR inputs");
+        check(max_error <= 2.0 && rms < 0.6, "within Q15 rounding of the reference");
+    }
+}
+
+static void stopband() {
+    printf("stopband, %d taps, cutoff %.2f of %.0f Hz\n", ACCEL_DECIMATOR_TAPS, ACCEL_DECIMATOR_CUTOFF, OUTPUT_HZ);
+    Decimator decimator = make_decimator();
+    printf("  measureStopband: %.1f dB\n", decimator.getStopbandDb());
+    check(decimator.getStopbandDb() <= PROMISED_DB, "reported stopband meets the config's figure");
+
+    // Tones across the band that folds onto 0..cutoff of the output rate,
+    // measured at their alias with a single-bin DFT (keeps rounding noise out)
+    static constexpr int OUTPUTS = 4000;
+    const double tones_hz[] = {
+        (1.0 - ACCEL_DECIMATOR_CUTOFF) * OUTPUT_HZ + 1.0, 90.0, 170.0, 260.0, 333.0, INPUT_HZ / 2 - 5.0,
+    };
+    // Where every output rounds to 0 the rejection is past what 16 bits show
+    float floor_db = (float)(20.0 * log10(0.5 / AMPLITUDE));
+    float worst_db = -200.0f;
+    for (double tone_hz : tones_hz) {
+        Decimator tone_decimator = make_decimator();
+        std::vector<int16_t> output = decimate(tone_decimator, tone(tone_hz, OUTPUTS), adxl345::FIFO_DEPTH);
+
+        double alias_hz = fmod(tone_hz, OUTPUT_HZ);
+        alias_hz = alias_hz > OUTPUT_HZ / 2 ? OUTPUT_HZ - alias_hz : alias_hz;
+        double amplitude = tone_amplitude(output, alias_hz);
+        if (amplitude == 0) {
+            printf("  %5.1f Hz -> %4.1f Hz alias: all outputs 0 (< %.1f dB)\n", tone_hz, alias_hz, floor_db);
+            continue;
+        }
+        float db = (float)(20.0 * log10(amplitude / AMPLITUDE));
+        printf("  %5.1f Hz -> %4.1f Hz alias: %6.1f dB\n", tone_hz, alias_hz, db);
+        worst_db = fmaxf(worst_db, db);
+    }
+    check(worst_db <= PROMISED_DB, "folding tones rejected by the promised figure");
+    check(worst_db <= decimator.getStopbandDb() + 1.0f, "no worse than measureStopband says");
+
+    // And the passband goes through
+    Decimator pass_decimator = make_decimator();
+    double gain_db = 20.0 * log10(tone_amplitude(decimate(pass_decimator, tone(5.0, OUTPUTS), adxl345::FIFO_DEPTH),
+                                                 5.0) / AMPLITUDE);
+    printf("  5 Hz passband: %.2f dB\n", gain_db);
+    check(fabs(gain_db) < 0.5, "5 Hz passes within 0.5 dB");
+}
+
+int main() {
+    against_reference();
+    stopband();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
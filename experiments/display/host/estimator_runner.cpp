@@ -0,0 +1,152 @@
+// Feeds synthetic sensor blocks through AttitudeEstimator and
+// FixedAttitudeEstimator at the firmware's ATTITUDE_CUTOFF_HZ: white noise on
+// a fixed tilt, where the low-pass must cut the angle jitter by the ratio a
+// first-order filter gives, and a clean tilt step, which must reach 63%
+// after about 1 / (2 * pi * cutoff).
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "accel_sensor.hpp"
+#include "attitude_estimator.hpp"
+#include "config.hpp"
+#include "fixed_attitude.hpp"
+
+static constexpr uint32_t SAMPLE_US = 10000;   // 100 Hz, the rate the estimator runs at
+static constexpr float LSB_PER_G = 256.0f;     // Full resolution, 3.9 mg/LSB
+static constexpr float RAD_PER_DEG = (float)M_PI / 180.0f;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// One-sample block of gravity tilted by pitch_deg about X, plus noise (in g)
+static AccelBlock make_block(int64_t t_us, float pitch_deg, float noise_x, float noise_y, float noise_z) {
+    AccelBlock block = {};
+    block.timestamp_us = t_us;
+    block.sample_period_us = SAMPLE_US;
+    block.count = 1;
+    float pitch = pitch_deg * RAD_PER_DEG;
+    block.x[0] = (int16_t)lroundf(noise_x * LSB_PER_G);
+    block.y[0] = (int16_t)lroundf((sinf(pitch) + noise_y) * LSB_PER_G);
+    block.z[0] = (int16_t)lroundf((cosf(pitch) + noise_z) * LSB_PER_G);
+    return block;
+}
+
+static float pitch_of(const AccelBlock& front, const AccelBlock& rear) {
+    return atan2f((float)front.y[0] + rear.y[0], (float)front.z[0] + rear.z[0]) / RAD_PER_DEG;
+}
+
+struct Spread {
+    double sum = 0;
+    double sum_sq = 0;
+    int n = 0;
+
+    void add(double value) {
+        sum += value;
+        sum_sq += value * value;
+        n++;
+    }
+    double stddev() const {
+        double mean = sum / n;
+        return sqrt(sum_sq / n - mean * mean);
+    }
+};
+
+// alpha of the estimator's low-pass at SAMPLE_US
+static float filter_alpha() {
+    float dt = SAMPLE_US * 1e-6f;
+    float rc = 1.0f / (2.0f * (float)M_PI * ATTITUDE_CUTOFF_HZ);
+    return dt / (rc + dt);
+}
+
+static void jitter() {
+    printf("jitter, %.1f Hz cutoff, 20 mg noise per axis\n", ATTITUDE_CUTOFF_HZ);
+    static constexpr float NOISE_G = 0.02f;
+    static constexpr float TILT_DEG = 1.0f;
+    static constexpr int SETTLE = 100;
+    static constexpr int SAMPLES = 20000;
+
+    AttitudeEstimator float_est({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+    FixedAttitudeEstimator fixed_est({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, NOISE_G);
+
+    Spread raw, filtered, fixed;
+    for (int i = 0; i < SETTLE + SAMPLES; i++) {
+        int64_t t = (int64_t)i * SAMPLE_US;
+        AccelBlock front = make_block(t, TILT_DEG, noise(rng), noise(rng), noise(rng));
+        AccelBlock rear = make_block(t, TILT_DEG, noise(rng), noise(rng), noise(rng));
+        float pitch = float_est.update(front, true, rear, true).pitch;
+        int32_t pitch_cdeg = fixed_est.update(front, true, rear, true).pitch_cdeg;
+        if (i >= SETTLE) {
+            raw.add(pitch_of(front, rear));
+            filtered.add(pitch);
+            fixed.add(pitch_cdeg * 0.01);
+        }
+    }
+
+    // White noise through y += alpha * (x - y): variance scales by alpha / (2 - alpha)
+    float alpha = filter_alpha();
+    double expected = 1.0 / sqrt(alpha / (2.0 - alpha));
+    double float_ratio = raw.stddev() / filtered.stddev();
+    double fixed_ratio = raw.stddev() / fixed.stddev();
+    printf("  raw %.3f deg rms, float %.3f, fixed %.3f\n", raw.stddev(), filtered.stddev(), fixed.stddev());
+    printf("  reduction: float %.2fx, fixed %.2fx, first-order %.2fx\n", float_ratio, fixed_ratio, expected);
+    check(fabs(float_ratio / expected - 1.0) < 0.1, "float: jitter cut by the first-order ratio");
+    check(fabs(fixed_ratio / expected - 1.0) < 0.1, "fixed: jitter cut by the first-order ratio");
+    check(fabs(filtered.sum / filtered.n - TILT_DEG) < 0.02, "float: mean on the tilt");
+    check(fabs(fixed.sum / fixed.n - TILT_DEG) < 0.02, "fixed: mean on the tilt");
+}
+
+static void step() {
+    printf("tilt step 0 -> 2 deg\n");
+    static constexpr float STEP_DEG = 2.0f;
+    static constexpr int BEFORE = 50;
+    static constexpr int AFTER = 200;
+
+    AttitudeEstimator float_est({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+    FixedAttitudeEstimator fixed_est({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+    int64_t float_lag = -1, fixed_lag = -1;
+    float float_final = 0, fixed_final = 0;
+    // The step as the sensor reports it, after quantization
+    AccelBlock tilted = make_block(0, STEP_DEG, 0, 0, 0);
+    float target = pitch_of(tilted, tilted);
+    for (int i = 0; i < BEFORE + AFTER; i++) {
+        int64_t t = (int64_t)i * SAMPLE_US;
+        AccelBlock block = make_block(t, i < BEFORE ? 0.0f : STEP_DEG, 0, 0, 0);
+        float_final = float_est.update(block, true, block, true).pitch;
+        fixed_final = fixed_est.update(block, true, block, true).pitch_cdeg * 0.01f;
+        int64_t since_step = t - (int64_t)BEFORE * SAMPLE_US;
+        float threshold = target * (1.0f - expf(-1.0f));
+        if (float_lag < 0 && float_final >= threshold) {
+            float_lag = since_step;
+        }
+        if (fixed_lag < 0 && fixed_final >= threshold) {
+            fixed_lag = since_step;
+        }
+    }
+
+    // The sampled filter's time constant is RC + dt, so allow two samples
+    double tau_ms = 1000.0 / (2.0 * M_PI * ATTITUDE_CUTOFF_HZ);
+    double tolerance_ms = 2 * SAMPLE_US / 1000.0;
+    printf("  63%% after: float %lld ms, fixed %lld ms (1 / (2 pi fc) = %.1f ms)\n", (long long)float_lag / 1000,
+           (long long)fixed_lag / 1000, tau_ms);
+    check(float_lag >= 0 && fabs(float_lag / 1000.0 - tau_ms) <= tolerance_ms, "float: step lag ~1 / (2 pi fc)");
+    check(fixed_lag >= 0 && fabs(fixed_lag / 1000.0 - tau_ms) <= tolerance_ms, "fixed: step lag ~1 / (2 pi fc)");
+    check(fabsf(float_final - target) < 0.01f && fabsf(fixed_final - target) < 0.02f, "both settle on the step");
+}
+
+int main() {
+    jitter();
+    step();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "frame_sim.hpp"
+#include <cmath>
+
+static constexpr float DEG_PER_RAD = 180.0f / (float)M_PI;
+
+FrameSim::FrameSim(const Config& config_param)
+    : config(config_param), height_mm(), velocity_mm_s(), command_mm_s(), time_us(0) {}
+
+void FrameSim::setHeight(int actuator, float height) {
+    height_mm[actuator] = height;
+    velocity_mm_s[actuator] = 0;
+    command_mm_s[actuator] = 0;
+}
+
+void FrameSim::setVelocity(int actuator, float velocity) {
+    command_mm_s[actuator] = velocity;
+}
+
+bool FrameSim::isMoving() const {
+    for (int i = 0; i < ACTUATOR_COUNT; i++) {
+        if (velocity_mm_s[i] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameSim::advance(int64_t t_us) {
+    // Fixed 1 ms steps keep the acceleration limit exact enough
+    const int64_t step_us = 1000;
+    while (time_us < t_us) {
+        int64_t dt_us = t_us - time_us < step_us ? t_us - time_us : step_us;
+        float dt = dt_us * 1e-6f;
+        float max_dv = config.max_accel_mm_s2 * dt;
+
+        for (int i = 0; i < ACTUATOR_COUNT; i++) {
+            float dv = command_mm_s[i] - velocity_mm_s[i];
+            dv = dv > max_dv ? max_dv : dv < -max_dv ? -max_dv : dv;
+            velocity_mm_s[i] += dv;
+            height_mm[i] += velocity_mm_s[i] * dt;
+
+            // End stops
+            if (height_mm[i] < 0 || height_mm[i] > config.travel_mm) {
+                height_mm[i] = height_mm[i] < 0 ? 0 : config.travel_mm;
+                velocity_mm_s[i] = 0;
+            }
+        }
+        time_us += dt_us;
+    }
+}
+
+FrameSim::Angles FrameSim::getAngles() const {
+    float front = (height_mm[FRONT_LEFT] + height_mm[FRONT_RIGHT]) * 0.5f;
+    float rear = (height_mm[REAR_LEFT] + height_mm[REAR_RIGHT]) * 0.5f;
+
+    Angles angles;
+    angles.pitch_deg = atan2f(front - rear, config.length_mm) * DEG_PER_RAD;
+    // Right side lower = positive roll (gravity toward +X)
+    angles.front_roll_deg = atan2f(height_mm[FRONT_LEFT] - height_mm[FRONT_RIGHT], config.width_mm) * DEG_PER_RAD;
+    angles.rear_roll_deg = atan2f(height_mm[REAR_LEFT] - height_mm[REAR_RIGHT], config.width_mm) * DEG_PER_RAD;
+    angles.torsion_deg = angles.front_roll_deg - angles.rear_roll_deg;
+    return angles;
+}
+
+Vec3 FrameSim::endAcceleration(float roll_rad, int64_t t_us, float phase) const {
+    Angles angles = getAngles();
+    float pitch_rad = angles.pitch_deg / DEG_PER_RAD;
+
+    // Direction (tan roll, tan pitch, 1) keeps atan2(x, z) = roll and
+    // atan2(y, z) = pitch exactly
+    Vec3 g = {tanf(roll_rad), tanf(pitch_rad), 1.0f};
+    float norm = 1.0f / sqrtf(g.x * g.x + g.y * g.y + 1.0f);
+    g.x *= norm;
+    g.y *= norm;
+    g.z *= norm;
+
+    bool moving = isMoving();
+    float t = t_us * 1e-6f;
+    for (const Harmonic& h : config.harmonics) {
+        if (h.only_when_moving && !moving) {
+            continue;
+        }
+        float w = 2.0f * (float)M_PI * h.frequency_hz * t;
+        g.x += h.amplitude_g * sinf(w + phase);
+        g.y += h.amplitude_g * sinf(w + phase + 2.1f);
+        g.z += h.amplitude_g * sinf(w + phase + 4.2f);
+    }
+    return g;
+}
+
+Vec3 FrameSim::frontAcceleration(int64_t t_us) const {
+    return endAcceleration(getAngles().front_roll_deg / DEG_PER_RAD, t_us, 0.0f);
+}
+
+Vec3 FrameSim::rearAcceleration(int64_t t_us) const {
+    return endAcceleration(getAngles().rear_roll_deg / DEG_PER_RAD, t_us, 1.3f);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct Vec3 {
+    float x, y, z;
+};
+
+// ============================================================================
+// FrameSim - Bed frame on four actuators
+// ============================================================================
+// The frame is rigid along its length and across each end, but may twist
+// about its long axis when the actuators disagree, so each end has its own
+// roll. Actuator heights are integrated from commanded velocities (with an
+// acceleration limit). Accelerations are reported in the frame's body axes
+// using the firmware's convention: +Y toward the head end, +X to the right,
+// +Z up, so atan2(y, z) is pitch and atan2(x, z) is roll.
+class FrameSim {
+public:
+    enum Actuator {
+        FRONT_LEFT,
+        FRONT_RIGHT,
+        REAR_LEFT,
+        REAR_RIGHT,
+        ACTUATOR_COUNT,
+    };
+
+    // Motor vibration, applied to all axes with per-axis phase
+    struct Harmonic {
+        float frequency_hz;
+        float amplitude_g;
+        bool only_when_moving;     // Motor-driven vs. ambient
+    };
+
+    struct Config {
+        float length_mm;           // Front to rear actuator spacing
+        float width_mm;            // Left to right actuator spacing
+        float travel_mm;           // Actuator stroke (0..travel)
+        float max_accel_mm_s2;     // Actuator acceleration limit
+        std::vector<Harmonic> harmonics;
+    };
+
+    struct Angles {
+        float pitch_deg;
+        float front_roll_deg;
+        float rear_roll_deg;
+        float torsion_deg;         // front roll - rear roll
+    };
+
+    explicit FrameSim(const Config& config);
+
+    void setHeight(int actuator, float height_mm);
+    void setVelocity(int actuator, float velocity_mm_s);
+    float getHeight(int actuator) const { return height_mm[actuator]; }
+    float getVelocity(int actuator) const { return velocity_mm_s[actuator]; }
+    bool isMoving() const;
+
+    // Integrate actuator motion up to t_us (monotonic)
+    void advance(int64_t t_us);
+    int64_t getTime() const { return time_us; }
+
+    // True geometry at the current time
+    Angles getAngles() const;
+
+    // Specific force (gravity + vibration) in g at each end, body axes
+    Vec3 frontAcceleration(int64_t t_us) const;
+    Vec3 rearAcceleration(int64_t t_us) const;
+
+private:
+    Config config;
+    float height_mm[ACTUATOR_COUNT];
+    float velocity_mm_s[ACTUATOR_COUNT];
+    float command_mm_s[ACTUATOR_COUNT];
+    int64_t time_us;
+
+    Vec3 endAcceleration(float roll_rad, int64_t t_us, float phase) const;
+};
@@ -0,0 +1,332 @@
+// Homes the four CyberGear models against hard stops through MotorController
+// and VirtualCanBus with the firmware's homing settings, then runs a
+// full-speed move to the soft limit on the tracked positions and checks them
+// against the models.
+#include <cmath>
+#include <cstdio>
+#include "config.hpp"
+#include "motor_controller.hpp"
+#include "motor_homing.hpp"
+#include "pins.hpp"
+#include "trajectory_planner.hpp"
+#include "virtual_can_bus.hpp"
+
+static constexpr int64_t STEP_US = 1000;
+static const uint8_t MOTOR_IDS[MOTOR_COUNT] = MOTOR_CAN_IDS;
+static const int8_t DIRECTIONS[MOTOR_COUNT] = MOTOR_DIRECTIONS;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// The model's position as the firmware decodes it (wrapped, quantized)
+static float decoded_position(const CyberGearModel& model) {
+    CanFrame frame;
+    cybergear::Feedback feedback;
+    model.encodeFeedback(&frame);
+    cybergear::decode_feedback(frame, &feedback);
+    return feedback.position;
+}
+
+static MotorHoming::Config homing_config() {
+    return {
+        .motor_count = MOTOR_COUNT,
+        .speed_rad_s = -MOTOR_HOMING_RAD_S,
+        .stall_speed_rad_s = MOTOR_HOMING_STALL_RAD_S,
+        .stall_torque_nm = MOTOR_HOMING_STALL_NM,
+        .stall_samples = MOTOR_HOMING_STALL_SAMPLES,
+        .spinup_us = MOTOR_HOMING_SPINUP_MS * 1000LL,
+        .max_feedback_age_us = MOTOR_FEEDBACK_MAX_AGE_MS * 1000LL,
+        .timeout_us = 20000000,   // Shorter than the firmware's, same logic
+        .home_position_rad = 0.0f,
+    };
+}
+
+// Motors, bus and homing as motor_task wires them; time advances in 1 ms
+// steps with a command batch every MOTOR_CYCLE_MS
+struct Rig {
+    VirtualCanBus can;
+    MotorController motors;
+    MotorHoming homing;
+    MotorState states[MOTOR_COUNT] = {};
+    bool valid[MOTOR_COUNT] = {};
+    int64_t now = 0;
+
+    Rig()
+        : can({
+              .bitrate = CAN_BITRATE,
+              .tx_queue_len = CAN_TX_QUEUE_LEN,
+              .rx_queue_len = CAN_RX_QUEUE_LEN,
+              .response_latency_us = 200,
+              .error_rate = 0.0f,
+              .seed = 1,
+          }),
+          motors({
+              .master_id = MOTOR_CAN_MASTER_ID,
+              .motor_count = MOTOR_COUNT,
+              .motor_ids = MOTOR_CAN_IDS,
+              .directions = MOTOR_DIRECTIONS,
+              .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+              .stop_cycles = MOTOR_STOP_CYCLES,
+              .transmit = [this](const CanFrame* frames, int count) { return can.transmit(frames, count); },
+          }),
+          homing(homing_config()) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            can.addMotor(CyberGearModel::defaults(MOTOR_IDS[i]));
+        }
+    }
+
+    CyberGearModel* model(int i) { return can.getMotor(MOTOR_IDS[i]); }
+
+    // Joint position of a model (frame convention)
+    float joint(int i) { return model(i)->getPosition() * DIRECTIONS[i]; }
+
+    // One millisecond; true on a command cycle (after the batch went out)
+    template <typename Drive>
+    bool step(Drive drive) {
+        now += STEP_US;
+        can.advance(now);
+        CanFrame frame;
+        while (can.receive(&frame)) {
+            int motor;
+            MotorState state;
+            if (motors.decode(frame, now, &motor, &state)) {
+                states[motor] = state;
+                valid[motor] = true;
+            }
+        }
+        if (now % (MOTOR_CYCLE_MS * 1000) != 0) {
+            return false;
+        }
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (valid[i]) {
+                homing.track(i, states[i]);
+            }
+        }
+        drive();
+        motors.cycle();
+        return true;
+    }
+
+    // Home; returns how late (worst case) each stall was detected after the
+    // motor actually stopped against its stop
+    int64_t home(int64_t limit_us) {
+        int64_t stopped_us[MOTOR_COUNT];
+        for (int64_t& t : stopped_us) {
+            t = -1;
+        }
+        homing.start(now);
+        int64_t start = now;
+        while (now - start < limit_us) {
+            step([this]() {
+                const MotorHoming::Output& out = homing.update(now, states, valid);
+                for (int i = 0; i < MOTOR_COUNT; i++) {
+                    motors.setVelocity(i, out.motor_rad_s[i]);
+                }
+            });
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                CyberGearModel* m = model(i);
+                if (stopped_us[i] < 0 && m->isEnabled() && now - start > 100000 && m->getVelocity() == 0.0f) {
+                    stopped_us[i] = now - start;
+                }
+            }
+            if (!homing.isActive()) {
+                break;
+            }
+        }
+        int64_t worst = 0;
+        const MotorHoming::Metrics& metrics = homing.getMetrics();
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (metrics.stop_us[i] >= 0 && stopped_us[i] >= 0 && metrics.stop_us[i] - stopped_us[i] > worst) {
+                worst = metrics.stop_us[i] - stopped_us[i];
+            }
+        }
+        // Let the motors stop and disable
+        for (int i = 0; i < 10 * MOTOR_CYCLE_MS; i++) {
+            step([this]() { motors.stopAll(); });
+        }
+        return worst;
+    }
+};
+
+static void print_metrics(const MotorHoming& homing) {
+    const MotorHoming::Metrics& metrics = homing.getMetrics();
+    printf("  %s after %.2f s\n", MotorHoming::stateName(homing.getState()), metrics.duration_us * 1e-6f);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        if (metrics.stop_us[i] < 0) {
+            printf("    motor %d: no stop, %.2f Nm peak\n", i + 1, metrics.peak_torque_nm[i]);
+            continue;
+        }
+        printf("    motor %d: stop after %.2f s, %.2f rad, %.2f Nm peak\n", i + 1, metrics.stop_us[i] * 1e-6f,
+               metrics.travel_rad[i], metrics.peak_torque_nm[i]);
+    }
+}
+
+static void parallel_homing_test() {
+    printf("parallel homing, stops 2..5 rad below\n");
+    Rig rig;
+    const float depth[MOTOR_COUNT] = {3.0f, 5.0f, 2.0f, 4.0f};
+    const float stroke_rad = ACTUATOR_STROKE_MM / ACTUATOR_MM_PER_RAD;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        float low = -depth[i] * DIRECTIONS[i];
+        float high = (stroke_rad - depth[i]) * DIRECTIONS[i];
+        rig.model(i)->setTravel(fminf(low, high), fmaxf(low, high));
+    }
+
+    int64_t late_us = rig.home(60000000);
+    print_metrics(rig.homing);
+    const MotorHoming::Metrics& metrics = rig.homing.getMetrics();
+    check(rig.homing.getState() == MotorHoming::State::HOMED, "all motors homed");
+    check(rig.homing.isReferenced(), "positions referenced");
+    bool travel_ok = true;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        travel_ok = travel_ok && fabsf(metrics.travel_rad[i] + depth[i]) < 0.05f;
+    }
+    check(travel_ok, "tracked travel to each stop within 0.05 rad");
+    bool parallel = metrics.duration_us < (5.0f / MOTOR_HOMING_RAD_S + 1.0f) * 1e6f;
+    check(parallel, "motors home in parallel (deepest stop + 1 s)");
+    printf("  stall detected at most %.0f ms after the motor stopped\n", late_us / 1000.0);
+    check(late_us <= (MOTOR_HOMING_STALL_SAMPLES + 2) * MOTOR_CYCLE_MS * 1000LL,
+          "stall detected within stall_samples + 2 cycles");
+    bool stopped = true;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        stopped = stopped && !rig.model(i)->isEnabled();
+    }
+    check(stopped, "motors released at their stops");
+
+    // Full speed up to the soft limit on the referenced positions
+    float targets[MOTOR_COUNT];
+    TrajectoryPlanner::Config planner_config = {};
+    planner_config.axis_count = MOTOR_COUNT;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        planner_config.max_velocity[i] = MOTOR_SPEED_RAD_S;
+        planner_config.max_acceleration[i] = MOTOR_ACCEL_RAD_S2;
+        targets[i] = 40.0f;
+    }
+    TrajectoryPlanner planner(planner_config);
+    planner.reset(rig.homing.getPositions());
+    planner.plan(rig.now, targets);
+    float peak_speed = 0;
+    while (!planner.isDone(rig.now - 200000)) {
+        rig.step([&]() {
+            TrajectoryPlanner::Setpoint setpoint;
+            planner.sample(rig.now, &setpoint);
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                rig.motors.setVelocity(i, setpoint.done ? 0.0f : setpoint.velocity[i]);
+            }
+        });
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            peak_speed = fmaxf(peak_speed, fabsf(rig.model(i)->getVelocity()));
+        }
+    }
+    for (int i = 0; i < 10 * MOTOR_CYCLE_MS; i++) {
+        rig.step([&]() { rig.motors.stopAll(); });
+    }
+    float worst = 0;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        float truth = rig.joint(i) + depth[i];   // From the stop
+        worst = fmaxf(worst, fabsf(rig.homing.getPositions()[i] - truth));
+    }
+    printf("  move to 40 rad at up to %.2f rad/s: tracked position off by %.3f rad at most\n", peak_speed, worst);
+    check(peak_speed > 0.95f * MOTOR_SPEED_RAD_S, "referenced move runs at full speed");
+    check(worst < 0.05f, "tracked positions match the motors within 0.05 rad");
+}
+
+static void already_home_test() {
+    printf("already at the stops\n");
+    Rig rig;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        rig.model(i)->setTravel(0.0f, 100.0f);
+    }
+    rig.home(5000000);
+    print_metrics(rig.homing);
+    check(rig.homing.getState() == MotorHoming::State::HOMED, "homed");
+    check(rig.homing.getMetrics().duration_us < MOTOR_HOMING_SPINUP_MS * 1000LL + 200000,
+          "done shortly after spin-up");
+}
+
+static void no_stop_test() {
+    printf("stop out of reach\n");
+    Rig rig;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        rig.model(i)->setTravel(i == 2 ? -1000.0f : -1.0f, 100.0f);
+    }
+    rig.home(30000000);
+    print_metrics(rig.homing);
+    check(rig.homing.getState() == MotorHoming::State::TIMED_OUT, "times out");
+    check(!rig.homing.isReferenced(), "positions stay unreferenced");
+    check(!rig.model(2)->isEnabled(), "motor stopped after the timeout");
+}
+
+static void unplugged_test() {
+    printf("motor unplugged mid-run\n");
+    Rig rig;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        rig.model(i)->setTravel(-5.0f, 100.0f);
+    }
+    rig.homing.start(rig.now);
+    while (rig.homing.isActive() && rig.now < 10000000) {
+        if (rig.now == 1000000) {
+            rig.model(1)->setOffline(true);
+        }
+        rig.step([&]() {
+            const MotorHoming::Output& out = rig.homing.update(rig.now, rig.states, rig.valid);
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                rig.motors.setVelocity(i, out.motor_rad_s[i]);
+            }
+        });
+    }
+    print_metrics(rig.homing);
+    check(rig.homing.getState() == MotorHoming::State::NO_FEEDBACK, "ends with no feedback");
+    check(rig.now - 1000000 <= MOTOR_FEEDBACK_MAX_AGE_MS * 1000LL + 2 * MOTOR_CYCLE_MS * 1000LL,
+          "within the feedback age limit");
+    check(!rig.homing.isReferenced(), "positions stay unreferenced");
+}
+
+static void restore_test() {
+    printf("restore saved positions\n");
+    MotorHoming homing(homing_config());
+    const float saved[MOTOR_COUNT] = {12.5f, 12.4f, 12.6f, 12.5f};
+    check(!homing.isReferenced(), "unreferenced at boot");
+    homing.restore(saved);
+    check(homing.isReferenced() && homing.getPositions()[2] == 12.6f, "referenced at the saved positions");
+
+    // Tracking continues from there: 20 rad/s for two seconds, across the
+    // position field's wrap, through decoded frames
+    CyberGearModel model(CyberGearModel::defaults(MOTOR_IDS[0]));
+    MotorState state = {};
+    int64_t t = 0;
+    for (; t <= 2000000; t += 20000) {
+        model.setPosition(20.0f * t * 1e-6f - 3.0f);
+        state.position = decoded_position(model);
+        state.timestamp_us = t;
+        homing.track(0, state);
+    }
+    check(fabsf(homing.getPositions()[0] - 52.5f) < 0.01f, "tracked from the restored position");
+
+    // At rest for a day of status polls: no drift
+    for (int64_t end = t + 86400LL * 1000000; t < end; t += CAN_STATUS_PERIOD_MS * 1000) {
+        state.timestamp_us = t;
+        homing.track(0, state);
+    }
+    printf("  %.4f rad after a day at rest\n", homing.getPositions()[0]);
+    check(fabsf(homing.getPositions()[0] - 52.5f) < 0.01f, "no drift at rest");
+}
+
+int main() {
+    parallel_homing_test();
+    already_home_test();
+    no_stop_test();
+    unplugged_test();
+    restore_test();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Runs I2cHealth with the firmware's settings against SimI2cBus fault
+// injection, through the accelerometer task's retry loop (check_accel_stage
+// and probe_accel, on a simulated clock): NACK retries with backoff, bus
+// recovery on timeouts and arbitration loss, going offline after
+// ACCEL_I2C_OFFLINE_AFTER failures, probing and re-init, and the counters.
+#include <cstdio>
+#include "accel_sensor.hpp"
+#include "adxl345_sim.hpp"
+#include "config.hpp"
+#include "i2c_health.hpp"
+#include "sim_i2c_bus.hpp"
+
+static constexpr uint8_t ADDRESS = 0x53;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// One sensor on the simulated bus, with the health policy and a clock that
+// the backoff delays advance
+struct Rig {
+    Adxl345Sim sim;
+    SimI2cBus bus;
+    AccelSensor sensor;
+    I2cHealth health;
+    int id;
+    int64_t now = 0;
+
+    Rig()
+        : sim({
+              .address = ADDRESS,
+              .source = [](int64_t) { return Vec3{0.0f, 0.0f, 1.0f}; },
+              .mount_roll_deg = 0.0f,
+              .mount_pitch_deg = 0.0f,
+              .mount_yaw_deg = 0.0f,
+              .noise_ug_per_rt_hz = 290.0f,
+              .bias_g = {0, 0, 0},
+              .seed = 1,
+          }),
+          sensor({
+              .device_address = ADDRESS,
+              .write = [this](uint8_t addr, const uint8_t* data, size_t len) { return bus.write(addr, data, len); },
+              .write_read = [this](uint8_t addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+                  return bus.write_read(addr, wdata, wlen, rdata, rlen);
+              },
+              .wait = [this]() { return bus.wait(); },
+          }),
+          health({
+              .max_retries = ACCEL_I2C_MAX_RETRIES,
+              .backoff_us = ACCEL_I2C_BACKOFF_MS * 1000LL,
+              .recover_after = ACCEL_I2C_RECOVER_AFTER,
+              .offline_after = ACCEL_I2C_OFFLINE_AFTER,
+              .probe_period_us = ACCEL_I2C_PROBE_PERIOD_MS * 1000LL,
+          }) {
+        bus.addDevice(&sim);
+        id = health.addDevice();
+        sensor.init(adxl345::RATE_100_HZ, ACCEL_FIFO_WATERMARK, {});
+        bus.takeError(ADDRESS);
+    }
+
+    // check_accel_stage for a status read: true if it finally went through
+    bool readStatus() {
+        bool queued = sensor.requestStatus();
+        bus.wait();
+        int attempt = 0;
+        while (1) {
+            I2cError error = bus.takeError(ADDRESS);
+            if (!queued && error == I2cError::NONE) {
+                error = I2cError::OTHER;
+            }
+            switch (health.record(id, error, attempt, now)) {
+                case I2cHealth::Action::OK:
+                    return true;
+                case I2cHealth::Action::FAIL:
+                case I2cHealth::Action::OFFLINE:
+                    return false;
+                case I2cHealth::Action::RECOVER_BUS:
+                    bus.recover();
+                    if (!health.retriesLeft(attempt)) {
+                        return false;
+                    }
+                    break;
+                case I2cHealth::Action::RETRY:
+                    break;
+            }
+            now += health.retryDelay(attempt);
+            attempt++;
+            queued = sensor.requestStatus();
+            bus.wait();
+        }
+    }
+
+    // probe_accel: re-init when a probe is due; true if it came back
+    bool probe() {
+        if (!health.probeDue(id, now)) {
+            return false;
+        }
+        bool ok = sensor.init(adxl345::RATE_100_HZ, ACCEL_FIFO_WATERMARK, sensor.getOffsets());
+        bus.takeError(ADDRESS);
+        health.probeResult(id, ok);
+        return ok;
+    }
+};
+
+static void retries() {
+    printf("NACK retries with backoff\n");
+    Rig rig;
+    rig.bus.failNext(ADDRESS, I2cError::NACK, 1);
+    bool ok = rig.readStatus();
+    check(ok && rig.now == ACCEL_I2C_BACKOFF_MS * 1000LL, "one NACK: retried after the first backoff");
+
+    rig.now = 0;
+    rig.bus.failNext(ADDRESS, I2cError::NACK, ACCEL_I2C_MAX_RETRIES);
+    ok = rig.readStatus();
+    printf("  %d NACKs: %s after %lld ms of backoff\n", ACCEL_I2C_MAX_RETRIES, ok ? "read" : "failed",
+           (long long)rig.now / 1000);
+    check(ok && rig.now == ACCEL_I2C_BACKOFF_MS * 1000LL * ((1 << ACCEL_I2C_MAX_RETRIES) - 1),
+          "backoff doubles per retry");
+
+    rig.bus.failNext(ADDRESS, I2cError::NACK, ACCEL_I2C_MAX_RETRIES + 1);
+    check(!rig.readStatus(), "out of retries: the read fails");
+    check(rig.health.isOnline(rig.id), "still online");
+
+    const I2cHealth::DeviceStats& stats = rig.health.getStats(rig.id);
+    printf("  ok %u, nack %u, retries %u, recoveries %u\n", stats.successes, stats.nacks, stats.retries,
+           stats.recoveries);
+    check(stats.nacks == 1 + 2 * ACCEL_I2C_MAX_RETRIES + 1, "every NACK counted");
+    check(stats.successes == 2, "successes counted");
+    check(stats.consecutive_failures == ACCEL_I2C_MAX_RETRIES + 1, "consecutive failures counted");
+}
+
+static void recovery() {
+    printf("bus recovery\n");
+    Rig rig;
+    rig.bus.setStuck(true);
+    check(rig.readStatus(), "stuck bus: recovered and read");
+    check(rig.health.getStats(rig.id).timeouts == 1 && rig.health.getStats(rig.id).recoveries == 1,
+          "timeout recovers at once");
+    check(rig.bus.getStats().recoveries == 1, "bus recovered once");
+
+    rig.bus.failNext(ADDRESS, I2cError::ARBITRATION, 1);
+    check(rig.readStatus(), "arbitration lost: recovered and read");
+    check(rig.health.getStats(rig.id).arbitration_losses == 1 && rig.health.getStats(rig.id).recoveries == 2,
+          "arbitration loss recovers at once");
+
+    // Repeated NACKs recover every ACCEL_I2C_RECOVER_AFTER failures
+    uint32_t before = rig.health.getStats(rig.id).recoveries;
+    rig.bus.failNext(ADDRESS, I2cError::NACK, ACCEL_I2C_RECOVER_AFTER);
+    while (!rig.readStatus()) {
+    }
+    check(rig.health.getStats(rig.id).recoveries == before + 1, "NACK run recovers after RECOVER_AFTER");
+}
+
+static void offline() {
+    printf("offline and re-init\n");
+    Rig rig;
+    rig.bus.setFailureRate(ADDRESS, I2cError::NACK, 1.0f);
+    int reads = 0;
+    while (rig.health.isOnline(rig.id) && reads < 100) {
+        rig.readStatus();
+        reads++;
+        rig.now += 10000;
+    }
+    const I2cHealth::DeviceStats& stats = rig.health.getStats(rig.id);
+    printf("  offline after %d reads, %u NACKs\n", reads, stats.nacks);
+    check(!rig.health.isOnline(rig.id), "device goes offline");
+    check(stats.nacks == ACCEL_I2C_OFFLINE_AFTER, "after OFFLINE_AFTER consecutive failures");
+
+    // Probes once per period; a probe into a dead device keeps it offline
+    int64_t offline_at = rig.now;
+    int probes = 0;
+    for (int64_t end = offline_at + 3 * ACCEL_I2C_PROBE_PERIOD_MS * 1000LL; rig.now < end; rig.now += 10000) {
+        probes += rig.health.probeDue(rig.id, rig.now) ? 1 : 0;
+    }
+    check(probes == 3 && !rig.health.isOnline(rig.id), "probed once per period");
+    check(!rig.probe(), "re-init fails while the device is dead");
+
+    rig.bus.setFailureRate(ADDRESS, I2cError::NACK, 0.0f);
+    bool back = false;
+    for (int64_t end = rig.now + 2 * ACCEL_I2C_PROBE_PERIOD_MS * 1000LL; rig.now < end && !back; rig.now += 10000) {
+        back = rig.probe();
+    }
+    check(back && rig.health.isOnline(rig.id), "re-initialized when it answers");
+    check(stats.reinits == 1 && stats.consecutive_failures == 0, "reinit counted, failures cleared");
+    check(rig.readStatus(), "reads again");
+}
+
+int main() {
+    retries();
+    recovery();
+    offline();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Checks the firmware's FrameKinematics against FrameSim geometry: pose
+// steps land where requested, the map round-trips, joint limits keep the
+// step's direction, and a bad corner assignment is rejected.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "config.hpp"
+#include "frame_kinematics.hpp"
+#include "frame_sim.hpp"
+
+static constexpr int MOTORS = FrameKinematics::MOTORS;
+
+static const FrameKinematics::Config KINEMATICS_CONFIG = {
+    .length_mm = FRAME_LENGTH_MM,
+    .width_mm = FRAME_WIDTH_MM,
+    .mm_per_rad = ACTUATOR_MM_PER_RAD,
+    .pitch_signs = MOTOR_PITCH_SIGNS,
+    .roll_signs = MOTOR_ROLL_SIGNS,
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// Frame at mid stroke moved by joint changes (motor i drives actuator i)
+static FrameSim::Angles apply(const float* joints) {
+    FrameSim frame({
+        .length_mm = FRAME_LENGTH_MM,
+        .width_mm = FRAME_WIDTH_MM,
+        .travel_mm = ACTUATOR_STROKE_MM,
+        .max_accel_mm_s2 = 50.0f,
+        .harmonics = {},
+    });
+    for (int i = 0; i < MOTORS; i++) {
+        frame.setHeight(i, ACTUATOR_STROKE_MM * 0.5f + joints[i] * ACTUATOR_MM_PER_RAD);
+    }
+    return frame.getAngles();
+}
+
+int main() {
+    FrameKinematics kinematics(KINEMATICS_CONFIG);
+
+    printf("Pose steps against frame geometry\n");
+    {
+        check(kinematics.isValid(), "corner assignment spans all axes");
+
+        struct Step {
+            FrameKinematics::Axis axis;
+            float amount;
+        };
+        const Step steps[] = {
+            {FrameKinematics::PITCH, 2.0f},
+            {FrameKinematics::ROLL, -1.5f},
+            {FrameKinematics::TORSION, 1.0f},
+        };
+        float worst = 0;
+        for (const Step& step : steps) {
+            float pose[FrameKinematics::AXIS_COUNT] = {};
+            pose[step.axis] = step.amount;
+            float joints[MOTORS];
+            kinematics.toJoints(pose, joints);
+            FrameSim::Angles angles = apply(joints);
+            float roll = (angles.front_roll_deg + angles.rear_roll_deg) * 0.5f;
+            float got[FrameKinematics::AXIS_COUNT] = {0, angles.pitch_deg, roll, angles.torsion_deg};
+            for (int axis = FrameKinematics::PITCH; axis < FrameKinematics::AXIS_COUNT; axis++) {
+                worst = fmaxf(worst, fabsf(got[axis] - pose[axis]));
+            }
+            printf("  %s %+.1f deg -> pitch %+.3f roll %+.3f torsion %+.3f, joints %+.2f %+.2f %+.2f %+.2f rad\n",
+                   step.axis == FrameKinematics::PITCH ? "pitch" : step.axis == FrameKinematics::ROLL ? "roll" : "torsion",
+                   step.amount, got[1], got[2], got[3], joints[0], joints[1], joints[2], joints[3]);
+        }
+        // Small-angle map: tan error is ~0.1% at 2 deg
+        check(worst < 0.01f, "each step moves only its own axis, by the amount");
+
+        float pose[FrameKinematics::AXIS_COUNT] = {12.0f, -0.7f, 0.4f, 0.25f};
+        float joints[MOTORS];
+        float back[FrameKinematics::AXIS_COUNT];
+        kinematics.toJoints(pose, joints);
+        kinematics.toPose(joints, back);
+        float error = 0;
+        for (int axis = 0; axis < FrameKinematics::AXIS_COUNT; axis++) {
+            error = fmaxf(error, fabsf(back[axis] - pose[axis]));
+        }
+        check(error < 1e-4f, "toPose(toJoints(x)) == x");
+    }
+
+    printf("Joint limits\n");
+    {
+        FrameKinematics limited(KINEMATICS_CONFIG);
+        float min[MOTORS] = {-10, -10, -10, -10};
+        float max[MOTORS] = {10, 10, 10, 10};
+        limited.setJointLimits(min, max);
+
+        float from[MOTORS] = {8, 0, 0, -8};
+        float pose[FrameKinematics::AXIS_COUNT] = {0, 2.0f, 0, 0};
+        float step[MOTORS];
+        limited.toJoints(pose, step);
+        float wanted[MOTORS];
+        for (int i = 0; i < MOTORS; i++) {
+            wanted[i] = step[i];
+        }
+        float kept = limited.clampStep(from, step);
+        bool inside = true;
+        bool parallel = true;
+        for (int i = 0; i < MOTORS; i++) {
+            inside = inside && from[i] + step[i] <= max[i] + 1e-4f && from[i] + step[i] >= min[i] - 1e-4f;
+            parallel = parallel && fabsf(step[i] - wanted[i] * kept) < 1e-5f;
+        }
+        printf("  pitch +2 deg from the limit: %.0f%% kept\n", kept * 100.0f);
+        check(kept > 0 && kept < 1, "step cut short");
+        check(inside, "every joint stays within its limits");
+        check(parallel, "cut step points the same way");
+
+        float back[MOTORS];
+        for (int i = 0; i < MOTORS; i++) {
+            back[i] = -0.1f * wanted[i];
+        }
+        float past[MOTORS] = {12, 0, 0, -12};
+        check(limited.clampStep(past, back) == 1.0f, "a joint past its limit may move back");
+    }
+
+    printf("Corner assignment\n");
+    {
+        FrameKinematics::Config bad = KINEMATICS_CONFIG;
+        bad.roll_signs[1] = bad.roll_signs[0];  // Two motors on the front left
+        check(!FrameKinematics(bad).isValid(), "two motors on one corner rejected");
+    }
+
+    printf("Cost\n");
+    {
+        const int ticks = 1000000;
+        float pose[FrameKinematics::AXIS_COUNT] = {0, 0.5f, 0, 0};
+        float joints[MOTORS];
+        float sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int n = 0; n < ticks; n++) {
+            pose[FrameKinematics::PITCH] = (n & 7) * 0.1f;
+            kinematics.toJoints(pose, joints);
+            sum += joints[0];
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        printf("  %.1f ns per pose step (checksum %.0f)\n", ns / ticks, sum);
+    }
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
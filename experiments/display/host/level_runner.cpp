@@ -0,0 +1,258 @@
+// Closes the LEVEL loop on host: the simulated frame feeds simulated ADXL345s
+// through the firmware's sensor driver and estimator, LevelController runs at
+// the motor cycle rate with the firmware's tuning, and its speeds go through
+// MotorController and VirtualCanBus back to the frame's actuators.
+#include <cmath>
+#include <cstdio>
+#include "accel_sensor.hpp"
+#include "adxl345_sim.hpp"
+#include "config.hpp"
+#include "fixed_attitude.hpp"
+#include "frame_kinematics.hpp"
+#include "frame_sim.hpp"
+#include "level_controller.hpp"
+#include "motor_controller.hpp"
+#include "pins.hpp"
+#include "sim_i2c_bus.hpp"
+#include "virtual_can_bus.hpp"
+
+static constexpr int64_t SAMPLE_US = 10000;   // 100 Hz
+static const uint8_t MOTOR_IDS[MOTOR_COUNT] = MOTOR_CAN_IDS;
+static const int8_t DIRECTIONS[MOTOR_COUNT] = MOTOR_DIRECTIONS;
+
+struct Scenario {
+    const char* name;
+    float heights_mm[FrameSim::ACTUATOR_COUNT];   // FL, FR, RL, RR
+    float vibration_g;
+    float fault_rate;                             // Per-transfer NACK probability
+    float max_height_mm;                          // Joint limit of every corner
+    LevelController::State expected;
+};
+
+static const Scenario SCENARIOS[] = {
+    {"head high 1 deg",      {167.5f, 167.5f, 132.5f, 132.5f}, 0.0f,  0.0f, 300.0f, LevelController::State::SETTLED},
+    {"left high 1 deg",      {162.2f, 137.8f, 162.2f, 137.8f}, 0.0f,  0.0f, 300.0f, LevelController::State::SETTLED},
+    {"2 deg both, vibration", {210.0f, 160.0f, 140.0f, 90.0f}, 0.05f, 0.0f, 300.0f, LevelController::State::SETTLED},
+    {"already level",        {150.0f, 150.0f, 150.0f, 150.0f}, 0.0f,  0.0f, 300.0f, LevelController::State::SETTLED},
+    {"sensors lost",         {167.5f, 167.5f, 132.5f, 132.5f}, 0.0f,  1.0f, 300.0f, LevelController::State::NO_ATTITUDE},
+    {"rear up against limit", {167.5f, 167.5f, 132.5f, 132.5f}, 0.0f, 0.0f, 140.0f, LevelController::State::LIMITED},
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static FrameKinematics kinematics({
+    .length_mm = FRAME_LENGTH_MM,
+    .width_mm = FRAME_WIDTH_MM,
+    .mm_per_rad = ACTUATOR_MM_PER_RAD,
+    .pitch_signs = MOTOR_PITCH_SIGNS,
+    .roll_signs = MOTOR_ROLL_SIGNS,
+});
+
+static LevelController::Config level_config() {
+    LevelController::Config config = {
+        .kp = LEVEL_KP,
+        .ki = LEVEL_KI,
+        .max_rate_dps = LEVEL_MAX_RATE_DPS,
+        .max_rate_change_dps2 = LEVEL_MAX_ACCEL_DPS2,
+        .tolerance_deg = LEVEL_TOLERANCE_DEG,
+        .settle_us = LEVEL_SETTLE_MS * 1000LL,
+        .timeout_us = LEVEL_TIMEOUT_MS * 1000LL,
+        .max_attitude_age_us = LEVEL_ATTITUDE_MAX_AGE_MS * 1000LL,
+        .kinematics = &kinematics,
+        .max_motor_rad_s = MOTOR_SPEED_RAD_S,
+    };
+    return config;
+}
+
+static void run(const Scenario& scenario) {
+    printf("%s\n", scenario.name);
+
+    FrameSim frame({
+        .length_mm = FRAME_LENGTH_MM,
+        .width_mm = FRAME_WIDTH_MM,
+        .travel_mm = 300.0f,
+        .max_accel_mm_s2 = 50.0f,
+        .harmonics = {{47.0f, scenario.vibration_g, true}},
+    });
+    for (int i = 0; i < FrameSim::ACTUATOR_COUNT; i++) {
+        frame.setHeight(i, scenario.heights_mm[i]);
+    }
+
+    auto sensor_sim = [&frame](uint8_t address, bool front, uint32_t seed) {
+        return Adxl345Sim::Config{
+            .address = address,
+            .source = [&frame, front](int64_t t) {
+                return front ? frame.frontAcceleration(t) : frame.rearAcceleration(t);
+            },
+            .mount_roll_deg = 0.0f,
+            .mount_pitch_deg = 0.0f,
+            .mount_yaw_deg = 0.0f,
+            .noise_ug_per_rt_hz = 290.0f,
+            .bias_g = {0, 0, 0},
+            .seed = seed,
+        };
+    };
+    Adxl345Sim front_sim(sensor_sim(0x1D, true, 1));
+    Adxl345Sim rear_sim(sensor_sim(0x53, false, 2));
+    SimI2cBus i2c;
+    i2c.addDevice(&front_sim);
+    i2c.addDevice(&rear_sim);
+    auto sensor_config = [&i2c](uint8_t address) {
+        return AccelSensor::Config{
+            .device_address = address,
+            .write = [&i2c](uint8_t addr, const uint8_t* data, size_t len) { return i2c.write(addr, data, len); },
+            .write_read = [&i2c](uint8_t addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+                return i2c.write_read(addr, wdata, wlen, rdata, rlen);
+            },
+            .wait = [&i2c]() { return i2c.wait(); },
+        };
+    };
+    AccelSensor front(sensor_config(0x1D));
+    AccelSensor rear(sensor_config(0x53));
+    front.init(adxl345::RATE_100_HZ, ACCEL_FIFO_WATERMARK, {});
+    rear.init(adxl345::RATE_100_HZ, ACCEL_FIFO_WATERMARK, {});
+    i2c.setFailureRate(0x1D, I2cError::NACK, scenario.fault_rate);
+    i2c.setFailureRate(0x53, I2cError::NACK, scenario.fault_rate);
+    FixedAttitudeEstimator estimator({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+
+    VirtualCanBus can({
+        .bitrate = 1000000,
+        .tx_queue_len = CAN_TX_QUEUE_LEN,
+        .rx_queue_len = CAN_RX_QUEUE_LEN,
+        .response_latency_us = 200,
+        .error_rate = 0.0f,
+        .seed = 1,
+    });
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        can.addMotor(CyberGearModel::defaults(MOTOR_IDS[i]));
+    }
+    MotorController motors({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&can](const CanFrame* frames, int count) { return can.transmit(frames, count); },
+    });
+
+    float joint_min[MOTOR_COUNT], joint_max[MOTOR_COUNT];
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        joint_min[i] = 0.0f;
+        joint_max[i] = scenario.max_height_mm / ACTUATOR_MM_PER_RAD;
+    }
+    kinematics.setJointLimits(joint_min, joint_max);
+    LevelController leveler(level_config());
+
+    // Let the estimate settle on the starting pose, as the bubble would
+    float pitch = 0, roll = 0;
+    int64_t attitude_us = -1;
+    int64_t start_us = 3000000;
+    int64_t end_us = start_us + LEVEL_TIMEOUT_MS * 1000LL + 5000000;
+    float true_overshoot = 0;
+    FrameSim::Angles initial = frame.getAngles();
+    float initial_roll = (initial.front_roll_deg + initial.rear_roll_deg) * 0.5f;
+
+    for (int64_t now = SAMPLE_US; now <= end_us; now += SAMPLE_US) {
+        frame.advance(now);
+        front_sim.advance(now);
+        rear_sim.advance(now);
+        can.advance(now);
+
+        if (now % (ACCEL_TASK_PERIOD_MS * 1000) == 0) {
+            static AccelBlock front_block, rear_block;
+            bool front_ok = front.drain(&front_block, now);
+            bool rear_ok = rear.drain(&rear_block, now);
+            const FixedAttitudeEstimator::Attitude& att =
+                estimator.update(front_block, front_ok && front_block.count, rear_block, rear_ok && rear_block.count);
+            if ((front_ok || rear_ok) && (att.front_valid || att.rear_valid)) {
+                pitch = att.pitch_cdeg / 100.0f;
+                roll = att.roll_cdeg / 100.0f;
+                attitude_us = now;
+            }
+        }
+
+        if (now % (MOTOR_CYCLE_MS * 1000) == 0 && now >= start_us) {
+            if (now == start_us) {
+                leveler.start(now);
+            }
+            // Joint positions as tracked: corner heights in motor radians
+            float joints[MOTOR_COUNT];
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                joints[i] = frame.getHeight(i) / ACTUATOR_MM_PER_RAD;
+            }
+            const LevelController::Output& out = leveler.update(now, pitch, roll, attitude_us, joints);
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                motors.setVelocity(i, out.motor_rad_s[i]);
+            }
+            motors.cycle();
+            CanFrame frame_in;
+            while (can.receive(&frame_in)) {
+            }
+        }
+        // The actuators follow the motors' actual speed
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            float rad_s = can.getMotor(MOTOR_IDS[i])->getVelocity() * DIRECTIONS[i];
+            frame.setVelocity(i, rad_s * ACTUATOR_MM_PER_RAD);
+        }
+
+        FrameSim::Angles truth = frame.getAngles();
+        float true_roll = (truth.front_roll_deg + truth.rear_roll_deg) * 0.5f;
+        if (truth.pitch_deg * initial.pitch_deg < 0) {
+            true_overshoot = fmaxf(true_overshoot, fabsf(truth.pitch_deg));
+        }
+        if (true_roll * initial_roll < 0) {
+            true_overshoot = fmaxf(true_overshoot, fabsf(true_roll));
+        }
+        bool disabled = true;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            disabled = disabled && !can.getMotor(MOTOR_IDS[i])->isEnabled();
+        }
+        if (!leveler.isActive() && now > start_us && disabled && !frame.isMoving()) {
+            break;
+        }
+    }
+
+    FrameSim::Angles final_angles = frame.getAngles();
+    float final_roll = (final_angles.front_roll_deg + final_angles.rear_roll_deg) * 0.5f;
+    const LevelController::Metrics& metrics = leveler.getMetrics();
+    printf("  %s: pitch %+.2f -> %+.3f deg, roll %+.2f -> %+.3f deg (true)\n",
+           LevelController::stateName(leveler.getState()), initial.pitch_deg, final_angles.pitch_deg, initial_roll,
+           final_roll);
+    printf("  time to level %.1f s, done after %.1f s, overshoot %.3f deg (true %.3f), %u/%u updates saturated\n",
+           metrics.time_to_level_us * 1e-6f, metrics.duration_us * 1e-6f, metrics.overshoot_deg, true_overshoot,
+           metrics.saturated_updates, metrics.updates);
+
+    check(leveler.getState() == scenario.expected, "ends in the expected state");
+    if (scenario.expected == LevelController::State::SETTLED) {
+        // Settled on the estimate; truth may differ by sensor noise
+        float margin = LEVEL_TOLERANCE_DEG + 0.05f;
+        check(fabsf(final_angles.pitch_deg) < margin && fabsf(final_roll) < margin, "frame level within tolerance");
+        check(true_overshoot < 2 * LEVEL_TOLERANCE_DEG, "overshoot within twice the tolerance");
+    }
+    bool stopped = true;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        stopped = stopped && !can.getMotor(MOTOR_IDS[i])->isEnabled();
+    }
+    check(stopped, "motors disabled at the end");
+    bool within = true;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        // Corners that started inside the limit stay there (the stop takes a ramp)
+        within = within && (scenario.heights_mm[i] > scenario.max_height_mm ||
+                            frame.getHeight(i) <= scenario.max_height_mm + 1.0f);
+    }
+    check(within, "no corner driven past its limit");
+}
+
+int main() {
+    for (const Scenario& scenario : SCENARIOS) {
+        run(scenario);
+    }
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
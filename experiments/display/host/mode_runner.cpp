@@ -0,0 +1,101 @@
+// Checks the mode state machine's precomputed tables against the behaviour
+// the buttons are meant to have: every (mode, event) -> (action, next mode)
+// row, with and without the dev flag, and the order MODE_PRESS walks the
+// modes in (dev modes only when the dev flag is set).
+#include <cstdio>
+#include "config.hpp"
+#include "mode_state_machine.hpp"
+
+using M = OperationMode;
+using A = ModeAction;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// Expected actions, indexed by [OperationMode][ModeEvent] like MODE_ACTIONS:
+// UP_PRESS, UP_RELEASE, MODE_PRESS, DOWN_PRESS, DOWN_RELEASE
+static const A EXPECTED_ACTIONS[MODE_COUNT][MODE_EVENT_COUNT] = {
+    /* UP_DOWN */ {A::MOVE_UP, A::MOVE_STOP, A::CYCLE_MODE, A::MOVE_DOWN, A::MOVE_STOP},
+    /* ROLL    */ {A::ADJUST_INCREASE, A::NONE, A::CYCLE_MODE, A::ADJUST_DECREASE, A::NONE},
+    /* PITCH   */ {A::ADJUST_INCREASE, A::NONE, A::CYCLE_MODE, A::ADJUST_DECREASE, A::NONE},
+    /* TORSION */ {A::ADJUST_INCREASE, A::NONE, A::CYCLE_MODE, A::ADJUST_DECREASE, A::NONE},
+    /* LEVEL   */ {A::LEVEL_START, A::NONE, A::CYCLE_MODE, A::CALIBRATE_HOLD, A::CALIBRATE},
+    /* MOTOR_1 */ {A::MOTOR_FORWARD, A::MOVE_STOP, A::CYCLE_MODE, A::MOTOR_REVERSE, A::MOVE_STOP},
+    /* MOTOR_2 */ {A::MOTOR_FORWARD, A::MOVE_STOP, A::CYCLE_MODE, A::MOTOR_REVERSE, A::MOVE_STOP},
+    /* MOTOR_3 */ {A::MOTOR_FORWARD, A::MOVE_STOP, A::CYCLE_MODE, A::MOTOR_REVERSE, A::MOVE_STOP},
+    /* MOTOR_4 */ {A::MOTOR_FORWARD, A::MOVE_STOP, A::CYCLE_MODE, A::MOTOR_REVERSE, A::MOVE_STOP},
+};
+
+static const M NORMAL_CYCLE[] = {M::UP_DOWN, M::ROLL, M::PITCH, M::TORSION, M::LEVEL, M::UP_DOWN};
+static const M DEV_CYCLE[] = {M::UP_DOWN, M::ROLL,    M::PITCH,   M::TORSION, M::LEVEL,
+                              M::MOTOR_1, M::MOTOR_2, M::MOTOR_3, M::MOTOR_4, M::UP_DOWN};
+
+static void rows(bool dev_flag) {
+    printf("transitions, dev flag %s\n", dev_flag ? "on" : "off");
+    int wrong = 0;
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        for (int event = 0; event < MODE_EVENT_COUNT; event++) {
+            const ModeTransition& transition = mode_transition(dev_flag, (M)mode, (ModeEvent)event);
+            bool ok = transition.action == EXPECTED_ACTIONS[mode][event];
+            if (event != (int)ModeEvent::MODE_PRESS) {
+                ok = ok && transition.next == (M)mode;
+            }
+            if (!ok) {
+                printf("  %s, event %d: action %d, next %d\n", MODE_CONFIGS[mode].name, event,
+                       (int)transition.action, (int)transition.next);
+                wrong++;
+            }
+        }
+    }
+    check(wrong == 0, "every (mode, event) row as expected");
+}
+
+// Follow MODE_PRESS from UP_DOWN and compare each step with the expected order
+static void cycle(bool dev_flag, const M* expected, int length) {
+    printf("mode cycle, dev flag %s\n ", dev_flag ? "on" : "off");
+    bool ok = true;
+    M mode = expected[0];
+    printf(" %s", MODE_CONFIGS[(int)mode].name);
+    for (int step = 1; step < length; step++) {
+        mode = mode_transition(dev_flag, mode, ModeEvent::MODE_PRESS).next;
+        printf(" -> %s", MODE_CONFIGS[(int)mode].name);
+        ok = ok && mode == expected[step];
+    }
+    printf("\n");
+    check(ok, dev_flag ? "visits every mode in order" : "visits the normal modes in order");
+
+    // Every mode, not just those on the walk, moves to its successor
+    bool successors = true;
+    for (int mode_index = 0; mode_index < MODE_COUNT; mode_index++) {
+        bool available = dev_flag || !MODE_CONFIGS[mode_index].dev_only;
+        if (!available) {
+            continue;
+        }
+        M next = mode_transition(dev_flag, (M)mode_index, ModeEvent::MODE_PRESS).next;
+        for (int step = 0; step + 1 < length; step++) {
+            if (expected[step] == (M)mode_index) {
+                successors = successors && next == expected[step + 1];
+            }
+        }
+        successors = successors && (dev_flag || !MODE_CONFIGS[(int)next].dev_only);
+    }
+    check(successors, dev_flag ? "dev modes reachable" : "no dev mode without the flag");
+}
+
+int main() {
+    rows(false);
+    rows(true);
+    cycle(false, NORMAL_CYCLE, sizeof(NORMAL_CYCLE) / sizeof(NORMAL_CYCLE[0]));
+    cycle(true, DEV_CYCLE, sizeof(DEV_CYCLE) / sizeof(DEV_CYCLE[0]));
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Drives the firmware's MotorController against VirtualCanBus: an Up/Down move,
+// a single-motor move and a start under a constrained TX queue, reporting
+// frames per cycle and where each motor ended up.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "motor_controller.hpp"
+#include "motor_state_cache.hpp"
+#include "virtual_can_bus.hpp"
+
+static constexpr int MOTOR_COUNT = 4;
+static constexpr int CYCLE_MS = 20;
+static const uint8_t MOTOR_IDS[MOTOR_COUNT] = {1, 2, 3, 4};
+
+struct Rig {
+    VirtualCanBus bus;
+    MotorController controller;
+    MotorStateCache states;
+    int64_t now_us;
+
+    explicit Rig(uint32_t tx_queue_len)
+        : bus({
+              .bitrate = 1000000,
+              .tx_queue_len = tx_queue_len,
+              .rx_queue_len = 64,
+              .response_latency_us = 200,
+              .error_rate = 0.0f,
+              .seed = 1,
+          }),
+          controller({
+              .master_id = 0,
+              .motor_count = MOTOR_COUNT,
+              .motor_ids = {1, 2, 3, 4},
+              .directions = {1, -1, 1, -1},
+              .current_limit_a = 5.0f,
+              .stop_cycles = 3,
+              .transmit = [this](const CanFrame* frames, int count) { return bus.transmit(frames, count); },
+          }),
+          now_us(0) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            bus.addMotor(CyberGearModel::defaults(MOTOR_IDS[i]));
+        }
+    }
+
+    // Run cycles for duration_ms; returns the most frames sent in one cycle
+    int run(int duration_ms) {
+        int max_frames = 0;
+        for (int t = 0; t < duration_ms; t += CYCLE_MS) {
+            now_us += CYCLE_MS * 1000;
+            bus.advance(now_us);
+            CanFrame frame;
+            while (bus.receive(&frame)) {
+                int motor;
+                MotorState state;
+                if (controller.decode(frame, now_us, &motor, &state)) {
+                    states.publish(motor, state);
+                }
+            }
+            int sent = controller.cycle();
+            max_frames = sent > max_frames ? sent : max_frames;
+        }
+        return max_frames;
+    }
+
+    void setAll(float rad_s) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            controller.setVelocity(i, rad_s);
+        }
+    }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static const char* phase_name(MotorController::Phase phase) {
+    switch (phase) {
+        case MotorController::Phase::DISABLED:
+            return "disabled";
+        case MotorController::Phase::RUNNING:
+            return "running";
+        case MotorController::Phase::STOPPING:
+            return "stopping";
+    }
+    return "?";
+}
+
+static void print_motors(const Rig& rig) {
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const CyberGearModel* motor = rig.bus.getMotor(MOTOR_IDS[i]);
+        MotorState state = {};
+        rig.states.read(i, &state);
+        printf("  motor %d: %-8s %s, position %+.3f rad (reported %+.3f), %u commands\n", i + 1,
+               phase_name(rig.controller.getPhase(i)), motor->isEnabled() ? "enabled " : "disabled",
+               motor->getPosition(), state.position, motor->getCommandCount());
+    }
+}
+
+int main() {
+    // Up/Down: all four start in one batch, run, then stop and disable
+    printf("Up/Down move, 1 s at 5 rad/s\n");
+    {
+        Rig rig(64);
+        rig.setAll(5.0f);
+        int start_frames = rig.run(CYCLE_MS);
+        int running_frames = rig.run(1000 - CYCLE_MS);
+        rig.setAll(0.0f);
+        rig.run(200);
+        MotorController::Stats stats = rig.controller.takeStats();
+        print_motors(rig);
+        printf("  %u cycles, %u frames\n", stats.cycles, stats.frames_sent);
+        check(start_frames == MOTOR_COUNT * MotorController::START_FRAMES, "start batch carries every motor's sequence");
+        check(running_frames == MOTOR_COUNT, "one speed reference per motor per cycle");
+        bool all_moved = true;
+        bool all_disabled = true;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            const CyberGearModel* motor = rig.bus.getMotor(MOTOR_IDS[i]);
+            float expected = 5.0f * (i % 2 ? -1.0f : 1.0f);
+            all_moved = all_moved && fabsf(motor->getPosition() - expected) < 0.15f;
+            MotorState state = {};
+            all_moved = all_moved && rig.states.read(i, &state) && fabsf(state.position - 5.0f) < 0.15f;
+            all_disabled = all_disabled && !motor->isEnabled() &&
+                           rig.controller.getPhase(i) == MotorController::Phase::DISABLED;
+        }
+        check(all_moved, "each motor turned 5 rad (mirrored motors reversed)");
+        check(all_disabled, "all motors disabled after the stop cycles");
+    }
+
+    // Motor 3 alone
+    printf("Motor 3 reverse, 0.5 s\n");
+    {
+        Rig rig(64);
+        rig.controller.setVelocity(2, -5.0f);
+        rig.run(500);
+        rig.controller.setVelocity(2, 0.0f);
+        rig.run(200);
+        print_motors(rig);
+        bool others_idle = true;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            others_idle = others_idle && (i == 2 || rig.bus.getMotor(MOTOR_IDS[i])->getCommandCount() == 0);
+        }
+        check(others_idle, "other motors receive no frames");
+        check(rig.bus.getMotor(3)->getPosition() < -2.3f, "motor 3 moved");
+    }
+
+    // TX queue that takes 8 frames per cycle: starts complete over several cycles
+    printf("Start with an 8-frame TX queue\n");
+    {
+        Rig rig(8);
+        rig.setAll(5.0f);
+        rig.run(200);
+        MotorController::Stats stats = rig.controller.takeStats();
+        print_motors(rig);
+        printf("  %u frames sent, %u refused\n", stats.frames_sent, stats.frames_dropped);
+        bool all_enabled = true;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            all_enabled = all_enabled && rig.bus.getMotor(MOTOR_IDS[i])->isEnabled();
+        }
+        check(all_enabled, "every motor eventually enabled");
+        check(stats.frames_dropped > 0, "refused frames counted");
+    }
+
+    // Seqlock under contention: a reader must never see a half-written state
+    printf("State cache, writer vs reader threads\n");
+    {
+        MotorStateCache cache;
+        std::atomic<bool> done{false};
+        uint32_t torn = 0;
+        uint32_t reads = 0;
+        std::thread reader([&]() {
+            MotorState state;
+            while (!done.load()) {
+                if (cache.read(0, &state)) {
+                    reads++;
+                    torn += state.position != state.velocity || state.position != state.torque ||
+                            (float)state.timestamp_us != state.position;
+                }
+            }
+        });
+        // Writes paced like feedback (gaps between publishes), but far faster
+        for (int i = 1; i <= 200000; i++) {
+            for (volatile int spin = 0; spin < 200; spin++) {
+            }
+            MotorState state = {};
+            state.position = state.velocity = state.torque = (float)i;
+            state.timestamp_us = i;
+            cache.publish(0, state);
+        }
+        done = true;
+        reader.join();
+        printf("  %u reads, %u retries\n", reads, cache.getReadRetries());
+        check(torn == 0, "no torn reads");
+    }
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
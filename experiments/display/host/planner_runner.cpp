@@ -0,0 +1,207 @@
+// Exercises the firmware's TrajectoryPlanner: a synchronized four-axis move,
+// release and reverse mid-move, limit checks along every trajectory and the
+// time one plan() takes on this machine.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "trajectory_planner.hpp"
+
+static constexpr int AXES = 4;
+static constexpr float MAX_VELOCITY = 5.0f;
+static constexpr float MAX_ACCELERATION = 20.0f;
+static constexpr int64_t STEP_US = 1000;
+
+static TrajectoryPlanner::Config planner_config() {
+    TrajectoryPlanner::Config config = {};
+    config.axis_count = AXES;
+    for (int i = 0; i < AXES; i++) {
+        config.max_velocity[i] = MAX_VELOCITY;
+        config.max_acceleration[i] = MAX_ACCELERATION;
+    }
+    return config;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+// Trajectory extremes seen while stepping the planner
+struct Trace {
+    float max_velocity = 0;
+    float max_acceleration = 0;
+    float max_ratio_error = 0;  // Largest deviation from the straight line
+    int64_t done_us = -1;
+    TrajectoryPlanner::Setpoint last = {};
+    bool has_last = false;
+
+    // Steps until end_us, checking each axis against the line through
+    // start and targets
+    void run(const TrajectoryPlanner& planner, int64_t from_us, int64_t end_us, const float* start,
+             const float* targets) {
+        for (int64_t t = from_us; t <= end_us; t += STEP_US) {
+            TrajectoryPlanner::Setpoint sp;
+            planner.sample(t, &sp);
+            for (int i = 0; i < AXES; i++) {
+                max_velocity = fmaxf(max_velocity, fabsf(sp.velocity[i]));
+                if (has_last) {
+                    float accel = (sp.velocity[i] - last.velocity[i]) / (STEP_US * 1e-6f);
+                    max_acceleration = fmaxf(max_acceleration, fabsf(accel));
+                }
+            }
+            if (start && targets) {
+                // Progress of each axis along its own leg must match axis 0
+                float s0 = (sp.position[0] - start[0]) / (targets[0] - start[0]);
+                for (int i = 1; i < AXES; i++) {
+                    float si = (sp.position[i] - start[i]) / (targets[i] - start[i]);
+                    max_ratio_error = fmaxf(max_ratio_error, fabsf(si - s0));
+                }
+            }
+            if (sp.done && done_us < 0) {
+                done_us = t;
+            }
+            last = sp;
+            has_last = true;
+        }
+    }
+};
+
+int main() {
+    // Level a frame: each corner a different distance, one reversed
+    printf("Synchronized move from rest\n");
+    {
+        TrajectoryPlanner planner(planner_config());
+        float start[AXES] = {0, 0, 0, 0};
+        float targets[AXES] = {10.0f, 4.0f, -2.0f, 7.5f};
+        planner.reset(start);
+        planner.plan(0, targets);
+        Trace trace;
+        trace.run(planner, 0, 3000000, start, targets);
+        printf("  duration %.3f s, peak %.2f rad/s, peak %.1f rad/s^2\n", planner.getDuration(),
+               trace.max_velocity, trace.max_acceleration);
+        bool arrived = true;
+        for (int i = 0; i < AXES; i++) {
+            arrived = arrived && trace.last.position[i] == targets[i] && trace.last.velocity[i] == 0;
+        }
+        // Longest leg at limits: 10 rad, 5 rad/s, 20 rad/s^2 -> 2.25 s
+        check(fabsf(planner.getDuration() - 2.25f) < 1e-3f, "time set by the longest axis");
+        check(arrived, "all axes end on target at rest");
+        check(trace.max_ratio_error < 1e-4f, "axes stay on one line (no racking)");
+        check(trace.max_velocity <= MAX_VELOCITY * 1.001f, "velocity limit held");
+        check(trace.max_acceleration <= MAX_ACCELERATION * 1.01f, "acceleration limit held");
+    }
+
+    // Up/Down held, then released while cruising
+    printf("Release mid-move\n");
+    {
+        TrajectoryPlanner planner(planner_config());
+        float start[AXES] = {1.0f, 2.0f, 3.0f, 4.0f};
+        float targets[AXES];
+        for (int i = 0; i < AXES; i++) {
+            targets[i] = start[i] + 100.0f;
+        }
+        planner.reset(start);
+        planner.plan(0, targets);
+        Trace trace;
+        trace.run(planner, 0, 1000000, start, targets);
+        float released_velocity = trace.last.velocity[0];
+        planner.stop(1000000);
+        trace.run(planner, 1000000 + STEP_US, 2000000, nullptr, nullptr);
+        printf("  released at %.2f rad/s, stopped %.3f s later at %+.3f rad\n", released_velocity,
+               (trace.done_us - 1000000) * 1e-6f, trace.last.position[0]);
+        check(fabsf(released_velocity - MAX_VELOCITY) < 1e-3f, "cruising when released");
+        check(trace.max_acceleration <= MAX_ACCELERATION * 1.01f, "no velocity step at release");
+        check(fabsf((trace.done_us - 1000000) * 1e-6f - MAX_VELOCITY / MAX_ACCELERATION) < 2e-3f,
+              "stops in v / a");
+        bool level = true;
+        for (int i = 1; i < AXES; i++) {
+            level = level && fabsf((trace.last.position[i] - start[i]) - (trace.last.position[0] - start[0])) < 1e-4f;
+        }
+        check(level, "corners stop together");
+    }
+
+    // Reverse while moving: brake through zero, then run the other way
+    printf("Reverse mid-move\n");
+    {
+        TrajectoryPlanner planner(planner_config());
+        float start[AXES] = {0, 0, 0, 0};
+        float up[AXES] = {100.0f, 100.0f, 100.0f, 100.0f};
+        float down[AXES] = {-100.0f, -100.0f, -100.0f, -100.0f};
+        planner.reset(start);
+        planner.plan(0, up);
+        Trace trace;
+        trace.run(planner, 0, 500000, nullptr, nullptr);
+        planner.plan(500000, down);
+        int64_t zero_crossing_us = -1;
+        float previous = trace.last.velocity[0];
+        for (int64_t t = 500000 + STEP_US; t <= 1500000; t += STEP_US) {
+            TrajectoryPlanner::Setpoint sp;
+            planner.sample(t, &sp);
+            if (previous > 0 && sp.velocity[0] <= 0 && zero_crossing_us < 0) {
+                zero_crossing_us = t;
+            }
+            previous = sp.velocity[0];
+        }
+        trace.run(planner, 500000 + STEP_US, 1500000, nullptr, nullptr);
+        printf("  turned around %.3f s after reversing, %.2f rad/s after 1 s\n", (zero_crossing_us - 500000) * 1e-6f,
+               trace.last.velocity[0]);
+        check(trace.max_acceleration <= MAX_ACCELERATION * 1.01f, "no velocity step at reversal");
+        check(zero_crossing_us > 0 && fabsf((zero_crossing_us - 500000) * 1e-6f - 0.25f) < 2e-3f,
+              "brakes at full deceleration");
+        check(fabsf(trace.last.velocity[0] + MAX_VELOCITY) < 1e-3f, "cruising the other way");
+    }
+
+    // Replans at the firmware cycle rate to random points on one line
+    // through the frame's corners (so velocity carries over exactly)
+    printf("Plan time\n");
+    {
+        TrajectoryPlanner planner(planner_config());
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> target(-50.0f, 50.0f);
+        const float direction[AXES] = {1.0f, 0.4f, -0.2f, 0.75f};
+        float start[AXES] = {0, 0, 0, 0};
+        planner.reset(start);
+        const int plans = 200000;
+        std::vector<double> plan_ns(plans);
+        auto begin = std::chrono::steady_clock::now();
+        Trace trace;
+        for (int n = 0; n < plans; n++) {
+            float targets[AXES];
+            float distance = target(rng);
+            for (int i = 0; i < AXES; i++) {
+                targets[i] = direction[i] * distance;
+            }
+            int64_t now = n * 20000LL;
+            auto t0 = std::chrono::steady_clock::now();
+            if (n % 7 == 3) {
+                planner.stop(now);
+            } else {
+                planner.plan(now, targets);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            plan_ns[n] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+            if (n < 2000) {
+                trace.run(planner, now + STEP_US, now + 20000, nullptr, nullptr);
+            }
+        }
+        double total_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        std::sort(plan_ns.begin(), plan_ns.end());
+        double p999_ns = plan_ns[plans - plans / 1000];
+        printf("  %d plans, %.0f ns mean, %.0f ns p99.9, %.0f ns worst (includes timer noise)\n", plans,
+               total_ns / plans, p999_ns, plan_ns[plans - 1]);
+        check(p999_ns < TrajectoryPlanner::HOST_PLAN_BOUND_NS, "p99.9 plan time within the stated bound");
+        check(trace.max_velocity <= MAX_VELOCITY * 1.001f, "velocity limit held across random replans");
+        // Legs of a fraction of a millimetre lose a little direction to float
+        // rounding, so the carried-over velocity can be off by ~0.1%
+        printf("  peak %.1f rad/s^2\n", trace.max_acceleration);
+        check(trace.max_acceleration <= MAX_ACCELERATION * 1.1f, "acceleration limit held across random replans");
+    }
+
+    printf(failures ? "%d check(s) failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,322 @@
+// Runs CanScheduler on VirtualCanBus: coalescing of unsent setpoints,
+// priority order through a short TX queue, start sequences kept in order,
+// status polling of idle motors (and none for moving ones), deadline
+// misses, and MotorController on an overloaded bus with and without the
+// scheduler in between.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "can_scheduler.hpp"
+#include "config.hpp"
+#include "motor_controller.hpp"
+#include "pins.hpp"
+#include "virtual_can_bus.hpp"
+
+using cybergear::CommType;
+
+static const uint8_t MOTOR_IDS[MOTOR_COUNT] = MOTOR_CAN_IDS;
+static const int8_t DIRECTIONS[MOTOR_COUNT] = MOTOR_DIRECTIONS;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static VirtualCanBus::Config bus_config(uint32_t bitrate, uint32_t tx_queue_len) {
+    return {
+        .bitrate = bitrate,
+        .tx_queue_len = tx_queue_len,
+        .rx_queue_len = CAN_RX_QUEUE_LEN,
+        .response_latency_us = 200,
+        .error_rate = 0.0f,
+        .seed = 3,
+    };
+}
+
+static void add_motors(VirtualCanBus* bus) {
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        bus->addMotor(CyberGearModel::defaults(MOTOR_IDS[i]));
+    }
+}
+
+// The firmware's scheduler settings on a bus, with room capped at in_flight
+static CanScheduler::Config scheduler_config(VirtualCanBus* bus, int in_flight) {
+    return {
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .setpoint_deadline_us = CAN_SETPOINT_DEADLINE_MS * 1000,
+        .status_period_us = CAN_STATUS_PERIOD_MS * 1000,
+        .status_deadline_us = CAN_STATUS_DEADLINE_MS * 1000,
+        .transmit = [bus](const CanFrame* frames, int count) { return bus->transmit(frames, count); },
+        .free_slots = [bus, in_flight]() { return in_flight - (int)bus->getStatus().msgs_to_tx; },
+    };
+}
+
+static void drain(VirtualCanBus* bus) {
+    CanFrame frame;
+    while (bus->receive(&frame)) {
+    }
+}
+
+static float spd_ref(const CanFrame& frame) {
+    float value;
+    memcpy(&value, &frame.data[4], sizeof(value));
+    return value;
+}
+
+static bool is_spd_ref(const CanFrame& frame) {
+    return cybergear::comm_type(frame) == CommType::WRITE_PARAM &&
+           (frame.data[0] | (frame.data[1] << 8)) == cybergear::PARAM_SPD_REF;
+}
+
+static void coalescing() {
+    printf("coalescing: three setpoints per motor before a flush\n");
+    VirtualCanBus bus(bus_config(CAN_BITRATE, CAN_TX_QUEUE_LEN));
+    add_motors(&bus);
+    CanScheduler scheduler(scheduler_config(&bus, CAN_TX_IN_FLIGHT));
+
+    for (int round = 1; round <= 3; round++) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            CanFrame frame;
+            cybergear::encode_write_float(&frame, MOTOR_CAN_MASTER_ID, MOTOR_IDS[i], cybergear::PARAM_SPD_REF,
+                                          round + 0.1f * i);
+            scheduler.submit(&frame, 1);
+        }
+    }
+    int sent = scheduler.flush(0);
+    bus.advance(5000);
+    bool latest = bus.getSent().size() == MOTOR_COUNT;
+    for (const CanFrame& frame : bus.getSent()) {
+        int motor = (frame.id & 0xFF) - MOTOR_IDS[0];
+        latest = latest && is_spd_ref(frame) && fabsf(spd_ref(frame) - (3 + 0.1f * motor)) < 1e-6f;
+    }
+    CanScheduler::Stats stats = scheduler.takeStats();
+    printf("  %d sent, %lu replaced\n", sent, (unsigned long)stats.setpoints_replaced);
+    check(latest, "only the latest setpoint per motor goes out");
+    check(stats.setpoints_replaced == 2 * MOTOR_COUNT, "older ones counted as replaced");
+
+    // A stop cancels the setpoint submitted before it
+    CanFrame frames[2];
+    cybergear::encode_write_float(&frames[0], MOTOR_CAN_MASTER_ID, MOTOR_IDS[0], cybergear::PARAM_SPD_REF, 5.0f);
+    cybergear::encode_stop(&frames[1], MOTOR_CAN_MASTER_ID, MOTOR_IDS[0], false);
+    bus.clearSent();
+    scheduler.submit(frames, 2);
+    scheduler.flush(20000);
+    bus.advance(25000);
+    check(bus.getSent().size() == 1 && cybergear::comm_type(bus.getSent()[0]) == CommType::STOP,
+          "stop drops the setpoint queued before it");
+}
+
+static void priority() {
+    printf("priority: two free TX slots per flush\n");
+    VirtualCanBus bus(bus_config(CAN_BITRATE, CAN_TX_QUEUE_LEN));
+    add_motors(&bus);
+    CanScheduler scheduler(scheduler_config(&bus, 2));
+    scheduler.flush(0);  // Starts the status clocks
+
+    // Status falls due for all four while a setpoint and a stop are queued
+    int64_t now = CAN_STATUS_PERIOD_MS * 1000;
+    CanFrame frames[2];
+    cybergear::encode_write_float(&frames[0], MOTOR_CAN_MASTER_ID, MOTOR_IDS[0], cybergear::PARAM_SPD_REF, 1.0f);
+    cybergear::encode_stop(&frames[1], MOTOR_CAN_MASTER_ID, MOTOR_IDS[2], false);
+    scheduler.submit(frames, 2);
+    scheduler.flush(now);
+    bus.advance(now + 5000);
+    const std::vector<CanFrame>& sent = bus.getSent();
+    check(sent.size() == 2 && cybergear::comm_type(sent[0]) == CommType::STOP && is_spd_ref(sent[1]),
+          "control first, then the setpoint");
+    check(scheduler.getBacklog() == MOTOR_COUNT, "status requests wait");
+
+    // Motors 1 and 3 have answered since; only 2 and 4 still need polling
+    bus.clearSent();
+    now += MOTOR_CYCLE_MS * 1000;
+    scheduler.flush(now);
+    bus.advance(now + 5000);
+    drain(&bus);
+    CanScheduler::Stats stats = scheduler.takeStats();
+    bool polled = sent.size() == 2;
+    for (const CanFrame& frame : sent) {
+        uint8_t id = frame.id & 0xFF;
+        polled = polled && cybergear::comm_type(frame) == CommType::FEEDBACK &&
+                 (id == MOTOR_IDS[1] || id == MOTOR_IDS[3]);
+    }
+    check(polled, "status requests only where no command went");
+    check(stats.status_redundant == 2 && stats.status_sent == 2, "two redundant, two sent");
+
+    // Start sequence at two frames per flush: the setpoint waits its turn
+    bus.clearSent();
+    MotorController motors({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = 1,
+        .motor_ids = {MOTOR_IDS[1]},
+        .directions = {1},
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&scheduler](const CanFrame* frames, int count) { return scheduler.submit(frames, count); },
+    });
+    motors.setVelocity(0, 2.0f);
+    for (int cycle = 0; cycle < 4; cycle++) {
+        now += MOTOR_CYCLE_MS * 1000;
+        motors.cycle();
+        scheduler.flush(now);
+        bus.advance(now + 5000);
+        drain(&bus);
+    }
+    const CommType order[] = {CommType::STOP, CommType::WRITE_PARAM, CommType::WRITE_PARAM, CommType::ENABLE,
+                              CommType::WRITE_PARAM};
+    bool in_order = sent.size() >= 5;
+    for (int n = 0; in_order && n < 5; n++) {
+        in_order = cybergear::comm_type(sent[n]) == order[n];
+    }
+    check(in_order && is_spd_ref(sent[4]), "start sequence keeps its order");
+    check(bus.getMotor(MOTOR_IDS[1])->isEnabled(), "motor running");
+}
+
+static void polling() {
+    printf("polling: 2 s idle, then 2 s moving\n");
+    VirtualCanBus bus(bus_config(CAN_BITRATE, CAN_TX_QUEUE_LEN));
+    add_motors(&bus);
+    CanScheduler scheduler(scheduler_config(&bus, CAN_TX_IN_FLIGHT));
+    MotorController motors({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&scheduler](const CanFrame* frames, int count) { return scheduler.submit(frames, count); },
+    });
+
+    int64_t last_feedback[MOTOR_COUNT] = {};
+    int64_t worst_age[2] = {};
+    CanScheduler::Stats stats[2];
+    for (int phase = 0; phase < 2; phase++) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            motors.setVelocity(i, phase ? 2.0f : 0.0f);
+        }
+        int64_t start = phase * 2000000;
+        for (int64_t now = start + 1000; now <= start + 2000000; now += 1000) {
+            bus.advance(now);
+            CanFrame frame;
+            while (bus.receive(&frame)) {
+                int motor;
+                MotorState state;
+                if (motors.decode(frame, now, &motor, &state)) {
+                    last_feedback[motor] = now;
+                }
+            }
+            if (now % (MOTOR_CYCLE_MS * 1000) == 0) {
+                motors.cycle();
+                scheduler.flush(now);
+            }
+            // Past the first period, every motor answers in time
+            if (now - start > 200000) {
+                for (int i = 0; i < MOTOR_COUNT; i++) {
+                    worst_age[phase] = std::max(worst_age[phase], now - last_feedback[i]);
+                }
+            }
+        }
+        stats[phase] = scheduler.takeStats();
+        printf("  %s: %lu status requests (%lu redundant), %lu setpoints, %lu misses, feedback %lld ms old at most\n",
+               phase ? "moving" : "idle", (unsigned long)stats[phase].status_sent,
+               (unsigned long)stats[phase].status_redundant, (unsigned long)stats[phase].setpoints_sent,
+               (unsigned long)stats[phase].deadline_misses, (long long)worst_age[phase] / 1000);
+    }
+    int expected = MOTOR_COUNT * 2000 / CAN_STATUS_PERIOD_MS;
+    check(abs((int)stats[0].status_sent - expected) <= MOTOR_COUNT, "idle motors polled every period");
+    check(worst_age[0] <= (CAN_STATUS_PERIOD_MS + 2 * MOTOR_CYCLE_MS) * 1000, "idle feedback within a period");
+    check(stats[1].status_sent <= MOTOR_COUNT && stats[1].status_redundant > 0, "moving motors not polled");
+    check(worst_age[1] <= 2 * MOTOR_CYCLE_MS * 1000, "moving feedback every cycle");
+    check(stats[0].deadline_misses == 0 && stats[1].deadline_misses == 0, "no deadline misses");
+}
+
+struct Overload {
+    int64_t reach_us;          // Speed step -> every motor at the new speed
+    uint32_t dropped;          // Frames MotorController saw refused
+    CanScheduler::Stats stats;
+};
+
+// MotorController at 20 ms on a bus too slow for four motors' commands and
+// replies, straight to the driver or through the scheduler
+static Overload overload(bool scheduled) {
+    VirtualCanBus bus(bus_config(40000, CAN_TX_QUEUE_LEN));
+    add_motors(&bus);
+    CanScheduler scheduler(scheduler_config(&bus, CAN_TX_IN_FLIGHT));
+    MotorController motors({
+        .master_id = MOTOR_CAN_MASTER_ID,
+        .motor_count = MOTOR_COUNT,
+        .motor_ids = MOTOR_CAN_IDS,
+        .directions = MOTOR_DIRECTIONS,
+        .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+        .stop_cycles = MOTOR_STOP_CYCLES,
+        .transmit = [&](const CanFrame* frames, int count) {
+            return scheduled ? scheduler.submit(frames, count) : bus.transmit(frames, count);
+        },
+    });
+
+    Overload result = {};
+    result.reach_us = -1;
+    const int64_t step_us = 3000000;
+    for (int64_t now = 1000; now < 6000000 && result.reach_us < 0; now += 1000) {
+        bus.advance(now);
+        drain(&bus);
+        if (now % (MOTOR_CYCLE_MS * 1000) == 0) {
+            // Slowly varying speeds, so every setpoint differs, then a step
+            float speed = now < step_us ? 2.0f + 0.5f * sinf(now * 1e-6f) : -3.0f;
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                motors.setVelocity(i, speed);
+            }
+            motors.cycle();
+            if (scheduled) {
+                scheduler.flush(now);
+            }
+        }
+        if (now > step_us) {
+            bool reached = true;
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                float velocity = bus.getMotor(MOTOR_IDS[i])->getVelocity() * DIRECTIONS[i];
+                reached = reached && fabsf(velocity + 3.0f) < 0.1f;
+            }
+            if (reached) {
+                result.reach_us = now - step_us;
+            }
+        }
+    }
+    result.dropped = motors.takeStats().frames_dropped;
+    result.stats = scheduler.takeStats();
+    return result;
+}
+
+int main() {
+    coalescing();
+    priority();
+    polling();
+
+    printf("overload: 40 kbit/s, four motors at %d ms\n", MOTOR_CYCLE_MS);
+    Overload direct = overload(false);
+    Overload scheduled = overload(true);
+    printf("  direct: step reached after %lld ms, %lu frames refused by the driver\n",
+           (long long)direct.reach_us / 1000, (unsigned long)direct.dropped);
+    printf("  scheduled: step reached after %lld ms, %lu setpoints (%lu replaced unsent), %lu misses, backlog %lu\n",
+           (long long)scheduled.reach_us / 1000, (unsigned long)scheduled.stats.setpoints_sent,
+           (unsigned long)scheduled.stats.setpoints_replaced, (unsigned long)scheduled.stats.deadline_misses,
+           (unsigned long)scheduled.stats.max_backlog);
+    check(scheduled.dropped == 0 && scheduled.stats.control_refused == 0, "nothing refused");
+    check(scheduled.stats.setpoints_replaced > 0, "stale setpoints replaced");
+    check(scheduled.stats.deadline_misses > 0, "deadline misses counted");
+    check(scheduled.reach_us >= 0 && (direct.reach_us < 0 || scheduled.reach_us < direct.reach_us),
+          "speed step reaches the motors sooner");
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "sim_i2c_bus.hpp"
+
+SimI2cBus::SimI2cBus(uint32_t seed)
+    : rng(seed), uniform(0.0f, 1.0f), bus_stuck(false), failed(false), stats() {}
+
+void SimI2cBus::addDevice(Adxl345Sim* device) {
+    devices.push_back(Device{device, I2cError::NONE, 0.0f, I2cError::NONE, 0, I2cError::NONE});
+}
+
+SimI2cBus::Device* SimI2cBus::find(uint8_t dev_addr) {
+    for (Device& device : devices) {
+        if (device.sim->getAddress() == dev_addr) {
+            return &device;
+        }
+    }
+    return nullptr;
+}
+
+// Decide whether a transfer goes through; records the error otherwise
+bool SimI2cBus::transfer(uint8_t dev_addr, Device** out) {
+    stats.transfers++;
+    Device* device = find(dev_addr);
+    *out = device;
+    if (!device) {
+        stats.errors++;
+        failed = true;
+        return false;
+    }
+
+    I2cError error = I2cError::NONE;
+    if (bus_stuck) {
+        error = I2cError::TIMEOUT;
+    } else if (device->burst_remaining > 0) {
+        device->burst_remaining--;
+        error = device->burst_error;
+    } else if (device->failure_rate > 0 && uniform(rng) < device->failure_rate) {
+        error = device->random_error;
+    }
+
+    if (error != I2cError::NONE) {
+        if (device->last_error == I2cError::NONE) {
+            device->last_error = error;
+        }
+        stats.errors++;
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool SimI2cBus::write(uint8_t dev_addr, const uint8_t* data, size_t len) {
+    Device* device;
+    return transfer(dev_addr, &device) && device->sim->write(data, len);
+}
+
+bool SimI2cBus::write_read(uint8_t dev_addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+    Device* device;
+    return transfer(dev_addr, &device) && device->sim->writeRead(wdata, wlen, rdata, rlen);
+}
+
+// Transfers complete synchronously; wait only reports the outcome
+bool SimI2cBus::wait() {
+    bool ok = !failed;
+    failed = false;
+    return ok;
+}
+
+I2cError SimI2cBus::takeError(uint8_t dev_addr) {
+    Device* device = find(dev_addr);
+    if (!device) {
+        return I2cError::NACK;
+    }
+    I2cError error = device->last_error;
+    device->last_error = I2cError::NONE;
+    return error;
+}
+
+bool SimI2cBus::recover() {
+    stats.recoveries++;
+    bus_stuck = false;
+    failed = false;
+    return true;
+}
+
+void SimI2cBus::setFailureRate(uint8_t dev_addr, I2cError error, float probability) {
+    Device* device = find(dev_addr);
+    if (device) {
+        device->random_error = error;
+        device->failure_rate = probability;
+    }
+}
+
+void SimI2cBus::failNext(uint8_t dev_addr, I2cError error, int count) {
+    Device* device = find(dev_addr);
+    if (device) {
+        device->burst_error = error;
+        device->burst_remaining = count;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "adxl345_sim.hpp"
+#include "i2c_health.hpp"
+
+// ============================================================================
+// SimI2cBus - Synchronous bus over simulated devices, with fault injection
+// ============================================================================
+// Mirrors I2cBus (write / write_read / wait / takeError / recover) so the
+// firmware's AccelSensor and health policy run unchanged against it.
+// Faults can be injected per device as a failure probability, a burst of
+// consecutive failures, or a stuck bus that only recover() clears.
+class SimI2cBus {
+public:
+    struct Stats {
+        uint32_t transfers;
+        uint32_t errors;
+        uint32_t recoveries;
+    };
+
+    explicit SimI2cBus(uint32_t seed = 1);
+
+    void addDevice(Adxl345Sim* device);
+
+    bool write(uint8_t dev_addr, const uint8_t* data, size_t len);
+    bool write_read(uint8_t dev_addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen);
+    bool wait();
+    I2cError takeError(uint8_t dev_addr);
+    bool recover();
+
+    // Fault injection
+    void setFailureRate(uint8_t dev_addr, I2cError error, float probability);
+    void failNext(uint8_t dev_addr, I2cError error, int count);
+    void setStuck(bool stuck) { bus_stuck = stuck; }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Device {
+        Adxl345Sim* sim;
+        I2cError random_error;
+        float failure_rate;
+        I2cError burst_error;
+        int burst_remaining;
+        I2cError last_error;
+    };
+
+    std::vector<Device> devices;
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+    bool bus_stuck;
+    bool failed;
+    Stats stats;
+
+    Device* find(uint8_t dev_addr);
+    bool transfer(uint8_t dev_addr, Device** device);
+};
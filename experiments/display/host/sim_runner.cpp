@@ -0,0 +1,305 @@
+// Runs the firmware's accelerometer pipeline (AccelSensor -> Decimator ->
+// attitude estimator) against the simulated frame and reports accuracy and
+// simulation speed.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "accel_sensor.hpp"
+#include "adxl345_sim.hpp"
+#include "attitude_estimator.hpp"
+#include "decimator.hpp"
+#include "fixed_attitude.hpp"
+#include "frame_sim.hpp"
+#include "sim_i2c_bus.hpp"
+
+// ============================================================================
+// Options
+// ============================================================================
+struct Options {
+    int rate_hz = 100;            // 100 (direct) or 400/800 (decimated to 100)
+    int repeat = 1;               // Scenario repetitions
+    float noise_ug = 290.0f;      // ADXL345 typical noise density
+    float vibration_hz = 47.0f;   // Motor harmonic (while moving)
+    float vibration_g = 0.05f;
+    float mount_roll_deg = 0.0f;  // Rear sensor mounting error
+    float cutoff_hz = 2.0f;       // Attitude low-pass
+    float fault_rate = 0.0f;      // Per-transfer NACK probability
+    bool fixed_point = true;
+    const char* csv_path = nullptr;
+};
+
+static void print_usage(const char* name) {
+    printf("Usage: %s [options]\n"
+           "  --rate HZ          sensor data rate: 100, 400 or 800 (default 100)\n"
+           "  --repeat N         run the scenario N times (default 1)\n"
+           "  --noise UG         noise density in ug/sqrt(Hz) (default 290)\n"
+           "  --vibration HZ G   motor harmonic while moving (default 47 0.05)\n"
+           "  --mount-roll DEG   rear sensor mounting roll error (default 0)\n"
+           "  --cutoff HZ        attitude filter bandwidth (default 2)\n"
+           "  --fault-rate P     per-transfer NACK probability (default 0)\n"
+           "  --float            use the float estimator instead of fixed-point\n"
+           "  --csv FILE         write truth and estimates per task period\n",
+           name);
+}
+
+static bool parse_options(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--rate") && has_value) {
+            options->rate_hz = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--repeat") && has_value) {
+            options->repeat = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--noise") && has_value) {
+            options->noise_ug = atof(argv[++i]);
+        } else if (!strcmp(arg, "--vibration") && i + 2 < argc) {
+            options->vibration_hz = atof(argv[++i]);
+            options->vibration_g = atof(argv[++i]);
+        } else if (!strcmp(arg, "--mount-roll") && has_value) {
+            options->mount_roll_deg = atof(argv[++i]);
+        } else if (!strcmp(arg, "--cutoff") && has_value) {
+            options->cutoff_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--fault-rate") && has_value) {
+            options->fault_rate = atof(argv[++i]);
+        } else if (!strcmp(arg, "--float")) {
+            options->fixed_point = false;
+        } else if (!strcmp(arg, "--csv") && has_value) {
+            options->csv_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options->rate_hz == 100 || options->rate_hz == 400 || options->rate_hz == 800;
+}
+
+// ============================================================================
+// Scenario
+// ============================================================================
+// Actuator velocity commands (mm/s) held for a duration
+struct Phase {
+    const char* name;
+    float duration_s;
+    float velocity[FrameSim::ACTUATOR_COUNT];   // FL, FR, RL, RR
+};
+
+static const Phase SCENARIO[] = {
+    {"level",      5.0f, {0, 0, 0, 0}},
+    {"raise head", 2.0f, {10, 10, 0, 0}},
+    {"hold",       4.0f, {0, 0, 0, 0}},
+    {"twist",      1.0f, {8, 0, 0, 0}},
+    {"hold",       4.0f, {0, 0, 0, 0}},
+    {"lower all",  2.0f, {-14, -10, 0, 0}},
+    {"hold",       4.0f, {0, 0, 0, 0}},
+};
+static constexpr int PHASE_COUNT = sizeof(SCENARIO) / sizeof(SCENARIO[0]);
+
+struct ErrorStats {
+    double sum_sq[3];     // pitch, roll, torsion
+    float max_abs[3];
+    int count;
+
+    void add(const float error[3]) {
+        for (int i = 0; i < 3; i++) {
+            sum_sq[i] += error[i] * error[i];
+            max_abs[i] = fabsf(error[i]) > max_abs[i] ? fabsf(error[i]) : max_abs[i];
+        }
+        count++;
+    }
+    float rms(int i) const { return count ? sqrtf(sum_sq[i] / count) : 0; }
+};
+
+static uint8_t rate_code(int rate_hz) {
+    return rate_hz == 800 ? adxl345::RATE_800_HZ : rate_hz == 400 ? adxl345::RATE_400_HZ : adxl345::RATE_100_HZ;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Frame: 2 m x 1.4 m, 300 mm stroke, starting at mid travel
+    FrameSim frame({
+        .length_mm = 2000.0f,
+        .width_mm = 1400.0f,
+        .travel_mm = 300.0f,
+        .max_accel_mm_s2 = 50.0f,
+        .harmonics = {
+            {options.vibration_hz, options.vibration_g, true},
+            {options.vibration_hz * 2.0f, options.vibration_g * 0.5f, true},
+        },
+    });
+    for (int i = 0; i < FrameSim::ACTUATOR_COUNT; i++) {
+        frame.setHeight(i, 150.0f);
+    }
+
+    Adxl345Sim front_sim({
+        .address = 0x1D,
+        .source = [&frame](int64_t t) { return frame.frontAcceleration(t); },
+        .mount_roll_deg = 0.0f,
+        .mount_pitch_deg = 0.0f,
+        .mount_yaw_deg = 0.0f,
+        .noise_ug_per_rt_hz = options.noise_ug,
+        .bias_g = {0, 0, 0},
+        .seed = 1,
+    });
+    Adxl345Sim rear_sim({
+        .address = 0x53,
+        .source = [&frame](int64_t t) { return frame.rearAcceleration(t); },
+        .mount_roll_deg = options.mount_roll_deg,
+        .mount_pitch_deg = 0.0f,
+        .mount_yaw_deg = 0.0f,
+        .noise_ug_per_rt_hz = options.noise_ug,
+        .bias_g = {0, 0, 0},
+        .seed = 2,
+    });
+
+    SimI2cBus bus;
+    bus.addDevice(&front_sim);
+    bus.addDevice(&rear_sim);
+
+    auto sensor_config = [&bus](uint8_t address) {
+        return AccelSensor::Config{
+            .device_address = address,
+            .write = [&bus](uint8_t addr, const uint8_t* data, size_t len) { return bus.write(addr, data, len); },
+            .write_read = [&bus](uint8_t addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+                return bus.write_read(addr, wdata, wlen, rdata, rlen);
+            },
+            .wait = [&bus]() { return bus.wait(); },
+        };
+    };
+    AccelSensor front(sensor_config(0x1D));
+    AccelSensor rear(sensor_config(0x53));
+
+    // Drain period keeps the FIFO below 32 entries at every rate
+    int factor = options.rate_hz / 100;
+    int64_t period_us = options.rate_hz == 100 ? 100000 : 30000;
+    uint8_t watermark = (uint8_t)(options.rate_hz * period_us / 1000000);
+    if (!front.init(rate_code(options.rate_hz), watermark, {}) || !rear.init(rate_code(options.rate_hz), watermark, {})) {
+        fprintf(stderr, "Sensor init failed\n");
+        return 1;
+    }
+    // Faults start after init (the firmware retries init through its probe)
+    bus.setFailureRate(0x1D, I2cError::NACK, options.fault_rate);
+    bus.setFailureRate(0x53, I2cError::NACK, options.fault_rate);
+
+    Decimator front_decimator;
+    Decimator rear_decimator;
+    const Decimator::Config decimator_config = {.factor = factor, .taps = 64, .cutoff = 0.25f};
+    front_decimator.init(decimator_config);
+    rear_decimator.init(decimator_config);
+
+    AttitudeEstimator float_estimator({.cutoff_hz = options.cutoff_hz});
+    FixedAttitudeEstimator fixed_estimator({.cutoff_hz = options.cutoff_hz});
+
+    FILE* csv = options.csv_path ? fopen(options.csv_path, "w") : nullptr;
+    if (csv) {
+        fprintf(csv, "t_s,phase,pitch,roll,torsion,est_pitch,est_roll,est_torsion\n");
+    }
+
+    ErrorStats phase_errors[PHASE_COUNT] = {};
+    ErrorStats total = {};
+    uint32_t dropped_blocks = 0;
+    int64_t now = 0;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < options.repeat; r++) {
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            const Phase& phase = SCENARIO[p];
+            for (int i = 0; i < FrameSim::ACTUATOR_COUNT; i++) {
+                frame.setVelocity(i, phase.velocity[i]);
+            }
+
+            int64_t phase_end = now + (int64_t)(phase.duration_s * 1e6f);
+            while (now < phase_end) {
+                now += period_us;
+
+                // Physics and sensors are advanced together, one sample
+                // period at a time, so samples see the frame as it moves
+                int64_t step = 1000000 / options.rate_hz;
+                for (int64_t t = frame.getTime() + step; t <= now; t += step) {
+                    frame.advance(t);
+                    front_sim.advance(t);
+                    rear_sim.advance(t);
+                }
+                frame.advance(now);
+
+                // Same stages as accelerometer_task
+                static AccelBlock front_raw, rear_raw, front_block, rear_block;
+                bool front_ok = front.requestStatus() && bus.wait() && front.requestEntries() && bus.wait();
+                bool rear_ok = rear.requestStatus() && bus.wait() && rear.requestEntries() && bus.wait();
+                front.collect(&front_raw, now);
+                rear.collect(&rear_raw, now);
+                if (!front_ok) {
+                    front_raw.count = 0;
+                    dropped_blocks++;
+                }
+                if (!rear_ok) {
+                    rear_raw.count = 0;
+                    dropped_blocks++;
+                }
+                front_decimator.process(front_raw, &front_block);
+                rear_decimator.process(rear_raw, &rear_block);
+                front_ok = front_ok && front_block.count > 0;
+                rear_ok = rear_ok && rear_block.count > 0;
+
+                float est[3];
+                if (options.fixed_point) {
+                    const FixedAttitudeEstimator::Attitude& att =
+                        fixed_estimator.update(front_block, front_ok, rear_block, rear_ok);
+                    est[0] = att.pitch_cdeg / 100.0f;
+                    est[1] = att.roll_cdeg / 100.0f;
+                    est[2] = att.torsion_cdeg / 100.0f;
+                } else {
+                    const AttitudeEstimator::Attitude& att =
+                        float_estimator.update(front_block, front_ok, rear_block, rear_ok);
+                    est[0] = att.pitch;
+                    est[1] = att.roll;
+                    est[2] = att.torsion;
+                }
+
+                FrameSim::Angles truth = frame.getAngles();
+                float roll = (truth.front_roll_deg + truth.rear_roll_deg) * 0.5f;
+                float error[3] = {est[0] - truth.pitch_deg, est[1] - roll, est[2] - truth.torsion_deg};
+                phase_errors[p].add(error);
+                total.add(error);
+
+                if (csv) {
+                    fprintf(csv, "%.3f,%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", now * 1e-6, phase.name,
+                            truth.pitch_deg, roll, truth.torsion_deg, est[0], est[1], est[2]);
+                }
+            }
+        }
+    }
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    if (csv) {
+        fclose(csv);
+    }
+
+    // ========================================================================
+    // Report
+    // ========================================================================
+    printf("Rate %d Hz (decimate x%d), %s estimator, cutoff %.1f Hz, noise %.0f ug/rtHz, "
+           "vibration %.0f Hz %.3f g\n",
+           options.rate_hz, factor, options.fixed_point ? "fixed-point" : "float", options.cutoff_hz,
+           options.noise_ug, options.vibration_hz, options.vibration_g);
+    printf("%-12s %10s %10s %10s %10s\n", "phase", "pitch rms", "roll rms", "tors rms", "pitch max");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        printf("%-12s %10.3f %10.3f %10.3f %10.3f\n", SCENARIO[p].name, phase_errors[p].rms(0),
+               phase_errors[p].rms(1), phase_errors[p].rms(2), phase_errors[p].max_abs[0]);
+    }
+    printf("%-12s %10.3f %10.3f %10.3f %10.3f\n", "total", total.rms(0), total.rms(1), total.rms(2),
+           total.max_abs[0]);
+
+    const SimI2cBus::Stats& bus_stats = bus.getStats();
+    printf("Samples: front %u, rear %u, FIFO overflows %u; I2C %u transfers, %u errors, %u blocks dropped\n",
+           front_sim.getSampleCount(), rear_sim.getSampleCount(),
+           front_sim.getOverflowCount() + rear_sim.getOverflowCount(),
+           bus_stats.transfers, bus_stats.errors, dropped_blocks);
+    printf("Simulated %.1f s in %.3f s wall (%.0fx real time)\n", now * 1e-6, wall_s, now * 1e-6 / wall_s);
+    return 0;
+}
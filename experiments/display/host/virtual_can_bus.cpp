@@ -0,0 +1,226 @@
+#include "virtual_can_bus.hpp"
+
+VirtualCanBus::VirtualCanBus(const Config& config_param)
+    : config(config_param), rng(config_param.seed), uniform(0.0f, 1.0f), time_us(0), bus_free_us(0), busy_us(0),
+      alerts(0), status() {
+    status.state = State::RUNNING;
+}
+
+CyberGearModel* VirtualCanBus::addMotor(const CyberGearModel::Config& motor_config) {
+    nodes.push_back({CyberGearModel(motor_config), {}});
+    return &nodes.back().model;
+}
+
+VirtualCanBus::Node* VirtualCanBus::findNode(uint8_t can_id) {
+    for (Node& node : nodes) {
+        if (node.model.getCanId() == can_id) {
+            return &node;
+        }
+    }
+    return nullptr;
+}
+
+CyberGearModel* VirtualCanBus::getMotor(uint8_t can_id) {
+    Node* node = findNode(can_id);
+    return node ? &node->model : nullptr;
+}
+
+const CyberGearModel* VirtualCanBus::getMotor(uint8_t can_id) const {
+    for (const Node& node : nodes) {
+        if (node.model.getCanId() == can_id) {
+            return &node.model;
+        }
+    }
+    return nullptr;
+}
+
+int64_t VirtualCanBus::frameTimeUs(const CanFrame& frame) const {
+    return ((int64_t)CanTelemetry::frameBits(frame) * 1000000 + config.bitrate - 1) / config.bitrate;
+}
+
+int VirtualCanBus::transmit(const CanFrame* frames, int count) {
+    if (status.state == State::BUS_OFF) {
+        return 0;
+    }
+    int accepted = 0;
+    while (accepted < count && tx_queue.size() < config.tx_queue_len) {
+        tx_queue.push_back({frames[accepted], time_us});
+        accepted++;
+    }
+    return accepted;
+}
+
+bool VirtualCanBus::receive(CanFrame* frame) {
+    if (rx_queue.empty()) {
+        return false;
+    }
+    *frame = rx_queue.front();
+    rx_queue.pop_front();
+    return true;
+}
+
+uint32_t VirtualCanBus::takeAlerts() {
+    uint32_t taken = alerts;
+    alerts = 0;
+    return taken;
+}
+
+VirtualCanBus::Status VirtualCanBus::getStatus() const {
+    Status snapshot = status;
+    snapshot.msgs_to_tx = tx_queue.size();
+    snapshot.msgs_to_rx = rx_queue.size();
+    return snapshot;
+}
+
+bool VirtualCanBus::readStatus(CanBusStatus* out) const {
+    out->bus_off = status.state == State::BUS_OFF;
+    out->msgs_to_tx = tx_queue.size();
+    out->msgs_to_rx = rx_queue.size();
+    out->tx_error_counter = status.tx_error_counter;
+    out->rx_error_counter = status.rx_error_counter;
+    out->tx_failed_count = status.tx_failed_count;
+    out->rx_missed_count = status.rx_missed_count;
+    out->arb_lost_count = status.arb_lost_count;
+    out->bus_error_count = status.bus_error_count;
+    return true;
+}
+
+void VirtualCanBus::recover() {
+    status.state = State::RUNNING;
+    status.tx_error_counter = 0;
+    status.rx_error_counter = 0;
+}
+
+// The frame that wins the bus next: among those ready when the bus frees
+// (or, if none is, the earliest to become ready), the lowest identifier
+bool VirtualCanBus::nextFrame(int64_t limit_us, Pending** winner, Node** owner, int64_t* start_us, bool* host_lost) {
+    int64_t earliest = INT64_MAX;
+    if (!tx_queue.empty() && status.state == State::RUNNING) {
+        earliest = tx_queue.front().ready_us;
+    }
+    for (Node& node : nodes) {
+        if (!node.outbox.empty() && node.outbox.front().ready_us < earliest) {
+            earliest = node.outbox.front().ready_us;
+        }
+    }
+    int64_t start = earliest > bus_free_us ? earliest : bus_free_us;
+    if (earliest == INT64_MAX || start > limit_us) {
+        return false;
+    }
+
+    *winner = nullptr;
+    bool host_pending = false;
+    if (!tx_queue.empty() && status.state == State::RUNNING && tx_queue.front().ready_us <= start) {
+        *winner = &tx_queue.front();
+        *owner = nullptr;
+        host_pending = true;
+    }
+    for (Node& node : nodes) {
+        if (!node.outbox.empty() && node.outbox.front().ready_us <= start &&
+            (!*winner || node.outbox.front().frame.id < (*winner)->frame.id)) {
+            *winner = &node.outbox.front();
+            *owner = &node;
+        }
+    }
+    *host_lost = host_pending && *owner;
+    *start_us = start;
+    return true;
+}
+
+void VirtualCanBus::transmitError(Node* owner) {
+    status.bus_error_count++;
+    alerts |= ALERT_BUS_ERROR;
+    if (owner) {
+        // A motor's error counts against the host as a receiver
+        status.rx_error_counter++;
+        return;
+    }
+    bool was_passive = status.tx_error_counter >= 128;
+    status.tx_error_counter += 8;
+    if (status.tx_error_counter >= 256) {
+        status.state = State::BUS_OFF;
+        status.tx_failed_count += tx_queue.size();
+        tx_queue.clear();
+        alerts |= ALERT_BUS_OFF | ALERT_TX_FAILED;
+    } else if (!was_passive && status.tx_error_counter >= 128) {
+        alerts |= ALERT_ERR_PASS;
+    }
+}
+
+void VirtualCanBus::deliver(const CanFrame& frame, Node* owner, int64_t end_us) {
+    if (!owner) {
+        // Host frame: every motor sees it, the addressed one acts on it
+        sent.push_back(frame);
+        if (status.tx_error_counter > 0) {
+            status.tx_error_counter--;
+        }
+        alerts |= ALERT_TX_SUCCESS | (tx_queue.empty() ? ALERT_TX_IDLE : 0);
+        Node* node = frame.extended ? findNode(frame.id & 0xFF) : nullptr;
+        if (node) {
+            node->model.advance(end_us);
+            CanFrame reply;
+            if (node->model.handle(frame, &reply)) {
+                node->outbox.push_back({reply, end_us + config.response_latency_us});
+            }
+        }
+        return;
+    }
+
+    if (status.rx_error_counter > 0) {
+        status.rx_error_counter--;
+    }
+    if (rx_queue.size() >= config.rx_queue_len) {
+        status.rx_missed_count++;
+        alerts |= ALERT_RX_QUEUE_FULL;
+        return;
+    }
+    rx_queue.push_back(frame);
+    alerts |= ALERT_RX_DATA;
+}
+
+void VirtualCanBus::advance(int64_t t_us) {
+    Pending* winner;
+    Node* owner;
+    int64_t start;
+    bool host_lost;
+
+    while (nextFrame(t_us, &winner, &owner, &start, &host_lost)) {
+        // Frames still on the wire at t_us finish in a later call
+        int64_t frame_us = frameTimeUs(winner->frame);
+        if (start + frame_us > t_us) {
+            break;
+        }
+        if (host_lost) {
+            status.arb_lost_count++;
+            alerts |= ALERT_ARB_LOST;
+        }
+        if (config.error_rate > 0 && uniform(rng) < config.error_rate) {
+            // Error flag part way through (a 20-bit error frame), then the
+            // frame goes again
+            int64_t error_us = frame_us / 2 + (20 * 1000000LL + config.bitrate - 1) / config.bitrate;
+            bus_free_us = start + error_us;
+            busy_us += error_us;
+            transmitError(owner);
+            continue;
+        }
+
+        CanFrame frame = winner->frame;
+        bus_free_us = start + frame_us;
+        busy_us += frame_us;
+        if (owner) {
+            owner->outbox.pop_front();
+        } else {
+            tx_queue.pop_front();
+        }
+        deliver(frame, owner, bus_free_us);
+    }
+
+    for (Node& node : nodes) {
+        node.model.advance(t_us);
+        CanFrame fault;
+        if (node.model.takeFaultFrame(&fault)) {
+            node.outbox.push_back({fault, t_us});
+        }
+    }
+    time_us = t_us;
+}
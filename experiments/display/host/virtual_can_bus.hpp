@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+#include "can_frame.hpp"
+#include "can_telemetry.hpp"
+#include "cybergear_model.hpp"
+
+// ============================================================================
+// VirtualCanBus - Simulated TWAI controller and wire with CyberGear models
+// ============================================================================
+// Mirrors TwaiBus (transmit / receive) plus the driver's alerts and status
+// so the firmware's MotorController, and position_test's polling loop, run
+// unchanged against it. Time only moves in advance(), which plays the wire
+// out event by event: every frame occupies the bus for its bit time at the
+// configured bitrate, frames pending at the same moment arbitrate by lowest
+// identifier, and a motor answers response_latency_us after a command has
+// finished arriving. Nothing sleeps, so minutes of bus traffic take
+// milliseconds to simulate.
+//
+// Fault injection: each frame on the wire is corrupted with error_rate
+// probability, costing an error frame and an automatic retransmission. The
+// host's transmit error counter follows the CAN rules (+8 per error, -1 per
+// success) into error passive at 128 and bus off at 256, where queued frames
+// fail and nothing more is sent until recover().
+class VirtualCanBus {
+public:
+    // Same bits as the driver's TWAI_ALERT_* flags
+    static constexpr uint32_t ALERT_TX_IDLE = 0x0001;
+    static constexpr uint32_t ALERT_TX_SUCCESS = 0x0002;
+    static constexpr uint32_t ALERT_RX_DATA = 0x0004;
+    static constexpr uint32_t ALERT_ARB_LOST = 0x0080;
+    static constexpr uint32_t ALERT_BUS_ERROR = 0x0200;
+    static constexpr uint32_t ALERT_TX_FAILED = 0x0400;
+    static constexpr uint32_t ALERT_RX_QUEUE_FULL = 0x0800;
+    static constexpr uint32_t ALERT_ERR_PASS = 0x1000;
+    static constexpr uint32_t ALERT_BUS_OFF = 0x2000;
+
+    enum class State {
+        RUNNING,
+        BUS_OFF,
+    };
+
+    struct Config {
+        uint32_t bitrate;              // bit/s
+        uint32_t tx_queue_len;
+        uint32_t rx_queue_len;
+        int64_t response_latency_us;   // Command received -> reply queued
+        float error_rate;              // Probability a frame is corrupted on the wire
+        uint32_t seed;
+    };
+
+    // Like twai_status_info_t
+    struct Status {
+        State state;
+        uint32_t msgs_to_tx;
+        uint32_t msgs_to_rx;
+        uint32_t tx_error_counter;
+        uint32_t rx_error_counter;
+        uint32_t tx_failed_count;
+        uint32_t rx_missed_count;
+        uint32_t arb_lost_count;
+        uint32_t bus_error_count;
+    };
+
+    explicit VirtualCanBus(const Config& config);
+
+    // Motors live on the bus for its lifetime (created with config)
+    CyberGearModel* addMotor(const CyberGearModel::Config& config);
+    CyberGearModel* getMotor(uint8_t can_id);
+    const CyberGearModel* getMotor(uint8_t can_id) const;
+
+    // Queue frames without blocking; returns how many were accepted (in order)
+    int transmit(const CanFrame* frames, int count);
+    bool receive(CanFrame* frame);
+
+    // Play the bus and the motors out to t_us
+    void advance(int64_t t_us);
+
+    // Alerts raised since the last call
+    uint32_t takeAlerts();
+    Status getStatus() const;
+
+    // Same as TwaiBus::readStatus()
+    bool readStatus(CanBusStatus* status) const;
+
+    // Leave bus off with cleared error counters
+    void recover();
+
+    void setErrorRate(float rate) { config.error_rate = rate; }
+
+    // Wire time of one frame (CanTelemetry's bit estimate)
+    int64_t frameTimeUs(const CanFrame& frame) const;
+
+    int64_t getTime() const { return time_us; }
+    int64_t getBusyUs() const { return busy_us; }
+    const std::vector<CanFrame>& getSent() const { return sent; }
+    void clearSent() { sent.clear(); }
+
+private:
+    struct Pending {
+        CanFrame frame;
+        int64_t ready_us;
+    };
+
+    struct Node {
+        CyberGearModel model;
+        std::deque<Pending> outbox;
+    };
+
+    Config config;
+    std::deque<Node> nodes;     // Stable addresses for getMotor()
+    std::deque<Pending> tx_queue;
+    std::deque<CanFrame> rx_queue;
+    std::vector<CanFrame> sent;
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+    int64_t time_us;
+    int64_t bus_free_us;        // When the frame on the wire ends
+    int64_t busy_us;
+    uint32_t alerts;
+    Status status;
+
+    Node* findNode(uint8_t can_id);
+    bool nextFrame(int64_t limit_us, Pending** winner, Node** owner, int64_t* start_us, bool* host_lost);
+    void deliver(const CanFrame& frame, Node* owner, int64_t end_us);
+    void transmitError(Node* owner);
+};
@@ -0,0 +1,69 @@
+#include "accel_calibration.hpp"
+
+void AccelCalibrator::reset(const AccelOffsets& current_offsets) {
+    current = current_offsets;
+    capture_count = 0;
+}
+
+bool AccelCalibrator::beginOrientation(const Orientation& expected) {
+    if (capture_count >= MAX_ORIENTATIONS) {
+        return false;
+    }
+    captures[capture_count] = {};
+    captures[capture_count].expected = expected;
+    capture_count++;
+    return true;
+}
+
+void AccelCalibrator::addBlock(const AccelBlock& block) {
+    if (capture_count == 0) {
+        return;
+    }
+    Capture& capture = captures[capture_count - 1];
+    for (int i = 0; i < block.count; i++) {
+        capture.sum_x += block.x[i];
+        capture.sum_y += block.y[i];
+        capture.sum_z += block.z[i];
+    }
+    capture.count += block.count;
+}
+
+uint32_t AccelCalibrator::getSampleCount() const {
+    return capture_count ? captures[capture_count - 1].count : 0;
+}
+
+// Round a raw-LSB correction to OFS units and add it to the active offset
+static int8_t offset_register(int8_t current, float error_lsb) {
+    float scaled = error_lsb / adxl345::OFS_TO_RAW;
+    int value = current + (int)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+    if (value > INT8_MAX) {
+        value = INT8_MAX;
+    } else if (value < INT8_MIN) {
+        value = INT8_MIN;
+    }
+    return (int8_t)value;
+}
+
+bool AccelCalibrator::compute(AccelOffsets* result) const {
+    float error_x = 0, error_y = 0, error_z = 0;
+    int used = 0;
+
+    for (int i = 0; i < capture_count; i++) {
+        const Capture& capture = captures[i];
+        if (capture.count == 0) {
+            continue;
+        }
+        error_x += capture.expected.x - (float)capture.sum_x / capture.count;
+        error_y += capture.expected.y - (float)capture.sum_y / capture.count;
+        error_z += capture.expected.z - (float)capture.sum_z / capture.count;
+        used++;
+    }
+    if (used == 0) {
+        return false;
+    }
+
+    result->x = offset_register(current.x, error_x / used);
+    result->y = offset_register(current.y, error_y / used);
+    result->z = offset_register(current.z, error_z / used);
+    return true;
+}
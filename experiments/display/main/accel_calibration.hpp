@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include "accel_sensor.hpp"
+#include "adxl345_regs.hpp"
+
+// ============================================================================
+// Accelerometer calibration
+// ============================================================================
+// Offsets are held in the sensor's OFSX/OFSY/OFSZ registers, so the
+// correction is applied in hardware with no per-sample cost. A calibration
+// averages a burst of samples in each known orientation and solves for the
+// offset that maps every measured mean onto its expected gravity vector
+// (least squares with unit gain = mean of the per-orientation errors).
+
+class AccelCalibrator {
+public:
+    static constexpr int MAX_ORIENTATIONS = 6;
+
+    // Expected gravity in raw LSB for one orientation
+    struct Orientation {
+        int16_t x, y, z;
+    };
+
+    // Sensor flat, Z up
+    static constexpr Orientation LEVEL = {0, 0, (int16_t)adxl345::LSB_PER_G};
+
+    // Start a new calibration; current = offsets active while sampling
+    void reset(const AccelOffsets& current);
+
+    // Start averaging samples for a new orientation
+    bool beginOrientation(const Orientation& expected);
+
+    // Accumulate a block into the current orientation
+    void addBlock(const AccelBlock& block);
+
+    // Samples in the current orientation
+    uint32_t getSampleCount() const;
+
+    // Offsets to write (current offsets + measured error), clamped to int8.
+    // False if no orientation has samples.
+    bool compute(AccelOffsets* result) const;
+
+private:
+    struct Capture {
+        Orientation expected;
+        int64_t sum_x, sum_y, sum_z;
+        uint32_t count;
+    };
+
+    AccelOffsets current = {};
+    Capture captures[MAX_ORIENTATIONS] = {};
+    int capture_count = 0;
+};
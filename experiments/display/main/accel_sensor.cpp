@@ -0,0 +1,137 @@
+#include "accel_sensor.hpp"
+
+AccelSensor::AccelSensor(const Config& config_param)
+    : config(config_param), rate_code(adxl345::RATE_100_HZ), offsets(), transactions(0),
+      write_slot(0), fifo_status(0), int_source(0), pending_entries(0) {}
+
+// Queue a register write from a rotating slot (caller waits before reusing
+// more than WRITE_SLOTS writes)
+bool AccelSensor::writeRegister(uint8_t reg, uint8_t value) {
+    uint8_t* data = write_buf[write_slot];
+    write_slot = (write_slot + 1) % WRITE_SLOTS;
+    data[0] = reg;
+    data[1] = value;
+    transactions++;
+    return config.write(config.device_address, data, 2);
+}
+
+// reg must point at storage that outlives the transfer
+bool AccelSensor::readRegisters(const uint8_t* reg, uint8_t* data, size_t len) {
+    transactions++;
+    return config.write_read(config.device_address, reg, 1, data, len);
+}
+
+bool AccelSensor::init(uint8_t rate, uint8_t fifo_watermark, const AccelOffsets& initial_offsets,
+                       const AccelMotionConfig& motion) {
+    uint8_t devid = 0;
+    if (!readRegisters(&adxl345::REG_DEVID, &devid, 1) || !config.wait() || devid != adxl345::DEVID) {
+        return false;
+    }
+
+    rate_code = rate;
+    offsets = initial_offsets;
+
+    // One burst from OFSX to DATA_FORMAT: offsets, motion detection, rate,
+    // standby, interrupts, format (tap registers in between stay cleared)
+    uint8_t* regs = &config_buf[1];
+    for (int i = 0; i < adxl345::CONFIG_BYTES; i++) {
+        regs[i] = 0;
+    }
+    config_buf[0] = adxl345::CONFIG_FIRST;
+    regs[adxl345::REG_OFSX - adxl345::CONFIG_FIRST + 0] = (uint8_t)offsets.x;
+    regs[adxl345::REG_OFSX - adxl345::CONFIG_FIRST + 1] = (uint8_t)offsets.y;
+    regs[adxl345::REG_OFSX - adxl345::CONFIG_FIRST + 2] = (uint8_t)offsets.z;
+    uint8_t int_enable = 0;
+    if (motion.activity_threshold) {
+        regs[adxl345::REG_THRESH_ACT - adxl345::CONFIG_FIRST] = motion.activity_threshold;
+        regs[adxl345::REG_ACT_INACT_CTL - adxl345::CONFIG_FIRST] |= adxl345::ACT_AC_XYZ;
+        int_enable |= adxl345::INT_ACTIVITY;
+    }
+    if (motion.inactivity_threshold) {
+        regs[adxl345::REG_THRESH_INACT - adxl345::CONFIG_FIRST] = motion.inactivity_threshold;
+        regs[adxl345::REG_TIME_INACT - adxl345::CONFIG_FIRST] = motion.inactivity_time_s;
+        regs[adxl345::REG_ACT_INACT_CTL - adxl345::CONFIG_FIRST] |= adxl345::INACT_AC_XYZ;
+        int_enable |= adxl345::INT_INACTIVITY;
+    }
+    regs[adxl345::REG_BW_RATE - adxl345::CONFIG_FIRST] = rate_code;
+    regs[adxl345::REG_INT_ENABLE - adxl345::CONFIG_FIRST] = int_enable;
+    regs[adxl345::REG_INT_MAP - adxl345::CONFIG_FIRST] = adxl345::INT_INACTIVITY;  // Set bits -> INT2
+    regs[adxl345::REG_DATA_FORMAT - adxl345::CONFIG_FIRST] = adxl345::FORMAT_FULL_RES | adxl345::FORMAT_RANGE_4G;
+    transactions++;
+
+    // Configure in standby, then start measuring
+    bool ok = config.write(config.device_address, config_buf, sizeof(config_buf)) &&
+              writeRegister(adxl345::REG_FIFO_CTL, adxl345::FIFO_MODE_STREAM |
+                                                   (fifo_watermark & adxl345::FIFO_SAMPLES_MASK)) &&
+              writeRegister(adxl345::REG_POWER_CTL, adxl345::POWER_MEASURE);
+    return config.wait() && ok;
+}
+
+bool AccelSensor::setSampling(uint8_t rate, uint8_t fifo_watermark, bool measure) {
+    rate_code = rate;
+    return writeRegister(adxl345::REG_BW_RATE, rate_code) &&
+           writeRegister(adxl345::REG_FIFO_CTL, adxl345::FIFO_MODE_STREAM |
+                                                (fifo_watermark & adxl345::FIFO_SAMPLES_MASK)) &&
+           writeRegister(adxl345::REG_POWER_CTL, measure ? adxl345::POWER_MEASURE : 0);
+}
+
+bool AccelSensor::setOffsets(const AccelOffsets& new_offsets) {
+    offsets = new_offsets;
+    offset_buf[0] = adxl345::REG_OFSX;
+    offset_buf[1] = (uint8_t)offsets.x;
+    offset_buf[2] = (uint8_t)offsets.y;
+    offset_buf[3] = (uint8_t)offsets.z;
+    transactions++;
+    return config.write(config.device_address, offset_buf, sizeof(offset_buf));
+}
+
+bool AccelSensor::requestStatus() {
+    fifo_status = 0;
+    pending_entries = 0;
+    return readRegisters(&adxl345::REG_FIFO_STATUS, &fifo_status, 1);
+}
+
+bool AccelSensor::requestEntries() {
+    // Each 6-byte burst from DATAX0 pops one FIFO entry (the register pointer
+    // doesn't wrap past DATAZ1, so entries can't share a transfer)
+    int entries = fifo_status & adxl345::FIFO_ENTRIES_MASK;
+    if (entries > adxl345::FIFO_DEPTH) {
+        entries = adxl345::FIFO_DEPTH;
+    }
+
+    for (int i = 0; i < entries; i++) {
+        if (!readRegisters(&adxl345::REG_DATAX0, raw[i], adxl345::SAMPLE_BYTES)) {
+            return false;
+        }
+        pending_entries = i + 1;
+    }
+    return true;
+}
+
+bool AccelSensor::requestInterruptSource() {
+    int_source = 0;
+    return readRegisters(&adxl345::REG_INT_SOURCE, &int_source, 1);
+}
+
+void AccelSensor::collect(AccelBlock* block, int64_t now_us) {
+    block->timestamp_us = now_us;
+    block->sample_period_us = (uint32_t)(1000000.0f / adxl345::rate_hz(rate_code));
+    block->count = pending_entries;
+
+    for (int i = 0; i < pending_entries; i++) {
+        block->x[i] = (int16_t)(raw[i][0] | (raw[i][1] << 8));
+        block->y[i] = (int16_t)(raw[i][2] | (raw[i][3] << 8));
+        block->z[i] = (int16_t)(raw[i][4] | (raw[i][5] << 8));
+    }
+    pending_entries = 0;
+}
+
+bool AccelSensor::drain(AccelBlock* block, int64_t now_us) {
+    bool ok = requestStatus() && config.wait() &&
+              requestEntries() && config.wait();
+    if (!ok) {
+        pending_entries = 0;
+    }
+    collect(block, now_us);
+    return ok;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "adxl345_regs.hpp"
+
+// ============================================================================
+// AccelBlock - Timestamped block of raw samples drained from one FIFO
+// ============================================================================
+// Structure-of-arrays so filters can walk one axis contiguously.
+struct AccelBlock {
+    int64_t timestamp_us;       // Time of the newest sample
+    uint32_t sample_period_us;  // Spacing between samples (1 / ODR)
+    uint8_t count;              // Valid samples, oldest first
+    int16_t x[adxl345::FIFO_DEPTH];
+    int16_t y[adxl345::FIFO_DEPTH];
+    int16_t z[adxl345::FIFO_DEPTH];
+};
+
+// Offset register values in OFS units (15.6 mg = 4 full-res LSB), added by
+// the sensor to every sample
+struct AccelOffsets {
+    int8_t x;
+    int8_t y;
+    int8_t z;
+};
+
+// Activity / inactivity detection (0 thresholds = disabled). Activity is
+// routed to INT1 so it can wake the host; inactivity goes to INT2 (unwired)
+// and is only seen by reading INT_SOURCE.
+struct AccelMotionConfig {
+    uint8_t activity_threshold;     // 62.5 mg/LSB above the reference
+    uint8_t inactivity_threshold;   // 62.5 mg/LSB
+    uint8_t inactivity_time_s;      // Seconds below threshold before flagging
+};
+
+// ============================================================================
+// AccelSensor - ADXL345 in FIFO stream mode
+// ============================================================================
+// The sensor samples at its output data rate into its 32-entry FIFO; drain()
+// empties everything queued since the last call. The bus is reached through
+// the write / write_read functions, so any I2C backend (or a fake) works.
+// Transfers may complete asynchronously: wait blocks until they are done, and
+// every buffer passed to the bus is owned by the sensor. The staged calls
+// (requestStatus / requestEntries / collect) let a task queue several
+// sensors on one bus before waiting.
+class AccelSensor {
+public:
+    typedef std::function<bool(uint8_t dev_addr, const uint8_t* data, size_t len)> write_fn;
+    typedef std::function<bool(uint8_t dev_addr, const uint8_t* wdata, size_t wlen,
+                               uint8_t* rdata, size_t rlen)> write_read_fn;
+    typedef std::function<bool()> wait_fn;
+
+    struct Config {
+        uint8_t device_address;
+        write_fn write;
+        write_read_fn write_read;
+        wait_fn wait;           // Blocks until queued transfers finish
+    };
+
+    explicit AccelSensor(const Config& config);
+
+    // Verify DEVID and start measuring at rate_code with FIFO stream mode.
+    // The watermark sets how many samples the FIFO holds before flagging.
+    // Offsets, motion detection, rate and format go out in one burst write.
+    bool init(uint8_t rate_code, uint8_t fifo_watermark, const AccelOffsets& offsets,
+              const AccelMotionConfig& motion = {});
+
+    // Queue a data rate / watermark change, or stop measuring (standby keeps
+    // the configuration). Samples already in the FIFO are stamped with the
+    // new rate when collected. Caller waits.
+    bool setSampling(uint8_t rate_code, uint8_t fifo_watermark, bool measure);
+
+    // Queue a write of the offset registers (caller waits)
+    bool setOffsets(const AccelOffsets& offsets);
+    const AccelOffsets& getOffsets() const { return offsets; }
+
+    // Read every queued FIFO entry into block (one 6-byte burst per entry).
+    // Returns false on a bus error.
+    bool drain(AccelBlock* block, int64_t now_us);
+
+    // Staged drain: queue the FIFO_STATUS read, wait, queue one read per
+    // entry, wait, then unpack with collect()
+    bool requestStatus();
+    bool requestEntries();
+    void collect(AccelBlock* block, int64_t now_us);
+
+    // Queue an INT_SOURCE read (clears latched activity/inactivity); the
+    // value is valid after the caller waits
+    bool requestInterruptSource();
+    uint8_t getInterruptSource() const { return int_source; }
+
+    uint8_t getAddress() const { return config.device_address; }
+    uint8_t getRateCode() const { return rate_code; }
+
+    // Transfer counters (for bus load reporting)
+    uint32_t getTransactionCount() const { return transactions; }
+
+private:
+    static constexpr int WRITE_SLOTS = 8;
+
+    Config config;
+    uint8_t rate_code;
+    AccelOffsets offsets;
+    uint32_t transactions;
+
+    // Transfer buffers (must outlive queued transfers)
+    uint8_t write_buf[WRITE_SLOTS][2];
+    uint8_t config_buf[1 + adxl345::CONFIG_BYTES];
+    uint8_t offset_buf[4];
+    int write_slot;
+    uint8_t fifo_status;
+    uint8_t int_source;
+    int pending_entries;
+    uint8_t raw[adxl345::FIFO_DEPTH][adxl345::SAMPLE_BYTES];
+
+    bool writeRegister(uint8_t reg, uint8_t value);
+    bool readRegisters(const uint8_t* reg, uint8_t* data, size_t len);
+};
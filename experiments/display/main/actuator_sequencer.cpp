@@ -0,0 +1,85 @@
+#include "actuator_sequencer.hpp"
+
+ActuatorSequencer::ActuatorSequencer(const Config& config_param)
+    : config(config_param), phase(Phase::LOCKED), direction(0),
+      deadline_us(NO_DEADLINE) {}
+
+int64_t ActuatorSequencer::move(int new_direction, int64_t now_us) {
+    switch (phase) {
+        case Phase::LOCKED:
+            // Release locks and start motors once they have cleared
+            config.unlock();
+            direction = new_direction;
+            phase = Phase::UNLOCKING;
+            deadline_us = now_us + config.unlock_settle_us;
+            break;
+        case Phase::UNLOCKING:
+            // Still settling - just retarget the pending start
+            direction = new_direction;
+            break;
+        case Phase::RUNNING:
+            if (new_direction != direction) {
+                direction = new_direction;
+                config.spin(direction);
+                deadline_us = now_us + config.repeat_period_us;
+            }
+            break;
+        case Phase::STOPPING:
+            // Locks are still open - cancel the pending lock and resume
+            direction = new_direction;
+            config.spin(direction);
+            phase = Phase::RUNNING;
+            deadline_us = now_us + config.repeat_period_us;
+            break;
+    }
+    return deadline_us;
+}
+
+int64_t ActuatorSequencer::stop(int64_t now_us) {
+    switch (phase) {
+        case Phase::LOCKED:
+        case Phase::STOPPING:
+            break;
+        case Phase::UNLOCKING:
+            // Motors never started - re-engage immediately
+            config.lock();
+            direction = 0;
+            phase = Phase::LOCKED;
+            deadline_us = NO_DEADLINE;
+            break;
+        case Phase::RUNNING:
+            config.spin(0);
+            direction = 0;
+            phase = Phase::STOPPING;
+            deadline_us = now_us + config.stop_settle_us;
+            break;
+    }
+    return deadline_us;
+}
+
+int64_t ActuatorSequencer::update(int64_t now_us) {
+    if (deadline_us == NO_DEADLINE || now_us < deadline_us) {
+        return deadline_us;
+    }
+
+    switch (phase) {
+        case Phase::LOCKED:
+            deadline_us = NO_DEADLINE;
+            break;
+        case Phase::UNLOCKING:
+            config.spin(direction);
+            phase = Phase::RUNNING;
+            deadline_us = now_us + config.repeat_period_us;
+            break;
+        case Phase::RUNNING:
+            config.spin(direction);
+            deadline_us = now_us + config.repeat_period_us;
+            break;
+        case Phase::STOPPING:
+            config.lock();
+            phase = Phase::LOCKED;
+            deadline_us = NO_DEADLINE;
+            break;
+    }
+    return deadline_us;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// ============================================================================
+// ActuatorSequencer - Timeline for the lock/motor choreography
+// ============================================================================
+// Runs unlock -> settle -> motor start ... motor stop -> settle -> lock as
+// scheduled steps instead of blocking delays. The sequencer has no notion of
+// time sources or tasks: callers pass the current time and arm a timer for
+// the returned deadline, then call update() when it fires. Requests can land
+// in any phase, so a release during the unlock settle cancels the move and a
+// new press during the stop settle resumes without re-locking.
+class ActuatorSequencer {
+public:
+    enum class Phase {
+        LOCKED,     // Solenoids engaged, motors stopped
+        UNLOCKING,  // Solenoids released, waiting for them to clear
+        RUNNING,    // Motors spinning, command repeated every repeat period
+        STOPPING,   // Motors stopped, waiting before re-engaging solenoids
+    };
+
+    static constexpr int64_t NO_DEADLINE = -1;
+
+    struct Config {
+        std::function<void()> unlock;     // Release solenoids
+        std::function<void()> lock;       // Engage solenoids
+        std::function<void(int)> spin;    // Motor command: 1 = up, -1 = down, 0 = stop
+        int64_t unlock_settle_us;         // Unlock -> first motor command
+        int64_t stop_settle_us;           // Motor stop -> lock
+        int64_t repeat_period_us;         // Motor command refresh while running
+    };
+
+    explicit ActuatorSequencer(const Config& config);
+
+    // Request motion (1 = up, -1 = down); reverses in place if already moving.
+    // Returns the next deadline (NO_DEADLINE if none)
+    int64_t move(int direction, int64_t now_us);
+
+    // Request stop; cancels a pending start if motors haven't spun yet.
+    // Returns the next deadline (NO_DEADLINE if none)
+    int64_t stop(int64_t now_us);
+
+    // Run the step that is due at now_us (if any), returns the next deadline
+    int64_t update(int64_t now_us);
+
+    Phase getPhase() const { return phase; }
+    int getDirection() const { return direction; }
+    int64_t getDeadline() const { return deadline_us; }
+
+private:
+    Config config;
+    Phase phase;
+    int direction;        // Requested (UNLOCKING) or active (RUNNING) direction
+    int64_t deadline_us;  // Time of the next scheduled step
+};
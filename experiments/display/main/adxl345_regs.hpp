@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+// ============================================================================
+// ADXL345 Register Map (subset used by AccelSensor)
+// ============================================================================
+namespace adxl345 {
+
+constexpr uint8_t REG_DEVID          = 0x00;
+constexpr uint8_t REG_OFSX           = 0x1E;  // OFSX, OFSY, OFSZ
+constexpr uint8_t REG_THRESH_ACT     = 0x24;
+constexpr uint8_t REG_THRESH_INACT   = 0x25;
+constexpr uint8_t REG_TIME_INACT     = 0x26;
+constexpr uint8_t REG_ACT_INACT_CTL  = 0x27;
+constexpr uint8_t REG_BW_RATE        = 0x2C;
+constexpr uint8_t REG_POWER_CTL      = 0x2D;
+constexpr uint8_t REG_INT_ENABLE     = 0x2E;
+constexpr uint8_t REG_INT_MAP        = 0x2F;
+constexpr uint8_t REG_INT_SOURCE     = 0x30;
+constexpr uint8_t REG_DATA_FORMAT    = 0x31;
+constexpr uint8_t REG_DATAX0         = 0x32;  // X0, X1, Y0, Y1, Z0, Z1
+constexpr uint8_t REG_FIFO_CTL       = 0x38;
+constexpr uint8_t REG_FIFO_STATUS    = 0x39;
+
+constexpr uint8_t DEVID = 0xE5;
+
+// BW_RATE output data rate codes
+constexpr uint8_t RATE_12_5_HZ = 0x07;
+constexpr uint8_t RATE_25_HZ   = 0x08;
+constexpr uint8_t RATE_50_HZ   = 0x09;
+constexpr uint8_t RATE_100_HZ  = 0x0A;
+constexpr uint8_t RATE_200_HZ  = 0x0B;
+constexpr uint8_t RATE_400_HZ  = 0x0C;
+constexpr uint8_t RATE_800_HZ  = 0x0D;
+
+// POWER_CTL bits
+constexpr uint8_t POWER_MEASURE = 0x08;
+
+// INT_ENABLE / INT_MAP / INT_SOURCE bits
+constexpr uint8_t INT_ACTIVITY   = 0x10;
+constexpr uint8_t INT_INACTIVITY = 0x08;
+
+// ACT_INACT_CTL: AC-coupled (relative to the level at enable), all axes
+constexpr uint8_t ACT_AC_XYZ   = 0xF0;
+constexpr uint8_t INACT_AC_XYZ = 0x0F;
+
+// THRESH_ACT / THRESH_INACT scale
+constexpr float THRESH_MG_PER_LSB = 62.5f;
+
+// DATA_FORMAT bits
+constexpr uint8_t FORMAT_FULL_RES = 0x08;  // 3.9 mg/LSB at every range
+constexpr uint8_t FORMAT_RANGE_4G = 0x01;
+
+// FIFO_CTL fields
+constexpr uint8_t FIFO_MODE_BYPASS = 0x00;
+constexpr uint8_t FIFO_MODE_STREAM = 0x80;
+constexpr uint8_t FIFO_SAMPLES_MASK = 0x1F;  // Watermark
+constexpr uint8_t FIFO_ENTRIES_MASK = 0x3F;  // FIFO_STATUS entry count
+
+constexpr int FIFO_DEPTH = 32;
+constexpr int SAMPLE_BYTES = 6;
+
+// Full resolution scale
+constexpr float LSB_PER_G = 256.0f;
+
+// Offset registers: 15.6 mg/LSB (two's complement), i.e. 4 full-res LSB
+constexpr int OFS_TO_RAW = 4;
+
+// Configuration block written in one burst at init (OFSX..DATA_FORMAT).
+// ACT_TAP_STATUS and INT_SOURCE sit inside it but are read-only, so the
+// bytes written there are ignored.
+constexpr uint8_t CONFIG_FIRST = REG_OFSX;
+constexpr uint8_t CONFIG_LAST = REG_DATA_FORMAT;
+constexpr int CONFIG_BYTES = CONFIG_LAST - CONFIG_FIRST + 1;
+
+// Output data rate in Hz for a BW_RATE code (0x00 = 0.10 Hz doubling upward)
+constexpr float rate_hz(uint8_t rate_code) {
+    return 3200.0f / (float)(1 << (0x0F - (rate_code & 0x0F)));
+}
+
+// Typical supply current (uA, normal power, Vs = 2.5 V) for a BW_RATE code
+constexpr float supply_current_ua(uint8_t rate_code) {
+    return (rate_code & 0x0F) >= RATE_100_HZ ? 140.0f :
+           (rate_code & 0x0F) == RATE_50_HZ ? 90.0f :
+           (rate_code & 0x0F) == RATE_25_HZ ? 60.0f :
+           (rate_code & 0x0F) == RATE_12_5_HZ ? 50.0f : 45.0f;
+}
+
+// Supply current with POWER_CTL measure cleared (uA)
+constexpr float STANDBY_CURRENT_UA = 0.1f;
+
+} // namespace adxl345
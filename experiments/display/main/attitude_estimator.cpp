@@ -0,0 +1,89 @@
+#include "attitude_estimator.hpp"
+#include <cmath>
+
+static constexpr float RAD_TO_DEG = 180.0f / (float)M_PI;
+
+AttitudeEstimator::AttitudeEstimator(const Config& config_param)
+    : config(config_param), front(), rear(), attitude() {}
+
+void AttitudeEstimator::reset() {
+    front = Channel();
+    rear = Channel();
+    attitude = Attitude();
+}
+
+void AttitudeEstimator::setCutoff(float cutoff_hz) {
+    config.cutoff_hz = cutoff_hz;
+    // Recompute alpha on the next block
+    front.period_us = 0;
+    rear.period_us = 0;
+}
+
+void AttitudeEstimator::filterBlock(Channel* channel, const AccelBlock& block) {
+    if (block.sample_period_us != channel->period_us) {
+        // alpha = dt / (RC + dt), RC = 1 / (2 * pi * fc)
+        float dt = block.sample_period_us * 1e-6f;
+        float rc = 1.0f / (2.0f * (float)M_PI * config.cutoff_hz);
+        channel->alpha = dt / (rc + dt);
+        channel->period_us = block.sample_period_us;
+    }
+
+    int start = 0;
+    if (!channel->seeded && block.count > 0) {
+        channel->x = block.x[0];
+        channel->y = block.y[0];
+        channel->z = block.z[0];
+        channel->seeded = true;
+        start = 1;
+    }
+
+    float alpha = channel->alpha;
+    float x = channel->x, y = channel->y, z = channel->z;
+    for (int i = start; i < block.count; i++) {
+        x += alpha * (block.x[i] - x);
+        y += alpha * (block.y[i] - y);
+        z += alpha * (block.z[i] - z);
+    }
+    channel->x = x;
+    channel->y = y;
+    channel->z = z;
+}
+
+const AttitudeEstimator::Attitude& AttitudeEstimator::update(const AccelBlock& front_block, bool front_ok,
+                                                             const AccelBlock& rear_block, bool rear_ok) {
+    if (front_ok) {
+        filterBlock(&front, front_block);
+    }
+    if (rear_ok) {
+        filterBlock(&rear, rear_block);
+    }
+
+    attitude.front_valid = front_ok && front.seeded;
+    attitude.rear_valid = rear_ok && rear.seeded;
+
+    // Sum the valid gravity vectors (scale cancels in atan2)
+    float x = 0, y = 0, z = 0;
+    if (attitude.front_valid) {
+        x += front.x;
+        y += front.y;
+        z += front.z;
+    }
+    if (attitude.rear_valid) {
+        x += rear.x;
+        y += rear.y;
+        z += rear.z;
+    }
+
+    if (attitude.front_valid || attitude.rear_valid) {
+        // Pitch: rotation around X-axis, roll: rotation around Y-axis
+        attitude.pitch = atan2f(y, z) * RAD_TO_DEG;
+        attitude.roll = atan2f(x, z) * RAD_TO_DEG;
+    }
+
+    if (attitude.front_valid && attitude.rear_valid) {
+        attitude.torsion = (atan2f(front.x, front.z) - atan2f(rear.x, rear.z)) * RAD_TO_DEG;
+    } else {
+        attitude.torsion = 0;
+    }
+    return attitude;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "accel_sensor.hpp"
+
+// ============================================================================
+// AttitudeEstimator - Filtered pitch/roll/torsion from both accelerometers
+// ============================================================================
+// Each sample of each sensor runs through a first-order low-pass on the
+// gravity vector (so the filter sees the full data rate, not the task rate).
+// Pitch and roll come from the sum of both filtered vectors; torsion is the
+// front roll minus the rear roll, i.e. how far the frame is twisted. With only
+// one sensor valid, that sensor alone gives pitch/roll and torsion holds at 0.
+// The cutoff sets the trade between jitter and lag: the step response reaches
+// 63% after 1 / (2 * pi * cutoff_hz) seconds.
+class AttitudeEstimator {
+public:
+    struct Config {
+        float cutoff_hz;   // Low-pass bandwidth
+    };
+
+    // Angles in degrees
+    struct Attitude {
+        float pitch;
+        float roll;
+        float torsion;
+        bool front_valid;
+        bool rear_valid;
+    };
+
+    explicit AttitudeEstimator(const Config& config);
+
+    // Feed the latest block from each sensor (ok = false skips that sensor)
+    const Attitude& update(const AccelBlock& front, bool front_ok,
+                           const AccelBlock& rear, bool rear_ok);
+
+    // Forget filter state (next sample seeds the filter directly)
+    void reset();
+
+    void setCutoff(float cutoff_hz);
+    float getCutoff() const { return config.cutoff_hz; }
+    const Attitude& getAttitude() const { return attitude; }
+
+private:
+    // Filtered gravity vector of one sensor (in raw LSB)
+    struct Channel {
+        float x, y, z;
+        bool seeded;
+        uint32_t period_us;   // Sample period alpha was computed for
+        float alpha;
+    };
+
+    Config config;
+    Channel front;
+    Channel rear;
+    Attitude attitude;
+
+    void filterBlock(Channel* channel, const AccelBlock& block);
+};
@@ -0,0 +1,91 @@
+#include "button_scanner.hpp"
+#include "driver/gptimer.h"
+#include "esp_check.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#include "pins.hpp"
+#include "config.hpp"
+
+static const char* TAG = "ButtonScanner";
+
+static gptimer_handle_t scan_timer = NULL;
+static QueueHandle_t scan_event_queue = NULL;
+
+// Only touched from the scanner ISR after start (state is read by tasks)
+static VerticalDebouncer debouncer;
+static ButtonInputStats scan_stats = {};
+
+// ============================================================================
+// Scanner ISR
+// ============================================================================
+static bool IRAM_ATTR scan_timer_on_alarm(gptimer_handle_t timer,
+                                          const gptimer_alarm_event_data_t* edata,
+                                          void* user_ctx) {
+    uint32_t start = esp_cpu_get_cycle_count();
+    BaseType_t high_task_awoken = pdFALSE;
+
+    // One register read samples every button; flip active-low pins so 1 = pressed
+    uint32_t sample = (REG_READ(GPIO_IN_REG) ^ BUTTON_ACTIVE_LOW_MASK) & BUTTON_SCAN_MASK;
+    uint32_t toggled = debouncer.update(sample);
+
+    // Post one event per debounced edge
+    while (toggled) {
+        gpio_num_t gpio_num = (gpio_num_t)__builtin_ctz(toggled);
+        toggled &= toggled - 1;
+        xQueueSendFromISR(scan_event_queue, &gpio_num, &high_task_awoken);
+    }
+
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    scan_stats.isr_count++;
+    scan_stats.isr_cycles += cycles;
+    if (cycles > scan_stats.isr_cycles_max) {
+        scan_stats.isr_cycles_max = cycles;
+    }
+
+    return high_task_awoken == pdTRUE;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+esp_err_t button_scanner_start(QueueHandle_t event_queue) {
+    scan_event_queue = event_queue;
+
+    // Seed the debouncer with the current levels so boot doesn't emit edges
+    debouncer.state = (REG_READ(GPIO_IN_REG) ^ BUTTON_ACTIVE_LOW_MASK) & BUTTON_SCAN_MASK;
+
+    gptimer_config_t timer_config = {};
+    timer_config.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+    timer_config.direction = GPTIMER_COUNT_UP;
+    timer_config.resolution_hz = 1000000;  // 1 MHz, 1 tick = 1 us
+    ESP_RETURN_ON_ERROR(gptimer_new_timer(&timer_config, &scan_timer), TAG, "timer create failed");
+
+    gptimer_event_callbacks_t callbacks = {};
+    callbacks.on_alarm = scan_timer_on_alarm;
+    ESP_RETURN_ON_ERROR(gptimer_register_event_callbacks(scan_timer, &callbacks, NULL),
+                        TAG, "callback register failed");
+    ESP_RETURN_ON_ERROR(gptimer_enable(scan_timer), TAG, "timer enable failed");
+
+    gptimer_alarm_config_t alarm_config = {};
+    alarm_config.alarm_count = 1000000 / BUTTON_SCAN_RATE_HZ;
+    alarm_config.reload_count = 0;
+    alarm_config.flags.auto_reload_on_alarm = true;
+    ESP_RETURN_ON_ERROR(gptimer_set_alarm_action(scan_timer, &alarm_config),
+                        TAG, "alarm config failed");
+    ESP_RETURN_ON_ERROR(gptimer_start(scan_timer), TAG, "timer start failed");
+
+    ESP_LOGI(TAG, "Button scanner started at %d Hz (mask 0x%08lX, active-low 0x%08lX)",
+             BUTTON_SCAN_RATE_HZ, (unsigned long)BUTTON_SCAN_MASK,
+             (unsigned long)BUTTON_ACTIVE_LOW_MASK);
+    return ESP_OK;
+}
+
+bool button_scanner_is_pressed(gpio_num_t gpio_num) {
+    return (debouncer.state >> gpio_num) & 1;
+}
+
+ButtonInputStats button_scanner_get_stats(void) {
+    return scan_stats;
+}
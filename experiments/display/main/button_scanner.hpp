@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+
+// ============================================================================
+// VerticalDebouncer - Bit-parallel debounce for up to 32 inputs
+// ============================================================================
+// Every input bit owns a 2-bit counter split across cnt0/cnt1 ("vertical"
+// counter), so all buttons are debounced with a few logic ops per sample.
+// A bit's stable state only toggles after 4 consecutive samples disagree
+// with it; any agreeing sample resets that bit's counter.
+struct VerticalDebouncer {
+    uint32_t state = 0;  // Debounced state (1 = pressed)
+    uint32_t cnt0 = 0;   // Counter bit 0 per input
+    uint32_t cnt1 = 0;   // Counter bit 1 per input
+
+    // Feed one sample (1 = pressed), returns the bits whose state toggled
+    uint32_t update(uint32_t sample) {
+        uint32_t delta = sample ^ state;
+        cnt1 = (cnt1 ^ cnt0) & delta;
+        cnt0 = ~cnt0 & delta;
+        uint32_t toggled = delta & ~(cnt0 | cnt1);
+        state ^= toggled;
+        return toggled;
+    }
+};
+
+// ============================================================================
+// Button Input Statistics
+// ============================================================================
+// Collected by both the scanner ISR and the per-pin GPIO ISR so the two
+// input paths can be compared (cycles measured inside the handler body).
+struct ButtonInputStats {
+    uint32_t isr_count;       // Number of ISR invocations
+    uint64_t isr_cycles;      // Total CPU cycles spent in the ISR body
+    uint32_t isr_cycles_max;  // Worst-case CPU cycles for a single ISR
+};
+
+// ============================================================================
+// Button Scanner - gptimer ISR sampling all buttons in one register read
+// ============================================================================
+// Starts a gptimer at BUTTON_SCAN_RATE_HZ. Each alarm reads GPIO_IN_REG once,
+// normalises active-low pins and runs the vertical counter debounce. Debounced
+// edges are posted to event_queue as gpio_num_t, same as the GPIO ISR path.
+esp_err_t button_scanner_start(QueueHandle_t event_queue);
+
+// Debounced state of a scanned button (true = pressed)
+bool button_scanner_is_pressed(gpio_num_t gpio_num);
+
+// Snapshot of the scanner ISR statistics
+ButtonInputStats button_scanner_get_stats(void);
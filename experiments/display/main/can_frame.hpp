@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// One classic CAN frame as passed between the bus driver and protocol code
+// (kept free of driver types so protocol code also builds on host)
+struct CanFrame {
+    uint32_t id;        // 11-bit or 29-bit identifier
+    bool extended;      // 29-bit identifier
+    uint8_t len;        // Data length, 0..8
+    uint8_t data[8];
+};
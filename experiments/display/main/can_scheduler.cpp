@@ -0,0 +1,224 @@
+#include "can_scheduler.hpp"
+#include "cybergear.hpp"
+
+using cybergear::CommType;
+
+CanScheduler::CanScheduler(const Config& config_param)
+    : config(config_param), control(), control_head(0), control_count(0), motors(), next_setpoint(0),
+      batch(), sources(), batch_motors(), stats() {
+    if (config.motor_count > MAX_MOTORS) {
+        config.motor_count = MAX_MOTORS;
+    }
+    for (int i = 0; i < MAX_MOTORS; i++) {
+        motors[i].status_due_us = -1;
+    }
+}
+
+int CanScheduler::findMotor(const CanFrame& frame) const {
+    // Commands carry the target motor in the identifier's low byte
+    uint8_t can_id = frame.id & 0xFF;
+    for (int i = 0; i < config.motor_count; i++) {
+        if (config.motor_ids[i] == can_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool CanScheduler::isSetpoint(const CanFrame& frame) {
+    CommType type = cybergear::comm_type(frame);
+    if (type == CommType::MOTION) {
+        return true;
+    }
+    if (type != CommType::WRITE_PARAM) {
+        return false;
+    }
+    uint16_t index = (uint16_t)(frame.data[0] | (frame.data[1] << 8));
+    return index == cybergear::PARAM_SPD_REF || index == cybergear::PARAM_LOC_REF ||
+           index == cybergear::PARAM_IQ_REF;
+}
+
+int CanScheduler::submit(const CanFrame* frames, int count) {
+    for (int n = 0; n < count; n++) {
+        const CanFrame& frame = frames[n];
+        int index = findMotor(frame);
+
+        if (index >= 0 && isSetpoint(frame)) {
+            Motor& motor = motors[index];
+            // A replacement keeps the wait of the one it replaces
+            if (motor.setpoint_pending) {
+                stats.setpoints_replaced++;
+            } else {
+                motor.setpoint_pending = true;
+                motor.setpoint_late = false;
+                motor.setpoint_us = -1;
+            }
+            motor.setpoint = frame;
+            continue;
+        }
+
+        // Control frames keep their order; refusing one refuses the rest
+        if (control_count == MAX_CONTROL) {
+            stats.control_refused += count - n;
+            return n;
+        }
+        if (index >= 0) {
+            Motor& motor = motors[index];
+            // An older setpoint would otherwise go out after this frame
+            if (motor.setpoint_pending) {
+                motor.setpoint_pending = false;
+                stats.setpoints_replaced++;
+            }
+        }
+        control[(control_head + control_count) % MAX_CONTROL] = frame;
+        control_count++;
+    }
+    return count;
+}
+
+void CanScheduler::updateStatus(int64_t now_us) {
+    for (int i = 0; i < config.motor_count; i++) {
+        Motor& motor = motors[i];
+
+        if (motor.setpoint_pending) {
+            if (motor.setpoint_us < 0) {
+                motor.setpoint_us = now_us;
+            } else if (!motor.setpoint_late && now_us - motor.setpoint_us >= config.setpoint_deadline_us) {
+                motor.setpoint_late = true;
+                stats.deadline_misses++;
+            }
+        }
+
+        if (motor.status_due_us < 0) {
+            motor.status_due_us = now_us + config.status_period_us;
+            continue;
+        }
+        if (motor.status_pending && motor.answered) {
+            // A command got through first; its reply is the status
+            motor.status_pending = false;
+            stats.status_redundant++;
+        } else if (motor.status_pending && now_us - motor.status_due_us > config.status_deadline_us) {
+            motor.status_pending = false;
+            stats.deadline_misses++;
+        } else if (motor.status_pending || now_us < motor.status_due_us) {
+            continue;
+        } else if (!motor.answered) {
+            motor.status_pending = true;
+            continue;
+        } else {
+            stats.status_redundant++;
+        }
+        motor.answered = false;
+        motor.status_due_us = now_us + config.status_period_us;
+    }
+}
+
+int CanScheduler::flush(int64_t now_us) {
+    stats.flushes++;
+    updateStatus(now_us);
+
+    int room = config.free_slots();
+    if (room > MAX_BATCH) {
+        room = MAX_BATCH;
+    }
+    int count = 0;
+
+    // 1. Control frames, in order, as far as they fit
+    int blocked[MAX_MOTORS] = {};
+    for (int n = 0; n < control_count; n++) {
+        const CanFrame& frame = control[(control_head + n) % MAX_CONTROL];
+        int index = findMotor(frame);
+        if (count < room) {
+            batch[count] = frame;
+            sources[count] = Source::CONTROL;
+            batch_motors[count++] = (int8_t)index;
+        } else if (index >= 0) {
+            blocked[index]++;
+        }
+    }
+
+    // 2. Setpoints of motors with no control frame left behind
+    for (int k = 0; k < config.motor_count && count < room; k++) {
+        int i = (next_setpoint + k) % config.motor_count;
+        if (motors[i].setpoint_pending && !blocked[i]) {
+            batch[count] = motors[i].setpoint;
+            sources[count] = Source::SETPOINT;
+            batch_motors[count++] = (int8_t)i;
+        }
+    }
+    next_setpoint = config.motor_count ? (next_setpoint + 1) % config.motor_count : 0;
+
+    // 3. Status requests, earliest deadline first
+    bool taken[MAX_MOTORS] = {};
+    while (count < room) {
+        int earliest = -1;
+        for (int i = 0; i < config.motor_count; i++) {
+            if (motors[i].status_pending && !taken[i] && !blocked[i] &&
+                (earliest < 0 || motors[i].status_due_us < motors[earliest].status_due_us)) {
+                earliest = i;
+            }
+        }
+        if (earliest < 0) {
+            break;
+        }
+        taken[earliest] = true;
+        cybergear::encode_request_status(&batch[count], config.master_id, config.motor_ids[earliest]);
+        sources[count] = Source::STATUS;
+        batch_motors[count++] = (int8_t)earliest;
+    }
+
+    int sent = count ? config.transmit(batch, count) : 0;
+    if (sent < 0) {
+        sent = 0;
+    }
+    commit(sent, now_us);
+
+    uint32_t backlog = (uint32_t)getBacklog();
+    if (backlog > stats.max_backlog) {
+        stats.max_backlog = backlog;
+    }
+    return sent;
+}
+
+void CanScheduler::commit(int sent, int64_t now_us) {
+    // Frames the driver took leave the queues; the rest wait for the next flush
+    for (int n = 0; n < sent; n++) {
+        int index = batch_motors[n];
+        Motor* motor = index >= 0 ? &motors[index] : nullptr;
+        switch (sources[n]) {
+            case Source::CONTROL:
+                control_head = (control_head + 1) % MAX_CONTROL;
+                control_count--;
+                stats.control_sent++;
+                if (motor) {
+                    motor->answered = true;
+                }
+                break;
+            case Source::SETPOINT:
+                motor->setpoint_pending = false;
+                motor->answered = true;
+                stats.setpoints_sent++;
+                break;
+            case Source::STATUS:
+                motor->status_pending = false;
+                motor->answered = false;
+                motor->status_due_us = now_us + config.status_period_us;
+                stats.status_sent++;
+                break;
+        }
+    }
+}
+
+int CanScheduler::getBacklog() const {
+    int backlog = control_count;
+    for (int i = 0; i < config.motor_count; i++) {
+        backlog += (motors[i].setpoint_pending ? 1 : 0) + (motors[i].status_pending ? 1 : 0);
+    }
+    return backlog;
+}
+
+CanScheduler::Stats CanScheduler::takeStats() {
+    Stats snapshot = stats;
+    stats = {};
+    return snapshot;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "can_frame.hpp"
+
+// ============================================================================
+// CanScheduler - Prioritized, coalescing transmit queue for the motor bus
+// ============================================================================
+// Stands between the command side and the driver: submit() takes frames
+// with a bus transmit's contract (MotorController's hook) but only queues
+// them, and flush() packs what fits into the driver's TX queue once per
+// cycle, highest priority first:
+//   1. control frames (stop, enable, parameter writes), in order, never
+//      dropped
+//   2. setpoints (speed / position / current references and MOTION), one
+//      slot per motor: a newer setpoint replaces one not yet sent. A
+//      motor's setpoint waits while control frames for it are queued, and
+//      a control frame discards the older setpoint still waiting.
+//   3. status requests, one per motor every status_period_us, earliest
+//      deadline first. A request is redundant (dropped) when any other
+//      frame went to the motor in the period, since every command is
+//      answered with feedback.
+// A motor left waiting for a setpoint setpoint_deadline_us after one was
+// submitted (replacements keep the wait), or a status request not sent
+// status_deadline_us after falling due, counts as a deadline miss (the
+// setpoint is kept, being the latest; the request is dropped).
+//
+// Setpoints are not compared with the last one sent: a setpoint identical to
+// it goes out like any other. Each one is answered with feedback, and that
+// reply is what position tracking and the supervisor run on every cycle;
+// dropping repeats would leave them on status requests at status_period_us.
+// Single task: submit() and flush() from the command task only.
+class CanScheduler {
+public:
+    static constexpr int MAX_MOTORS = 4;
+    static constexpr int MAX_CONTROL = 32;
+    static constexpr int MAX_BATCH = MAX_CONTROL + 2 * MAX_MOTORS;
+
+    // Queue frames for transmission; returns how many were accepted
+    typedef std::function<int(const CanFrame* frames, int count)> transmit_fn;
+    // Room left in the driver's TX queue
+    typedef std::function<int()> free_slots_fn;
+
+    struct Config {
+        uint8_t master_id;
+        int motor_count;
+        uint8_t motor_ids[MAX_MOTORS];
+        int64_t setpoint_deadline_us;
+        int64_t status_period_us;
+        int64_t status_deadline_us;
+        transmit_fn transmit;
+        free_slots_fn free_slots;
+    };
+
+    struct Stats {
+        uint32_t flushes;
+        uint32_t control_sent;
+        uint32_t setpoints_sent;
+        uint32_t status_sent;
+        uint32_t setpoints_replaced;   // Superseded (or cancelled by a control frame) unsent
+        uint32_t status_redundant;     // Motor already answering commands
+        uint32_t control_refused;      // Control queue full
+        uint32_t deadline_misses;
+        uint32_t max_backlog;          // Frames left waiting after a flush
+    };
+
+    explicit CanScheduler(const Config& config);
+
+    int submit(const CanFrame* frames, int count);
+
+    // Pack waiting frames into the driver's TX queue; returns frames sent
+    int flush(int64_t now_us);
+
+    // Frames waiting for the bus
+    int getBacklog() const;
+
+    // Snapshot and reset statistics
+    Stats takeStats();
+
+private:
+    enum class Source : uint8_t {
+        CONTROL,
+        SETPOINT,
+        STATUS,
+    };
+
+    struct Motor {
+        bool setpoint_pending;
+        bool setpoint_late;            // Miss already counted
+        CanFrame setpoint;
+        int64_t setpoint_us;           // Waiting since (-1: the next flush)
+        bool answered;                 // A frame went out since the last status period
+        int64_t status_due_us;         // Next request falls due (-1: not started)
+        bool status_pending;
+    };
+
+    Config config;
+    CanFrame control[MAX_CONTROL];
+    int control_head;
+    int control_count;
+    Motor motors[MAX_MOTORS];
+    int next_setpoint;                 // Round-robin start, so no motor always goes last
+    CanFrame batch[MAX_BATCH];
+    Source sources[MAX_BATCH];
+    int8_t batch_motors[MAX_BATCH];
+    Stats stats;
+
+    int findMotor(const CanFrame& frame) const;
+    static bool isSetpoint(const CanFrame& frame);
+    void updateStatus(int64_t now_us);
+    void commit(int sent, int64_t now_us);
+};
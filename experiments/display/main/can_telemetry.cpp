@@ -0,0 +1,222 @@
+#include "can_telemetry.hpp"
+#include <cstring>
+#include "cybergear.hpp"
+
+using cybergear::CommType;
+
+CanTelemetry::CanTelemetry(const Config& config_param)
+    : config(config_param), tx_queue_high_water(0), status(), window_start(), have_status(false),
+      window_start_us(-1), report() {
+    if (config.motor_count > MAX_MOTORS) {
+        config.motor_count = MAX_MOTORS;
+    }
+}
+
+uint32_t CanTelemetry::frameBits(const CanFrame& frame) {
+    // SOF..CRC is 54 bits extended (34 standard) plus the data and can be
+    // stuffed; CRC delimiter, ACK, EOF and intermission add 13
+    uint32_t stuffed = (frame.extended ? 54 : 34) + 8 * frame.len;
+    return stuffed + stuffed / 10 + 13;
+}
+
+int CanTelemetry::findMotor(uint8_t can_id) const {
+    for (int i = 0; i < config.motor_count; i++) {
+        if (config.motor_ids[i] == can_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Single writer per table: a new identifier takes the first free entry
+void CanTelemetry::count(IdTable* table, const CanFrame& frame) {
+    uint32_t key = (frame.id & config.id_mask) | KEY_USED;
+    table->frames.fetch_add(1, std::memory_order_relaxed);
+    table->bits.fetch_add(frameBits(frame), std::memory_order_relaxed);
+    for (IdCounter& entry : table->entries) {
+        uint32_t current = entry.key.load(std::memory_order_relaxed);
+        if (current == 0) {
+            entry.key.store(key, std::memory_order_release);
+            current = key;
+        }
+        if (current == key) {
+            entry.frames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    table->untracked.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CanTelemetry::onTransmit(const CanFrame* frames, int count_param, int64_t now_us) {
+    for (int i = 0; i < count_param; i++) {
+        const CanFrame& frame = frames[i];
+        count(&tx, frame);
+
+        // Every command to a motor is answered
+        int motor = frame.extended ? findMotor(frame.id & 0xFF) : -1;
+        if (motor < 0) {
+            continue;
+        }
+        Pending& queue = pending[motor];
+        uint32_t head = queue.head.load(std::memory_order_relaxed);
+        if (head - queue.tail.load(std::memory_order_acquire) < MAX_PENDING) {
+            queue.sent_us[head % MAX_PENDING] = now_us;
+            queue.head.store(head + 1, std::memory_order_release);
+        } else {
+            queue.lost++;  // A motor this far behind isn't answering
+        }
+    }
+}
+
+void CanTelemetry::onStatus(const CanBusStatus& status_param) {
+    status = status_param;
+    if (!have_status) {
+        window_start = status;
+        have_status = true;
+    }
+    if (status.msgs_to_tx > tx_queue_high_water) {
+        tx_queue_high_water = status.msgs_to_tx;
+    }
+}
+
+// Receive side: drop commands whose reply is overdue (roll() counts them)
+void CanTelemetry::settle(Pending* queue, int64_t now_us) {
+    uint32_t tail = queue->tail.load(std::memory_order_relaxed);
+    uint32_t head = queue->head.load(std::memory_order_acquire);
+    while (tail != head && now_us - queue->sent_us[tail % MAX_PENDING] > config.reply_timeout_us) {
+        tail++;
+    }
+    queue->tail.store(tail, std::memory_order_release);
+}
+
+// Command side: count overdue commands once each, whether or not the
+// receive side has dropped them yet (only this side overwrites sent_us)
+void CanTelemetry::expire(Pending* queue, int64_t now_us) {
+    uint32_t head = queue->head.load(std::memory_order_relaxed);
+    uint32_t index = queue->tail.load(std::memory_order_acquire);
+    if ((int32_t)(queue->expired - index) > 0) {
+        index = queue->expired;
+    }
+    while (index != head && now_us - queue->sent_us[index % MAX_PENDING] > config.reply_timeout_us) {
+        index++;
+        queue->lost++;
+    }
+    queue->expired = index;
+}
+
+void CanTelemetry::onReceive(const CanFrame& frame, int64_t now_us) {
+    count(&rx, frame);
+
+    CommType type = cybergear::comm_type(frame);
+    if (!frame.extended || (type != CommType::FEEDBACK && type != CommType::READ_PARAM)) {
+        return;
+    }
+    int motor = findMotor((frame.id >> 8) & 0xFF);
+    if (motor < 0) {
+        return;
+    }
+    Pending& queue = pending[motor];
+    settle(&queue, now_us);
+    uint32_t tail = queue.tail.load(std::memory_order_relaxed);
+    if (tail == queue.head.load(std::memory_order_acquire)) {
+        return;  // Unsolicited, or its command went untracked
+    }
+    uint32_t rtt = (uint32_t)(now_us - queue.sent_us[tail % MAX_PENDING]);
+    queue.tail.store(tail + 1, std::memory_order_release);
+
+    queue.samples.fetch_add(1, std::memory_order_relaxed);
+    queue.total_us.fetch_add(rtt, std::memory_order_relaxed);
+    if (rtt < queue.min_us.load(std::memory_order_relaxed)) {
+        queue.min_us.store(rtt, std::memory_order_relaxed);
+    }
+    if (rtt > queue.max_us.load(std::memory_order_relaxed)) {
+        queue.max_us.store(rtt, std::memory_order_relaxed);
+    }
+}
+
+void CanTelemetry::collect(IdTable* table, bool received, float seconds, Report* out) {
+    for (IdCounter& entry : table->entries) {
+        uint32_t key = entry.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            break;
+        }
+        uint32_t frames = entry.frames.exchange(0, std::memory_order_relaxed);
+        if (frames && out->id_count < 2 * MAX_IDS) {
+            out->ids[out->id_count++] = {key & ~KEY_USED, received, frames / seconds};
+        }
+    }
+    out->untracked_frames += table->untracked.exchange(0, std::memory_order_relaxed);
+}
+
+bool CanTelemetry::roll(int64_t now_us, int64_t window_us) {
+    if (window_start_us < 0) {
+        window_start_us = now_us;
+        return false;
+    }
+    int64_t elapsed = now_us - window_start_us;
+    if (elapsed < window_us) {
+        return false;
+    }
+    float seconds = elapsed * 1e-6f;
+
+    Report next = {};
+    next.window_us = elapsed;
+    uint32_t tx_frames = tx.frames.exchange(0, std::memory_order_relaxed);
+    uint32_t rx_frames = rx.frames.exchange(0, std::memory_order_relaxed);
+    uint32_t bits = tx.bits.exchange(0, std::memory_order_relaxed) + rx.bits.exchange(0, std::memory_order_relaxed);
+    next.load_pct = 100.0f * bits / (config.bitrate * seconds);
+    next.tx_per_second = tx_frames / seconds;
+    next.rx_per_second = rx_frames / seconds;
+    next.tx_queue_high_water = tx_queue_high_water;
+    tx_queue_high_water = status.msgs_to_tx;
+    collect(&tx, false, seconds, &next);
+    collect(&rx, true, seconds, &next);
+
+    for (int i = 0; i < config.motor_count; i++) {
+        Pending& queue = pending[i];
+        RoundTrip& trip = next.round_trip[i];
+        expire(&queue, now_us);
+        trip.samples = queue.samples.exchange(0, std::memory_order_relaxed);
+        trip.lost = queue.lost;
+        queue.lost = 0;
+        uint32_t total = queue.total_us.exchange(0, std::memory_order_relaxed);
+        trip.min_us = queue.min_us.exchange(UINT32_MAX, std::memory_order_relaxed);
+        trip.max_us = queue.max_us.exchange(0, std::memory_order_relaxed);
+        trip.avg_us = trip.samples ? total / trip.samples : 0;
+        if (!trip.samples) {
+            trip.min_us = 0;
+        }
+    }
+
+    next.status = status;
+    next.bus_errors = status.bus_error_count - window_start.bus_error_count;
+    next.tx_failed = status.tx_failed_count - window_start.tx_failed_count;
+    next.rx_missed = status.rx_missed_count - window_start.rx_missed_count;
+    next.arb_lost = status.arb_lost_count - window_start.arb_lost_count;
+    window_start = status;
+    window_start_us = now_us;
+
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&report, &next, sizeof(report));
+    sequence.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+bool CanTelemetry::read(Report* out) const {
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (!(before & 1)) {
+            memcpy(out, &report, sizeof(*out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
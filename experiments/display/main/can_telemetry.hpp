@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "can_frame.hpp"
+
+// Controller state and counters as twai_get_status_info() reports them
+// (the error counters are cumulative)
+struct CanBusStatus {
+    bool bus_off;
+    uint32_t msgs_to_tx;
+    uint32_t msgs_to_rx;
+    uint32_t tx_error_counter;
+    uint32_t rx_error_counter;
+    uint32_t tx_failed_count;
+    uint32_t rx_missed_count;   // FIFO full and overruns
+    uint32_t arb_lost_count;
+    uint32_t bus_error_count;
+};
+
+// ============================================================================
+// CanTelemetry - Bus load, per-ID rates, queue depth and round-trip times
+// ============================================================================
+// Fed from both sides of the bus: onTransmit() with every batch the driver
+// accepted and onStatus() with the controller's counters after it (command
+// task), onReceive() with every received frame (receive dispatcher). Each
+// side only writes its own counters, so feeding costs a few relaxed atomic
+// adds per frame.
+//
+// roll() closes a window and turns the counters into a Report:
+//   - frames per second for each identifier, masked with id_mask so status
+//     bits in CyberGear's identifier data field don't split one sender
+//   - bus load: estimated wire bits of every frame over the bitrate
+//   - TX queue high-water (sampled after each batch)
+//   - round-trip time from a command to its motor's reply; replies are
+//     matched to commands in order, and commands unanswered after
+//     reply_timeout_us (or with MAX_PENDING already outstanding) count as
+//     lost
+//   - controller error counters over the window, and the latest state
+// Reports are published behind a seqlock for any number of readers (log,
+// dev-mode UI); the writer runs in roll() only.
+class CanTelemetry {
+public:
+    static constexpr int MAX_IDS = 24;      // Per direction
+    static constexpr int MAX_MOTORS = 4;
+    static constexpr int MAX_PENDING = 16;  // Commands awaiting a reply, per motor
+    static constexpr int MAX_READ_ATTEMPTS = 64;
+
+    struct Config {
+        uint32_t bitrate;
+        uint32_t id_mask;
+        int motor_count;
+        uint8_t motor_ids[MAX_MOTORS];
+        int64_t reply_timeout_us;
+    };
+
+    struct IdRate {
+        uint32_t id;            // Masked
+        bool received;          // Else transmitted
+        float per_second;
+    };
+
+    struct RoundTrip {
+        uint32_t samples;
+        uint32_t lost;
+        uint32_t min_us;
+        uint32_t avg_us;
+        uint32_t max_us;
+    };
+
+    struct Report {
+        int64_t window_us;
+        float load_pct;
+        float tx_per_second;
+        float rx_per_second;
+        uint32_t tx_queue_high_water;
+        int id_count;
+        IdRate ids[2 * MAX_IDS];
+        uint32_t untracked_frames;  // Identifier tables full
+        RoundTrip round_trip[MAX_MOTORS];
+        CanBusStatus status;        // Latest
+        uint32_t bus_errors;        // Over the window
+        uint32_t tx_failed;
+        uint32_t rx_missed;
+        uint32_t arb_lost;
+    };
+
+    explicit CanTelemetry(const Config& config);
+
+    // Command side
+    void onTransmit(const CanFrame* frames, int count, int64_t now_us);
+    void onStatus(const CanBusStatus& status);
+
+    // Receive side
+    void onReceive(const CanFrame& frame, int64_t now_us);
+
+    // Publish a report once window_us has passed since the last one (call
+    // from the command side); true when a new report was published
+    bool roll(int64_t now_us, int64_t window_us);
+
+    // Copy the latest report; false before the first (or under contention)
+    bool read(Report* report) const;
+
+    // Wire bits of a frame, stuff bits estimated at one in ten
+    static uint32_t frameBits(const CanFrame& frame);
+
+private:
+    struct IdCounter {
+        std::atomic<uint32_t> key{0};       // Masked id | KEY_USED, 0 = free
+        std::atomic<uint32_t> frames{0};
+    };
+
+    struct IdTable {
+        IdCounter entries[MAX_IDS];
+        std::atomic<uint32_t> untracked{0};
+        std::atomic<uint32_t> frames{0};
+        std::atomic<uint32_t> bits{0};
+    };
+
+    // Command timestamps, pushed by the command side and popped by the
+    // receive side (single producer, single consumer)
+    struct Pending {
+        int64_t sent_us[MAX_PENDING];
+        std::atomic<uint32_t> head{0};
+        std::atomic<uint32_t> tail{0};
+        uint32_t expired = 0;               // Command side: counted up to here
+        uint32_t lost = 0;
+        std::atomic<uint32_t> samples{0};
+        std::atomic<uint32_t> total_us{0};
+        std::atomic<uint32_t> min_us{UINT32_MAX};
+        std::atomic<uint32_t> max_us{0};
+    };
+
+    static constexpr uint32_t KEY_USED = 0x80000000;
+
+    Config config;
+    IdTable tx;
+    IdTable rx;
+    Pending pending[MAX_MOTORS];
+
+    // Command side only
+    uint32_t tx_queue_high_water;
+    CanBusStatus status;
+    CanBusStatus window_start;
+    bool have_status;
+    int64_t window_start_us;
+
+    std::atomic<uint32_t> sequence{0};  // Odd while a report is written
+    Report report;
+
+    int findMotor(uint8_t can_id) const;
+    void count(IdTable* table, const CanFrame& frame);
+    void collect(IdTable* table, bool received, float seconds, Report* out);
+    void settle(Pending* queue, int64_t now_us);
+    void expire(Pending* queue, int64_t now_us);
+};
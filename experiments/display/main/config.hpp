@@ -102,12 +102,26 @@ struct MonitorStates {
     bool sensors = false;
     bool lock = false;
     bool battery = false;
+    int bus_load_pct = -1;  // CAN bus load shown in dev mode, -1 = none yet
 };
 
 // ============================================================================
 // Mode Configuration
 // ============================================================================
 
+enum class OperationMode {
+    UP_DOWN = 0,    // Manual up/down control
+    ROLL,           // Roll adjustment
+    PITCH,          // Pitch adjustment
+    TORSION,        // Torsion adjustment
+    LEVEL,          // Level mode
+    MOTOR_1,        // Individual motor 1 control
+    MOTOR_2,        // Individual motor 2 control
+    MOTOR_3,        // Individual motor 3 control
+    MOTOR_4,        // Individual motor 4 control
+    MODE_COUNT      // For cycling - must be last
+};
+
 struct ModeConfig {
     const char* name;            // Display name for the mode
     const char* icon_file;       // Icon filename (without path, from ../icons/)
@@ -120,7 +134,7 @@ struct ModeConfig {
 };
 
 // Mode configurations indexed by OperationMode enum
-static const ModeConfig MODE_CONFIGS[] = {
+static constexpr ModeConfig MODE_CONFIGS[] = {
     // Index 0: UP_DOWN
     {
         .name = "Up/Down",
@@ -231,6 +245,9 @@ static const ModeConfig MODE_CONFIGS[] = {
     }
 };
 
+static_assert(sizeof(MODE_CONFIGS) / sizeof(MODE_CONFIGS[0]) == (int)OperationMode::MODE_COUNT,
+              "MODE_CONFIGS must have one entry per OperationMode");
+
 // ============================================================================
 // UI Color Scheme
 // ============================================================================
@@ -310,8 +327,171 @@ static const ModeConfig MODE_CONFIGS[] = {
 // Timing Configuration
 // ============================================================================
 #define DEBOUNCE_DELAY_MS 50
+
+// Button input path: 0 = per-pin GPIO_INTR_ANYEDGE interrupts,
+// 1 = gptimer scanner with bit-parallel debounce (see button_scanner.hpp)
+#define BUTTON_SCANNER_ENABLED 0
+#define BUTTON_SCAN_RATE_HZ 1000  // Scan rate; debounce window is 4 samples
 #define STARTUP_ANIMATION_FRAME_DELAY_MS 4
 
+// Actuator sequencing (see actuator_sequencer.hpp)
+#define LOCK_RELEASE_DELAY_MS 100  // Unlock -> motor start, locks need to clear
+#define MOTOR_STOP_DELAY_MS   300  // Motor stop -> lock, covers the planned deceleration
+#define MOTOR_SPIN_PERIOD_MS  50   // Motor command refresh while a button is held
+
+// CyberGear motors on the CAN bus (see motor_controller.hpp). Index 0..3 is
+// MOTOR_1..4; Up/Down drives all four together.
+#define MOTOR_COUNT            4
+#define MOTOR_CAN_IDS          {1, 2, 3, 4}
+#define MOTOR_DIRECTIONS       {1, 1, 1, 1}   // -1 for motors mounted mirrored
+#define MOTOR_CAN_MASTER_ID    0
+#define MOTOR_CYCLE_MS         20    // Command batch period
+#define MOTOR_SPEED_RAD_S      5.0f  // Up/Down and single-motor speed
+#define MOTOR_ACCEL_RAD_S2     20.0f // Ramp up / down (see trajectory_planner.hpp)
+#define MOTOR_HOLD_TRAVEL_RAD  1000.0f  // Planned travel while a button is held
+#define MOTOR_CURRENT_LIMIT_A  5.0f
+#define MOTOR_STOP_CYCLES      3     // Zero-speed cycles before disabling
+#define MOTOR_FEEDBACK_MAX_AGE_MS  200  // Feedback older than this: motor not answering
+
+// Homing (see motor_homing.hpp): Down in Up/Down with the positions not
+// referenced drives all motors to the bottom stops together. Until then
+// moves creep, bounded only by one stroke either way from the boot position;
+// referenced, they run at MOTOR_SPEED_RAD_S within the soft limits.
+#define MOTOR_CREEP_RAD_S          1.0f
+#define MOTOR_HOMING_RAD_S         1.5f   // Towards the stops
+#define MOTOR_HOMING_STALL_RAD_S   0.5f   // At the stop: speed below...
+#define MOTOR_HOMING_STALL_NM      2.0f   // ...or torque above (well under the current limit's)
+#define MOTOR_HOMING_STALL_SAMPLES 3      // ...for this many feedback frames
+#define MOTOR_HOMING_SPINUP_MS     300
+#define MOTOR_HOMING_TIMEOUT_MS    120000 // A full stroke at MOTOR_HOMING_RAD_S is 100 s
+#define ACTUATOR_SOFT_MARGIN_MM    5.0f   // Soft limits inside the stops (default, kept in NVS)
+
+// Stall / overload supervision on planned moves (see motor_supervisor.hpp).
+// Lag is joint rad behind the setpoint on the tracked positions.
+#define MOTOR_OVERLOAD_NM          2.5f   // Close to the current limit's torque
+#define MOTOR_STALL_SPEED_RATIO    0.3f   // Stalled below this fraction of the command
+#define MOTOR_STALL_MIN_RAD_S      0.3f   // Slower commands aren't judged
+#define MOTOR_STALL_SAMPLES        3      // Feedback frames in a row to detect either
+#define MOTOR_LAG_DEADBAND_RAD     0.3f   // Normal lag at full speed, left alone
+#define MOTOR_LAG_SLOWDOWN_PER_RAD 1.0f   // Move slowdown per rad of worst lag past it
+#define MOTOR_CATCH_UP_GAIN        4.0f   // 1/s towards the setpoint past the deadband
+#define MOTOR_CATCH_UP_RAD_S       1.0f   // Most extra speed to catch up
+#define MOTOR_BALANCE_MIN_SCALE    0.0f   // Slowest the move gets (0: leaders wait)
+#define MOTOR_BALANCE_RATE         5.0f   // Move speed scale change per second
+#define MOTOR_STALL_TIMEOUT_MS     1500   // Stalled this long: abort the move
+
+// CAN telemetry (see can_telemetry.hpp). The identifier mask keeps the
+// communication type and both addresses, dropping CyberGear's fault and
+// mode bits.
+#define CAN_TELEMETRY_WINDOW_MS  1000
+#define CAN_TELEMETRY_ID_MASK    0x1F00FFFF
+#define CAN_REPLY_TIMEOUT_MS     100   // Command unanswered this long counts as lost
+
+// CAN transmit scheduling (see can_scheduler.hpp). Moving motors answer
+// every setpoint, so status requests only go to idle ones. Frames handed to
+// the driver can no longer be replaced, so at most CAN_TX_IN_FLIGHT (up to
+// CAN_TX_QUEUE_LEN) are.
+#define CAN_SETPOINT_DEADLINE_MS  MOTOR_CYCLE_MS  // Setpoint still queued a cycle later: missed
+#define CAN_STATUS_PERIOD_MS      100   // Feedback from every motor at least this often
+#define CAN_STATUS_DEADLINE_MS    50    // Status request not sent this late: missed
+#define CAN_TX_IN_FLIGHT          20    // A full start batch for four motors
+
+// Frame geometry (see frame_kinematics.hpp): actuator spacing, stroke, lift
+// per motor radian and each motor's corner (+1 front / -1 rear, +1 left /
+// -1 right)
+#define FRAME_LENGTH_MM        2000.0f
+#define FRAME_WIDTH_MM         1400.0f
+#define ACTUATOR_STROKE_MM     300.0f
+#define ACTUATOR_MM_PER_RAD    2.0f
+#define MOTOR_PITCH_SIGNS      {1, 1, -1, -1}
+#define MOTOR_ROLL_SIGNS       {1, -1, 1, -1}
+
+// Roll / Pitch / Torsion: pose change per button press
+#define ADJUST_STEP_DEG        0.5f
+
+// LEVEL mode closed loop (see level_controller.hpp), run every motor cycle
+#define LEVEL_KP               0.8f    // deg/s per deg
+#define LEVEL_KI               0.1f    // deg/s per deg*s
+#define LEVEL_MAX_RATE_DPS     0.5f    // Frame tilt rate limit
+#define LEVEL_MAX_ACCEL_DPS2   1.0f    // Tilt rate slew limit
+#define LEVEL_TOLERANCE_DEG    0.1f
+#define LEVEL_SETTLE_MS        1000    // Time within tolerance to finish
+#define LEVEL_TIMEOUT_MS       60000
+#define LEVEL_ATTITUDE_MAX_AGE_MS  500 // Give up if the estimate stops updating
+
+
+// ============================================================================
+// Accelerometer Sampling
+// ============================================================================
+// Sensors stream into their FIFOs at the data rate; the task drains both
+// FIFOs every period (FIFO holds 32 samples, so period must stay < 32 / rate)
+// High rate: sample at 800 Hz so motor vibration can be filtered out before
+// decimating to the 100 Hz control rate (instead of aliasing into it)
+#define ACCEL_HIGH_RATE       0
+
+#if ACCEL_HIGH_RATE
+#define ACCEL_RATE_CODE       adxl345::RATE_800_HZ
+#define ACCEL_FIFO_WATERMARK  24   // Samples (one task period at 800 Hz)
+#define ACCEL_TASK_PERIOD_MS  30
+#define ACCEL_DECIMATION      8    // 800 Hz -> 100 Hz
+#else
+#define ACCEL_RATE_CODE       adxl345::RATE_100_HZ
+#define ACCEL_FIFO_WATERMARK  10   // Samples (one task period at 100 Hz)
+#define ACCEL_TASK_PERIOD_MS  100
+#define ACCEL_DECIMATION      1
+#endif
+
+// Adaptive sampling (see sampling_policy.hpp): the rate above is the FULL
+// level, used in the attitude modes and while motors run. Idle in Up/Down the
+// sensors drop to a lower rate with a longer task period (same samples per
+// drain), or to standby when nothing needs motion detection.
+#define ACCEL_ADAPTIVE_SAMPLING     1
+#define ACCEL_REDUCED_RATE_CODE     adxl345::RATE_25_HZ
+#define ACCEL_REDUCED_PERIOD_MS     400
+#define ACCEL_LOW_RATE_CODE         adxl345::RATE_12_5_HZ
+#define ACCEL_LOW_PERIOD_MS         800
+#define ACCEL_IDLE_WATERMARK        10    // Samples per drain below FULL
+#define ACCEL_BUSY_RMS_MG           20.0f // Vibration that counts as movement
+#define ACCEL_QUIET_RMS_MG          10.0f // Below this the frame is quiet
+#define ACCEL_QUIET_HOLD_MS         5000  // Quiet time before LOW
+#define ACCEL_MOTOR_SETTLE_MS       2000  // FULL kept after the motors stop
+#define ACCEL_STANDBY_HOLD_MS       30000 // LOW time before standby
+#define ACCEL_STANDBY_ALLOWED       (!ACCEL_WAKE_ON_MOTION)  // Activity detection needs measurement
+
+// Decimating FIR: taps (multiple of 8) and -6 dB point as a fraction of the
+// output rate (0.25 -> 25 Hz, everything folding onto 0..25 Hz is >70 dB down)
+#define ACCEL_DECIMATOR_TAPS    64
+#define ACCEL_DECIMATOR_CUTOFF  0.25f
+
+// Attitude low-pass bandwidth (lower = steadier bubble, more lag;
+// 63% of a step after 1 / (2 * pi * cutoff) seconds)
+#define ATTITUDE_CUTOFF_HZ    2.0f
+
+// Motion detection: once the frame has been still for ACCEL_INACTIVITY_TIME_S
+// the accelerometer task stops polling and sleeps until an activity
+// interrupt (bump or movement); activity also wakes the chip from deep sleep
+#define ACCEL_WAKE_ON_MOTION        1
+#define ACCEL_ACTIVITY_THRESHOLD    3    // x 62.5 mg (~190 mg change)
+#define ACCEL_INACTIVITY_THRESHOLD  2    // x 62.5 mg
+#define ACCEL_INACTIVITY_TIME_S     10
+
+// I2C fault handling: retries per read, first backoff (doubles per retry),
+// consecutive failures before a bus recovery / taking a sensor offline, and
+// how often an offline sensor is re-initialized
+#define ACCEL_I2C_MAX_RETRIES       2
+#define ACCEL_I2C_BACKOFF_MS        10
+#define ACCEL_I2C_RECOVER_AFTER     3
+#define ACCEL_I2C_OFFLINE_AFTER     10
+#define ACCEL_I2C_PROBE_PERIOD_MS   1000
+#define ACCEL_STALL_CYCLES          10   // Empty FIFO reads before re-init
+
+// Samples averaged per sensor for a LEVEL calibration (~2 s at 100 Hz)
+#define ACCEL_CALIBRATION_SAMPLES  200
+#define ACCEL_CALIBRATION_CLEAR_HOLD_MS  3000  // Holding Down this long in Level clears it
+
+// 1 = integer filter + CORDIC (centi-degrees), 0 = float filter + atan2f
+#define ATTITUDE_FIXED_POINT  1
+
 
 // ============================================================================
 // Helper Macros
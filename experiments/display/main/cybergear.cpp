@@ -0,0 +1,109 @@
+#include "cybergear.hpp"
+#include <cstring>
+
+namespace cybergear {
+
+// Linear map of [-range, range] onto 0..65535 (and back)
+static uint16_t float_to_u16(float value, float range) {
+    if (value > range) {
+        value = range;
+    } else if (value < -range) {
+        value = -range;
+    }
+    return (uint16_t)((value + range) * 65535.0f / (2.0f * range) + 0.5f);
+}
+
+static float u16_to_float(uint16_t value, float range) {
+    return value * (2.0f * range) / 65535.0f - range;
+}
+
+// Motion and feedback payloads are big-endian, parameters little-endian
+static void put_u16_be(uint8_t* data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+static uint16_t get_u16_be(const uint8_t* data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static void init_frame(CanFrame* frame, CommType type, uint16_t id_data, uint8_t motor_id) {
+    frame->id = make_id(type, id_data, motor_id);
+    frame->extended = true;
+    frame->len = 8;
+    memset(frame->data, 0, sizeof(frame->data));
+}
+
+void encode_enable(CanFrame* frame, uint8_t master_id, uint8_t motor_id) {
+    init_frame(frame, CommType::ENABLE, master_id, motor_id);
+}
+
+void encode_stop(CanFrame* frame, uint8_t master_id, uint8_t motor_id, bool clear_faults) {
+    init_frame(frame, CommType::STOP, master_id, motor_id);
+    frame->data[0] = clear_faults ? 1 : 0;
+}
+
+void encode_set_zero(CanFrame* frame, uint8_t master_id, uint8_t motor_id) {
+    init_frame(frame, CommType::SET_ZERO, master_id, motor_id);
+    frame->data[0] = 1;
+}
+
+void encode_write_float(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index, float value) {
+    init_frame(frame, CommType::WRITE_PARAM, master_id, motor_id);
+    frame->data[0] = index & 0xFF;
+    frame->data[1] = index >> 8;
+    memcpy(&frame->data[4], &value, sizeof(value));  // Little-endian on both ends
+}
+
+void encode_write_u8(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index, uint8_t value) {
+    init_frame(frame, CommType::WRITE_PARAM, master_id, motor_id);
+    frame->data[0] = index & 0xFF;
+    frame->data[1] = index >> 8;
+    frame->data[4] = value;
+}
+
+void encode_read_param(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index) {
+    init_frame(frame, CommType::READ_PARAM, master_id, motor_id);
+    frame->data[0] = index & 0xFF;
+    frame->data[1] = index >> 8;
+}
+
+// An empty FEEDBACK-type frame, as position_test's cybergear_request_status
+void encode_request_status(CanFrame* frame, uint8_t master_id, uint8_t motor_id) {
+    init_frame(frame, CommType::FEEDBACK, master_id, motor_id);
+}
+
+void encode_motion(CanFrame* frame, uint8_t motor_id, float torque, float position, float velocity,
+                   float kp, float kd) {
+    // The torque feed-forward rides in the identifier's data field
+    init_frame(frame, CommType::MOTION, float_to_u16(torque, TORQUE_MAX), motor_id);
+    put_u16_be(&frame->data[0], float_to_u16(position, POSITION_MAX));
+    put_u16_be(&frame->data[2], float_to_u16(velocity, VELOCITY_MAX));
+    put_u16_be(&frame->data[4], (uint16_t)(kp / KP_MAX * 65535.0f + 0.5f));
+    put_u16_be(&frame->data[6], (uint16_t)(kd / KD_MAX * 65535.0f + 0.5f));
+}
+
+bool decode_feedback(const CanFrame& frame, Feedback* feedback) {
+    if (!frame.extended || frame.len < 8 || comm_type(frame) != CommType::FEEDBACK) {
+        return false;
+    }
+    feedback->motor_id = (frame.id >> 8) & 0xFF;
+    feedback->faults = (frame.id >> 16) & 0x3F;
+    feedback->state = (MotorState)((frame.id >> 22) & 0x03);
+    feedback->position = u16_to_float(get_u16_be(&frame.data[0]), POSITION_MAX);
+    feedback->velocity = u16_to_float(get_u16_be(&frame.data[2]), VELOCITY_MAX);
+    feedback->torque = u16_to_float(get_u16_be(&frame.data[4]), TORQUE_MAX);
+    feedback->temperature = get_u16_be(&frame.data[6]) * 0.1f;
+    return true;
+}
+
+void encode_feedback(CanFrame* frame, uint8_t master_id, const Feedback& feedback) {
+    uint16_t id_data = feedback.motor_id | ((feedback.faults & 0x3F) << 8) | ((uint16_t)feedback.state << 14);
+    init_frame(frame, CommType::FEEDBACK, id_data, master_id);
+    put_u16_be(&frame->data[0], float_to_u16(feedback.position, POSITION_MAX));
+    put_u16_be(&frame->data[2], float_to_u16(feedback.velocity, VELOCITY_MAX));
+    put_u16_be(&frame->data[4], float_to_u16(feedback.torque, TORQUE_MAX));
+    put_u16_be(&frame->data[6], (uint16_t)(feedback.temperature * 10.0f + 0.5f));
+}
+
+} // namespace cybergear
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include "can_frame.hpp"
+
+// ============================================================================
+// CyberGear - Xiaomi CyberGear micromotor CAN protocol (1 Mbit/s, 29-bit IDs)
+// ============================================================================
+// Identifier layout: bits 28-24 communication type, bits 23-8 type-specific
+// data (usually the master ID), bits 7-0 target motor ID. Encoders fill a
+// CanFrame and decoders read one; nothing here touches a bus.
+namespace cybergear {
+
+enum class CommType : uint8_t {
+    GET_ID = 0,
+    MOTION = 1,         // Operation control: torque, position, velocity, kp, kd
+    FEEDBACK = 2,       // Motor -> master status (reply to every command)
+    ENABLE = 3,
+    STOP = 4,           // Disable; data[0] = 1 also clears faults
+    SET_ZERO = 6,       // Current position becomes mechanical zero
+    SET_CAN_ID = 7,
+    READ_PARAM = 17,
+    WRITE_PARAM = 18,
+    FAULT = 21,
+};
+
+// run_mode values
+enum class RunMode : uint8_t {
+    MOTION = 0,
+    POSITION = 1,
+    SPEED = 2,
+    CURRENT = 3,
+};
+
+// Parameter indices (WRITE_PARAM / READ_PARAM)
+constexpr uint16_t PARAM_RUN_MODE = 0x7005;     // uint8
+constexpr uint16_t PARAM_IQ_REF = 0x7006;       // A, current mode target
+constexpr uint16_t PARAM_SPD_REF = 0x700A;      // rad/s, speed mode target
+constexpr uint16_t PARAM_LIMIT_TORQUE = 0x700B; // Nm
+constexpr uint16_t PARAM_LOC_REF = 0x7016;      // rad, position mode target
+constexpr uint16_t PARAM_LIMIT_SPD = 0x7017;    // rad/s, position mode speed
+constexpr uint16_t PARAM_LIMIT_CUR = 0x7018;    // A, speed/position mode current
+
+// Feedback and MOTION scaling (16-bit values spread over these ranges)
+constexpr float POSITION_MAX = 4.0f * 3.14159265f;   // rad
+constexpr float VELOCITY_MAX = 30.0f;                // rad/s
+constexpr float TORQUE_MAX = 12.0f;                  // Nm
+constexpr float KP_MAX = 500.0f;
+constexpr float KD_MAX = 5.0f;
+
+// FEEDBACK fault bits (identifier bits 21-16)
+constexpr uint8_t FAULT_UNDER_VOLTAGE = 0x01;
+constexpr uint8_t FAULT_OVER_CURRENT = 0x02;
+constexpr uint8_t FAULT_OVER_TEMPERATURE = 0x04;
+constexpr uint8_t FAULT_ENCODER = 0x08;
+constexpr uint8_t FAULT_HALL = 0x10;
+constexpr uint8_t FAULT_UNCALIBRATED = 0x20;
+
+// FEEDBACK mode state (identifier bits 23-22)
+enum class MotorState : uint8_t {
+    RESET = 0,
+    CALIBRATION = 1,
+    RUNNING = 2,
+};
+
+struct Feedback {
+    uint8_t motor_id;
+    MotorState state;
+    uint8_t faults;         // FAULT_* bits
+    float position;         // rad
+    float velocity;         // rad/s
+    float torque;           // Nm
+    float temperature;      // deg C
+};
+
+inline uint32_t make_id(CommType type, uint16_t data, uint8_t motor_id) {
+    return ((uint32_t)type << 24) | ((uint32_t)data << 8) | motor_id;
+}
+
+inline CommType comm_type(const CanFrame& frame) {
+    return (CommType)((frame.id >> 24) & 0x1F);
+}
+
+// Command encoders (master_id goes in the data field of the identifier)
+void encode_enable(CanFrame* frame, uint8_t master_id, uint8_t motor_id);
+void encode_stop(CanFrame* frame, uint8_t master_id, uint8_t motor_id, bool clear_faults);
+void encode_set_zero(CanFrame* frame, uint8_t master_id, uint8_t motor_id);
+void encode_write_float(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index, float value);
+void encode_write_u8(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index, uint8_t value);
+void encode_read_param(CanFrame* frame, uint8_t master_id, uint8_t motor_id, uint16_t index);
+void encode_request_status(CanFrame* frame, uint8_t master_id, uint8_t motor_id);  // Answered with FEEDBACK
+void encode_motion(CanFrame* frame, uint8_t motor_id, float torque, float position, float velocity,
+                   float kp, float kd);
+
+// Decode a FEEDBACK frame (false for anything else)
+bool decode_feedback(const CanFrame& frame, Feedback* feedback);
+
+// FEEDBACK encoder (what a motor sends; used by host fakes)
+void encode_feedback(CanFrame* frame, uint8_t master_id, const Feedback& feedback);
+
+} // namespace cybergear
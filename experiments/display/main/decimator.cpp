@@ -0,0 +1,167 @@
+#include "decimator.hpp"
+#include <cmath>
+#include <cstring>
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#include "dsps_fir.h"
+#define DECIMATOR_USE_ESP_DSP 1
+static fir_s16_t simd_states[3];
+#else
+#define DECIMATOR_USE_ESP_DSP 0
+#endif
+
+// Scalar kernel: same contract as dsps_fird_s16 (out_len outputs from
+// out_len * factor inputs, Q15 taps, rounded and saturated).
+// With the sensor at +/-4g (|x| < 2^12) the int32 accumulator can't overflow.
+static int fird_s16_scalar(const int16_t* coeffs, int taps, int factor,
+                           int16_t* delay, int* pos, const int16_t* input,
+                           int16_t* output, int out_len) {
+    for (int o = 0; o < out_len; o++) {
+        for (int k = 0; k < factor; k++) {
+            int16_t sample = *input++;
+            delay[*pos] = sample;
+            delay[*pos + taps] = sample;
+            *pos = *pos + 1 == taps ? 0 : *pos + 1;
+        }
+
+        // delay[pos .. pos + taps - 1] runs oldest to newest
+        const int16_t* window = &delay[*pos];
+        int32_t acc = 1 << 14;
+        for (int t = 0; t < taps; t++) {
+            acc += (int32_t)coeffs[t] * window[t];
+        }
+        acc >>= 15;
+        output[o] = (int16_t)(acc > INT16_MAX ? INT16_MAX : acc < INT16_MIN ? INT16_MIN : acc);
+    }
+    return out_len;
+}
+
+bool Decimator::init(const Config& config_param) {
+    if (config_param.factor < 1 || config_param.factor > MAX_FACTOR ||
+        (config_param.factor > 1 && (config_param.taps <= 0 || config_param.taps > MAX_TAPS ||
+                                     config_param.taps % 8 != 0))) {
+        return false;
+    }
+    config = config_param;
+
+    if (config.factor > 1) {
+        // Blackman-windowed sinc, cutoff relative to the input rate
+        float fc = config.cutoff / config.factor;
+        float center = (config.taps - 1) / 2.0f;
+        float taps_f[MAX_TAPS];
+        float sum = 0;
+        for (int i = 0; i < config.taps; i++) {
+            float n = i - center;
+            float sinc = n == 0 ? 2.0f * fc : sinf(2.0f * (float)M_PI * fc * n) / ((float)M_PI * n);
+            float phase = 2.0f * (float)M_PI * i / (config.taps - 1);
+            float window = 0.42f - 0.5f * cosf(phase) + 0.08f * cosf(2.0f * phase);
+            taps_f[i] = sinc * window;
+            sum += taps_f[i];
+        }
+
+        // Quantize to Q15 with unity DC gain
+        for (int i = 0; i < config.taps; i++) {
+            coeffs[i] = (int16_t)lrintf(taps_f[i] / sum * 32767.0f);
+        }
+        stopband_db = measureStopband();
+    } else {
+        stopband_db = 0;
+    }
+
+    reset();
+    return true;
+}
+
+void Decimator::reset() {
+    for (int a = 0; a < 3; a++) {
+        Axis& axis = axes[a];
+        memset(axis.delay, 0, sizeof(axis.delay));
+        axis.staged_count = 0;
+        axis.pos = 0;
+#if DECIMATOR_USE_ESP_DSP
+        if (config.factor > 1) {
+            if (axis.simd_state) {
+                dsps_fird_s16_aexx_free(&simd_states[a]);
+            }
+            // Taps are symmetric, so the kernel's coefficient order doesn't matter
+            dsps_fird_init_s16(&simd_states[a], coeffs, axis.delay, config.taps, config.factor, 0, 0);
+            axis.simd_state = &simd_states[a];
+        }
+#endif
+    }
+    input_count = 0;
+}
+
+uint32_t Decimator::takeInputCount() {
+    uint32_t count = input_count;
+    input_count = 0;
+    return count;
+}
+
+int Decimator::processAxis(Axis* axis, const int16_t* in, int count, int16_t* out) {
+    // Stage the new samples behind any left over from the last block
+    memcpy(&axis->staged[axis->staged_count], in, count * sizeof(int16_t));
+    axis->staged_count += count;
+
+    int out_len = axis->staged_count / config.factor;
+#if DECIMATOR_USE_ESP_DSP
+    dsps_fird_s16((fir_s16_t*)axis->simd_state, axis->staged, out, out_len);
+#else
+    fird_s16_scalar(coeffs, config.taps, config.factor, axis->delay, &axis->pos,
+                    axis->staged, out, out_len);
+#endif
+
+    int used = out_len * config.factor;
+    axis->staged_count -= used;
+    memmove(axis->staged, &axis->staged[used], axis->staged_count * sizeof(int16_t));
+    return out_len;
+}
+
+void Decimator::process(const AccelBlock& in, AccelBlock* out) {
+    out->timestamp_us = in.timestamp_us;
+    out->sample_period_us = in.sample_period_us * config.factor;
+
+    if (config.factor == 1) {
+        out->count = in.count;
+        memcpy(out->x, in.x, in.count * sizeof(int16_t));
+        memcpy(out->y, in.y, in.count * sizeof(int16_t));
+        memcpy(out->z, in.z, in.count * sizeof(int16_t));
+        return;
+    }
+
+    int count = in.count;
+    if (count > adxl345::FIFO_DEPTH) {
+        count = adxl345::FIFO_DEPTH;
+    }
+    input_count += count;
+
+    // All axes stage the same counts, so they yield the same output count
+    out->count = processAxis(&axes[0], in.x, count, out->x);
+    processAxis(&axes[1], in.y, count, out->y);
+    processAxis(&axes[2], in.z, count, out->z);
+}
+
+// Max |H(f)| over [(1 - cutoff) * f_out, f_in / 2]: everything there folds
+// onto the 0..cutoff band after decimation
+float Decimator::measureStopband() const {
+    const int points = 512;
+    float f_start = (1.0f - config.cutoff) / config.factor;
+    float worst = 0;
+    for (int p = 0; p <= points; p++) {
+        float f = f_start + (0.5f - f_start) * p / points;
+        float re = 0, im = 0;
+        for (int i = 0; i < config.taps; i++) {
+            re += coeffs[i] * cosf(2.0f * (float)M_PI * f * i);
+            im -= coeffs[i] * sinf(2.0f * (float)M_PI * f * i);
+        }
+        float gain = sqrtf(re * re + im * im) / 32768.0f;
+        if (gain > worst) {
+            worst = gain;
+        }
+    }
+    return 20.0f * log10f(worst > 1e-7f ? worst : 1e-7f);
+}
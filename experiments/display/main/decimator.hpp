@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include "accel_sensor.hpp"
+
+// ============================================================================
+// Decimator - Anti-alias low-pass and rate reduction for AccelBlocks
+// ============================================================================
+// Runs the sensors at a high data rate and brings each axis down to the
+// control rate with a linear-phase FIR, computing only the outputs that are
+// kept (the polyphase saving: taps MACs per output, not per input). Axes are
+// filtered independently over the block's structure-of-arrays layout.
+// Blocks of any length are accepted; inputs that don't fill a whole output
+// period are staged until the next block.
+//
+// On the ESP32-S3 the kernel is esp-dsp's dsps_fird_s16 (SIMD); elsewhere a
+// scalar kernel with the same semantics is used.
+class Decimator {
+public:
+    static constexpr int MAX_TAPS = 64;    // Multiple of 8 (SIMD kernel)
+    static constexpr int MAX_FACTOR = 8;
+
+    struct Config {
+        int factor;     // Input rate / output rate (1 = pass through)
+        int taps;       // FIR length (multiple of 8, <= MAX_TAPS)
+        float cutoff;   // -6 dB point as a fraction of the output rate
+    };
+
+    // Design the filter (windowed sinc, Q15) and clear the delay lines
+    bool init(const Config& config);
+
+    // Clear delay lines and staged samples (after a rate or offset change)
+    void reset();
+
+    // Filter and decimate one block; out's sample period is in's * factor
+    void process(const AccelBlock& in, AccelBlock* out);
+
+    int getFactor() const { return config.factor; }
+
+    // Worst-case gain (dB) over the band that aliases onto
+    // 0..cutoff of the output rate, measured on the quantized taps
+    float getStopbandDb() const { return stopband_db; }
+
+    // Samples consumed since the last call (for cost-per-second reporting)
+    uint32_t takeInputCount();
+
+private:
+    static constexpr int STAGE_SIZE = adxl345::FIFO_DEPTH + MAX_FACTOR;
+
+    struct Axis {
+        alignas(16) int16_t delay[MAX_TAPS * 2];   // Doubled so the window is contiguous
+        alignas(16) int16_t staged[STAGE_SIZE];
+        int staged_count;
+        int pos;
+        void* simd_state;                          // dsps fir_s16_t (S3 only)
+    };
+
+    Config config = {1, 0, 0};
+    alignas(16) int16_t coeffs[MAX_TAPS] = {};
+    Axis axes[3] = {};
+    float stopband_db = 0;
+    uint32_t input_count = 0;
+
+    int processAxis(Axis* axis, const int16_t* in, int count, int16_t* out);
+    float measureStopband() const;
+};
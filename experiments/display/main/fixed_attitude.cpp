@@ -0,0 +1,150 @@
+#include "fixed_attitude.hpp"
+#include <cmath>
+#include <cstdlib>
+
+// atan(2^-i) in centi-degrees Q8
+static constexpr int CORDIC_STEPS = 16;
+static constexpr int32_t CORDIC_ANGLES[CORDIC_STEPS] = {
+    1152000, 680065, 359328, 182400, 91554, 45822, 22916, 11459,
+    5730, 2865, 1432, 716, 358, 179, 90, 45,
+};
+static constexpr int32_t HALF_TURN_Q8 = 18000 << 8;
+
+int32_t cordic_atan2_cdeg(int32_t y, int32_t x) {
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+
+    // Fold the left half-plane onto the right (+/-180 deg)
+    int32_t angle = 0;
+    if (x < 0) {
+        angle = y >= 0 ? HALF_TURN_Q8 : -HALF_TURN_Q8;
+        x = -x;
+        y = -y;
+    }
+
+    // Scale so the low bits carry resolution but the CORDIC gain (~1.65)
+    // can't overflow
+    int32_t mag = x > abs(y) ? x : abs(y);
+    while (mag < (1 << 24)) {
+        x <<= 1;
+        y <<= 1;
+        mag <<= 1;
+    }
+    while (mag >= (1 << 28)) {
+        x >>= 1;
+        y >>= 1;
+        mag >>= 1;
+    }
+
+    // Vectoring mode: rotate (x, y) onto the x axis, summing the rotations
+    for (int i = 0; i < CORDIC_STEPS; i++) {
+        int32_t x_shift = x >> i;
+        int32_t y_shift = y >> i;
+        if (y > 0) {
+            x += y_shift;
+            y -= x_shift;
+            angle += CORDIC_ANGLES[i];
+        } else {
+            x -= y_shift;
+            y += x_shift;
+            angle -= CORDIC_ANGLES[i];
+        }
+    }
+
+    return (angle + 128) >> 8;
+}
+
+// Wrap a centi-degree difference into -18000..18000
+static int32_t wrap_cdeg(int32_t angle) {
+    if (angle > 18000) {
+        angle -= 36000;
+    } else if (angle < -18000) {
+        angle += 36000;
+    }
+    return angle;
+}
+
+FixedAttitudeEstimator::FixedAttitudeEstimator(const Config& config_param)
+    : config(config_param), front(), rear(), attitude() {}
+
+void FixedAttitudeEstimator::reset() {
+    front = Channel();
+    rear = Channel();
+    attitude = Attitude();
+}
+
+void FixedAttitudeEstimator::setCutoff(float cutoff_hz) {
+    config.cutoff_hz = cutoff_hz;
+    front.period_us = 0;
+    rear.period_us = 0;
+}
+
+void FixedAttitudeEstimator::filterBlock(Channel* channel, const AccelBlock& block) {
+    if (block.sample_period_us != channel->period_us) {
+        // Same first-order response as the float path, quantized once
+        float dt = block.sample_period_us * 1e-6f;
+        float rc = 1.0f / (2.0f * (float)M_PI * config.cutoff_hz);
+        channel->alpha = (int32_t)lrintf(dt / (rc + dt) * (1 << ALPHA_SHIFT));
+        channel->period_us = block.sample_period_us;
+    }
+
+    int start = 0;
+    if (!channel->seeded && block.count > 0) {
+        channel->x = block.x[0] * (1 << STATE_SHIFT);
+        channel->y = block.y[0] * (1 << STATE_SHIFT);
+        channel->z = block.z[0] * (1 << STATE_SHIFT);
+        channel->seeded = true;
+        start = 1;
+    }
+
+    int64_t alpha = channel->alpha;
+    int32_t x = channel->x, y = channel->y, z = channel->z;
+    for (int i = start; i < block.count; i++) {
+        x += (int32_t)(((block.x[i] * (1 << STATE_SHIFT) - x) * alpha) >> ALPHA_SHIFT);
+        y += (int32_t)(((block.y[i] * (1 << STATE_SHIFT) - y) * alpha) >> ALPHA_SHIFT);
+        z += (int32_t)(((block.z[i] * (1 << STATE_SHIFT) - z) * alpha) >> ALPHA_SHIFT);
+    }
+    channel->x = x;
+    channel->y = y;
+    channel->z = z;
+}
+
+const FixedAttitudeEstimator::Attitude& FixedAttitudeEstimator::update(const AccelBlock& front_block, bool front_ok,
+                                                                       const AccelBlock& rear_block, bool rear_ok) {
+    if (front_ok) {
+        filterBlock(&front, front_block);
+    }
+    if (rear_ok) {
+        filterBlock(&rear, rear_block);
+    }
+
+    attitude.front_valid = front_ok && front.seeded;
+    attitude.rear_valid = rear_ok && rear.seeded;
+
+    // Sum the valid gravity vectors at half scale so the sum stays in range
+    int32_t x = 0, y = 0, z = 0;
+    if (attitude.front_valid) {
+        x += front.x >> 1;
+        y += front.y >> 1;
+        z += front.z >> 1;
+    }
+    if (attitude.rear_valid) {
+        x += rear.x >> 1;
+        y += rear.y >> 1;
+        z += rear.z >> 1;
+    }
+
+    if (attitude.front_valid || attitude.rear_valid) {
+        attitude.pitch_cdeg = cordic_atan2_cdeg(y, z);
+        attitude.roll_cdeg = cordic_atan2_cdeg(x, z);
+    }
+
+    if (attitude.front_valid && attitude.rear_valid) {
+        attitude.torsion_cdeg = wrap_cdeg(cordic_atan2_cdeg(front.x, front.z) -
+                                          cordic_atan2_cdeg(rear.x, rear.z));
+    } else {
+        attitude.torsion_cdeg = 0;
+    }
+    return attitude;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include "accel_sensor.hpp"
+
+// ============================================================================
+// Fixed-point attitude math
+// ============================================================================
+// Integer counterpart of AttitudeEstimator: works on the raw int16 counts,
+// filters in Q12 and resolves angles with a 16-step CORDIC, so the per-sample
+// path has no float conversion or libm calls. Angles are in centi-degrees.
+
+// atan2(y, x) in centi-degrees (-18000..18000), under 0.01 deg error.
+// Inputs up to +/-2^28.
+int32_t cordic_atan2_cdeg(int32_t y, int32_t x);
+
+class FixedAttitudeEstimator {
+public:
+    static constexpr int STATE_SHIFT = 12;   // Filter state = raw LSB << 12
+    static constexpr int ALPHA_SHIFT = 16;   // alpha in Q16
+
+    struct Config {
+        float cutoff_hz;   // Low-pass bandwidth (only used to derive alpha)
+    };
+
+    // Angles in centi-degrees
+    struct Attitude {
+        int32_t pitch_cdeg;
+        int32_t roll_cdeg;
+        int32_t torsion_cdeg;
+        bool front_valid;
+        bool rear_valid;
+    };
+
+    explicit FixedAttitudeEstimator(const Config& config);
+
+    // Feed the latest block from each sensor (ok = false skips that sensor)
+    const Attitude& update(const AccelBlock& front, bool front_ok,
+                           const AccelBlock& rear, bool rear_ok);
+
+    void reset();
+
+    void setCutoff(float cutoff_hz);
+    float getCutoff() const { return config.cutoff_hz; }
+    const Attitude& getAttitude() const { return attitude; }
+
+private:
+    struct Channel {
+        int32_t x, y, z;      // Filtered gravity vector (Q12 raw LSB)
+        bool seeded;
+        uint32_t period_us;   // Sample period alpha was computed for
+        int32_t alpha;        // Q16
+    };
+
+    Config config;
+    Channel front;
+    Channel rear;
+    Attitude attitude;
+
+    void filterBlock(Channel* channel, const AccelBlock& block);
+};
@@ -0,0 +1,124 @@
+#include "frame_kinematics.hpp"
+#include <cmath>
+
+static constexpr float DEG_PER_RAD = 180.0f / 3.14159265f;
+
+FrameKinematics::FrameKinematics(const Config& config) : jacobian(), forward(), valid(false) {
+    for (int i = 0; i < MOTORS; i++) {
+        joint_min[i] = -INFINITY;
+        joint_max[i] = INFINITY;
+    }
+
+    // Forward map, one column per motor (small-angle geometry above)
+    for (int i = 0; i < MOTORS; i++) {
+        float p = config.pitch_signs[i];
+        float r = config.roll_signs[i];
+        forward[HEIGHT][i] = 0.25f * config.mm_per_rad;
+        forward[PITCH][i] = p / (2.0f * config.length_mm) * config.mm_per_rad * DEG_PER_RAD;
+        forward[ROLL][i] = r / (2.0f * config.width_mm) * config.mm_per_rad * DEG_PER_RAD;
+        forward[TORSION][i] = p * r / config.width_mm * config.mm_per_rad * DEG_PER_RAD;
+    }
+
+    // Jacobian = forward^-1 by Gauss-Jordan with partial pivoting
+    float a[AXIS_COUNT][2 * MOTORS];
+    for (int row = 0; row < AXIS_COUNT; row++) {
+        for (int col = 0; col < MOTORS; col++) {
+            a[row][col] = forward[row][col];
+            a[row][MOTORS + col] = row == col ? 1.0f : 0.0f;
+        }
+    }
+    for (int col = 0; col < MOTORS; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < AXIS_COUNT; row++) {
+            if (fabsf(a[row][col]) > fabsf(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (fabsf(a[pivot][col]) < 1e-9f) {
+            return;  // Singular: two motors on one corner, or a missing one
+        }
+        for (int k = 0; k < 2 * MOTORS; k++) {
+            float swap = a[col][k];
+            a[col][k] = a[pivot][k];
+            a[pivot][k] = swap;
+        }
+        float scale = 1.0f / a[col][col];
+        for (int k = 0; k < 2 * MOTORS; k++) {
+            a[col][k] *= scale;
+        }
+        for (int row = 0; row < AXIS_COUNT; row++) {
+            if (row != col && a[row][col] != 0.0f) {
+                float factor = a[row][col];
+                for (int k = 0; k < 2 * MOTORS; k++) {
+                    a[row][k] -= factor * a[col][k];
+                }
+            }
+        }
+    }
+    for (int i = 0; i < MOTORS; i++) {
+        for (int axis = 0; axis < AXIS_COUNT; axis++) {
+            jacobian[i][axis] = a[i][MOTORS + axis];
+        }
+    }
+    valid = true;
+}
+
+void FrameKinematics::toJoints(const float* pose, float* joints) const {
+    for (int i = 0; i < MOTORS; i++) {
+        float sum = 0;
+        for (int axis = 0; axis < AXIS_COUNT; axis++) {
+            sum += jacobian[i][axis] * pose[axis];
+        }
+        joints[i] = sum;
+    }
+}
+
+void FrameKinematics::toPose(const float* joints, float* pose) const {
+    for (int axis = 0; axis < AXIS_COUNT; axis++) {
+        float sum = 0;
+        for (int i = 0; i < MOTORS; i++) {
+            sum += forward[axis][i] * joints[i];
+        }
+        pose[axis] = sum;
+    }
+}
+
+void FrameKinematics::setJointLimits(const float* min, const float* max) {
+    for (int i = 0; i < MOTORS; i++) {
+        joint_min[i] = min[i];
+        joint_max[i] = max[i];
+    }
+}
+
+float FrameKinematics::clampStep(const float* from, float* step) const {
+    float fraction = 1.0f;
+    for (int i = 0; i < MOTORS; i++) {
+        // Only motion further out is limited (a joint past a limit may
+        // always move back)
+        float end = from[i] + step[i];
+        if (step[i] > 0 && end > joint_max[i]) {
+            fraction = fminf(fraction, fmaxf(joint_max[i] - from[i], 0.0f) / step[i]);
+        } else if (step[i] < 0 && end < joint_min[i]) {
+            fraction = fminf(fraction, fmaxf(from[i] - joint_min[i], 0.0f) / -step[i]);
+        }
+    }
+    for (int i = 0; i < MOTORS; i++) {
+        step[i] *= fraction;
+    }
+    return fraction;
+}
+
+float FrameKinematics::limitSpeed(float* joints, float max) {
+    float largest = 0;
+    for (int i = 0; i < MOTORS; i++) {
+        largest = fmaxf(largest, fabsf(joints[i]));
+    }
+    if (largest <= max) {
+        return 1.0f;
+    }
+    float fraction = max / largest;
+    for (int i = 0; i < MOTORS; i++) {
+        joints[i] *= fraction;
+    }
+    return fraction;
+}
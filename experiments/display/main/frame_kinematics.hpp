@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+// ============================================================================
+// FrameKinematics - Frame pose <-> corner actuator motion
+// ============================================================================
+// The pose is height (mm) and pitch, roll and torsion (deg, as reported by
+// the attitude estimator); the joints are the four motors (rad, frame sign
+// convention). For the few degrees the frame tilts the map is linear:
+//
+//   height  = mean of the corners
+//   pitch   = (front - rear) / length         (per side, averaged)
+//   roll    = (left - right) / width          (averaged over both ends)
+//   torsion = front roll - rear roll
+//
+// The forward map is built from each motor's corner at construction and
+// inverted once, so a pose change becomes joint motion with a single 4x4
+// matrix-vector product (the Jacobian). Works for positions and velocities
+// alike. Joint limits clamp a step by scaling the whole step, so the frame
+// still moves in the requested direction, just not as far.
+class FrameKinematics {
+public:
+    static constexpr int MOTORS = 4;
+
+    enum Axis {
+        HEIGHT,
+        PITCH,
+        ROLL,
+        TORSION,
+        AXIS_COUNT
+    };
+
+    struct Config {
+        float length_mm;            // Front to rear actuator spacing
+        float width_mm;             // Left to right actuator spacing
+        float mm_per_rad;           // Lift per motor radian
+        int8_t pitch_signs[MOTORS]; // +1 front / -1 rear
+        int8_t roll_signs[MOTORS];  // +1 left / -1 right
+    };
+
+    explicit FrameKinematics(const Config& config);
+
+    // False if the corner assignment doesn't span all four axes
+    bool isValid() const { return valid; }
+
+    // Pose change (mm, deg) -> joint change (rad)
+    void toJoints(const float* pose, float* joints) const;
+
+    // Joint change (rad) -> pose change (mm, deg)
+    void toPose(const float* joints, float* pose) const;
+
+    // Joint positions the motors may not leave (rad); +-infinity by default
+    void setJointLimits(const float* min, const float* max);
+
+    // Scale step so from + step stays within the joint limits; returns the
+    // fraction kept (1 = unclamped, 0 = already at a limit in that direction)
+    float clampStep(const float* from, float* step) const;
+
+    // Scale speeds together so none exceeds max; returns the fraction kept
+    static float limitSpeed(float* joints, float max);
+
+private:
+    float jacobian[MOTORS][AXIS_COUNT];   // Joint per unit pose
+    float forward[AXIS_COUNT][MOTORS];    // Pose per unit joint
+    float joint_min[MOTORS];
+    float joint_max[MOTORS];
+    bool valid;
+};
@@ -0,0 +1,236 @@
+#include "i2c_bus.hpp"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char* TAG = "I2cBus";
+
+bool I2cBus::init(const Config& config_param) {
+    config = config_param;
+
+    i2c_master_bus_config_t bus_config = {};
+    bus_config.i2c_port = config.port;
+    bus_config.sda_io_num = config.sda_io_num;
+    bus_config.scl_io_num = config.scl_io_num;
+    bus_config.clk_source = I2C_CLK_SRC_DEFAULT;
+    bus_config.glitch_ignore_cnt = 7;
+    bus_config.trans_queue_depth = config.queue_depth;  // Non-zero = async mode
+    bus_config.flags.enable_internal_pullup = true;
+
+    esp_err_t err = i2c_new_master_bus(&bus_config, &bus);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create bus: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+bool I2cBus::addDevice(uint8_t dev_addr) {
+    if (device_count >= MAX_DEVICES) {
+        return false;
+    }
+
+    i2c_device_config_t dev_config = {};
+    dev_config.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dev_config.device_address = dev_addr;
+    dev_config.scl_speed_hz = config.clk_speed;
+
+    i2c_master_dev_handle_t dev = NULL;
+    if (i2c_master_bus_add_device(bus, &dev_config, &dev) != ESP_OK) {
+        return false;
+    }
+
+    i2c_master_event_callbacks_t callbacks = {};
+    callbacks.on_trans_done = onTransferDone;
+    if (i2c_master_register_event_callbacks(dev, &callbacks, this) != ESP_OK) {
+        return false;
+    }
+
+    device_addrs[device_count] = dev_addr;
+    devices[device_count] = dev;
+    device_count++;
+    return true;
+}
+
+int I2cBus::findDevice(uint8_t dev_addr) const {
+    for (int i = 0; i < device_count; i++) {
+        if (device_addrs[i] == dev_addr) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+I2cError I2cBus::classify(esp_err_t err) {
+    switch (err) {
+        case ESP_OK:
+            return I2cError::NONE;
+        case ESP_ERR_NOT_FOUND:
+            return I2cError::NACK;
+        case ESP_ERR_TIMEOUT:
+            return I2cError::TIMEOUT;
+        case ESP_ERR_INVALID_STATE:
+            // The driver reports a bus it can't take (lost arbitration,
+            // SDA held low) as an invalid state
+            return I2cError::ARBITRATION;
+        default:
+            return I2cError::OTHER;
+    }
+}
+
+// Keep the first error per device (later ones are usually fallout)
+void IRAM_ATTR I2cBus::setError(int index, I2cError error) {
+    I2cError expected = I2cError::NONE;
+    device_errors[index].compare_exchange_strong(expected, error);
+}
+
+// Account for a transfer before it is handed to the driver (it may finish
+// before the queue call returns)
+void I2cBus::markQueued(int index) {
+    queued_at[queued_head & (LATENCY_RING_SIZE - 1)] = esp_timer_get_time();
+    queued_head++;
+    device_pending[index]++;
+    pending++;
+}
+
+// The driver refused the transfer, so no callback will come
+void I2cBus::unmarkQueued(int index, esp_err_t err) {
+    queued_head--;
+    device_pending[index]--;
+    pending--;
+    setError(index, classify(err));
+}
+
+I2cError I2cBus::takeError(uint8_t dev_addr) {
+    int index = findDevice(dev_addr);
+    if (index < 0) {
+        return I2cError::NACK;
+    }
+    return device_errors[index].exchange(I2cError::NONE);
+}
+
+bool I2cBus::write(uint8_t dev_addr, const uint8_t* data, size_t len) {
+    int index = findDevice(dev_addr);
+    if (index < 0) {
+        return false;
+    }
+
+    markQueued(index);
+    esp_err_t err = i2c_master_transmit(devices[index], data, len, config.timeout_ms);
+    if (err != ESP_OK) {
+        unmarkQueued(index, err);
+        return false;
+    }
+    return true;
+}
+
+bool I2cBus::write_read(uint8_t dev_addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen) {
+    int index = findDevice(dev_addr);
+    if (index < 0) {
+        return false;
+    }
+
+    markQueued(index);
+    esp_err_t err = i2c_master_transmit_receive(devices[index], wdata, wlen, rdata, rlen, config.timeout_ms);
+    if (err != ESP_OK) {
+        unmarkQueued(index, err);
+        return false;
+    }
+    return true;
+}
+
+bool I2cBus::wait() {
+    waiting_task = xTaskGetCurrentTaskHandle();
+    while (pending.load() > 0) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config.timeout_ms)) == 0 && pending.load() > 0) {
+            ESP_LOGW(TAG, "Timed out with %lu transfers pending", (unsigned long)pending.load());
+            bool idle = i2c_master_bus_wait_all_done(bus, config.timeout_ms) == ESP_OK;
+            if (pending.load() == 0) {
+                break;  // Late, but every callback came
+            }
+            for (int i = 0; i < device_count; i++) {
+                if (device_pending[i].load() > 0) {
+                    setError(i, I2cError::TIMEOUT);
+                }
+            }
+            // A transfer still in flight would complete into cleared
+            // counters, so they are only dropped once the controller is idle
+            // or has been reset; otherwise the next wait() tries again
+            if (idle) {
+                forgetPending();
+            } else {
+                recover();
+            }
+            failed = true;
+            break;
+        }
+    }
+    waiting_task = NULL;
+    return !failed.exchange(false);
+}
+
+bool I2cBus::recover() {
+    // i2c_master_bus_reset resets the controller FSM and clocks SCL until
+    // a slave stuck mid-byte lets go of SDA
+    esp_err_t err = i2c_master_bus_reset(bus);
+    if (err != ESP_OK) {
+        // Transfers may still be queued; keep counting them
+        ESP_LOGE(TAG, "Bus recovery failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    forgetPending();
+    failed = false;
+    ESP_LOGW(TAG, "Bus recovered");
+    return true;
+}
+
+// Nothing queued will call back any more (controller idle or reset)
+void I2cBus::forgetPending() {
+    for (int i = 0; i < device_count; i++) {
+        device_pending[i] = 0;
+    }
+    pending = 0;
+    queued_tail = queued_head;
+}
+
+I2cBus::Stats I2cBus::takeStats() {
+    Stats snapshot = stats;
+    stats = {};
+    return snapshot;
+}
+
+bool IRAM_ATTR I2cBus::onTransferDone(i2c_master_dev_handle_t dev, const i2c_master_event_data_t* evt, void* arg) {
+    I2cBus* self = (I2cBus*)arg;
+    int64_t now = esp_timer_get_time();
+
+    // Latency from queueing; the wire was busy from max(queued, previous done)
+    int64_t queued = self->queued_at[self->queued_tail & (LATENCY_RING_SIZE - 1)];
+    self->queued_tail++;
+    int64_t started = queued > self->last_done_us ? queued : self->last_done_us;
+    self->last_done_us = now;
+
+    self->stats.transfers++;
+    self->stats.busy_us += now - started;
+    self->stats.latency_total_us += now - queued;
+    if (now - queued > self->stats.latency_max_us) {
+        self->stats.latency_max_us = now - queued;
+    }
+    int index = 0;
+    while (index < self->device_count - 1 && self->devices[index] != dev) {
+        index++;
+    }
+    self->device_pending[index]--;
+
+    if (evt->event != I2C_EVENT_DONE) {
+        self->stats.errors++;
+        self->failed = true;
+        self->setError(index, evt->event == I2C_EVENT_NACK ? I2cError::NACK :
+                              evt->event == I2C_EVENT_TIMEOUT ? I2cError::TIMEOUT : I2cError::OTHER);
+    }
+
+    BaseType_t high_task_awoken = pdFALSE;
+    if (--self->pending == 0 && self->waiting_task) {
+        vTaskNotifyGiveFromISR(self->waiting_task, &high_task_awoken);
+    }
+    return high_task_awoken == pdTRUE;
+}
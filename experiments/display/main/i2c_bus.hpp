@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "i2c_health.hpp"
+
+// ============================================================================
+// I2cBus - Asynchronous transaction queue on the ESP-IDF i2c_master driver
+// ============================================================================
+// The bus is created with a transaction queue, so write() / write_read()
+// return as soon as the transfer is queued. The owning task queues any
+// number of transfers (across devices), does other work, then calls wait()
+// which blocks on a task notification from the transfer-done callback.
+// Buffers handed to a queued transfer must stay valid until wait() returns.
+// The first failure of each device since the last takeError() is kept, so
+// callers can tell which device failed and how.
+class I2cBus {
+public:
+    struct Config {
+        i2c_port_num_t port;
+        gpio_num_t sda_io_num;
+        gpio_num_t scl_io_num;
+        uint32_t clk_speed;
+        size_t queue_depth;    // Max transfers in flight
+        int timeout_ms;        // Per-transfer and wait() timeout
+    };
+
+    // Bus time accounting (queue -> done per transfer)
+    struct Stats {
+        uint32_t transfers;
+        uint32_t errors;
+        int64_t latency_total_us;  // Sum of queue-to-done time
+        int64_t latency_max_us;
+        int64_t busy_us;           // Time with at least one transfer on the wire
+    };
+
+    static constexpr int MAX_DEVICES = 4;
+
+    bool init(const Config& config);
+    bool addDevice(uint8_t dev_addr);
+
+    // Queue transfers (non-blocking while the queue has room)
+    bool write(uint8_t dev_addr, const uint8_t* data, size_t len);
+    bool write_read(uint8_t dev_addr, const uint8_t* wdata, size_t wlen, uint8_t* rdata, size_t rlen);
+
+    // Block until every queued transfer has finished; false if any failed
+    bool wait();
+
+    // First error for dev_addr since the last call (NONE if all succeeded)
+    I2cError takeError(uint8_t dev_addr);
+
+    // Reset the controller and clock SCL until a stuck slave releases SDA.
+    // Drops anything still queued; on failure the queue is kept and wait()
+    // keeps reporting it.
+    bool recover();
+
+    // Snapshot and reset statistics
+    Stats takeStats();
+
+private:
+    static constexpr int LATENCY_RING_SIZE = 128;  // Must be a power of two
+
+    Config config = {};
+    i2c_master_bus_handle_t bus = NULL;
+    uint8_t device_addrs[MAX_DEVICES] = {};
+    i2c_master_dev_handle_t devices[MAX_DEVICES] = {};
+    int device_count = 0;
+
+    TaskHandle_t waiting_task = NULL;
+    std::atomic<uint32_t> pending{0};
+    std::atomic<bool> failed{false};
+    std::atomic<uint32_t> device_pending[MAX_DEVICES] = {};
+    std::atomic<I2cError> device_errors[MAX_DEVICES] = {};
+
+    // Queue timestamps, completed in queue order on a single bus
+    int64_t queued_at[LATENCY_RING_SIZE] = {};
+    uint32_t queued_head = 0;
+    uint32_t queued_tail = 0;
+    int64_t last_done_us = 0;
+    Stats stats = {};
+
+    int findDevice(uint8_t dev_addr) const;
+    void markQueued(int index);
+    void unmarkQueued(int index, esp_err_t err);
+    void setError(int index, I2cError error);
+    void forgetPending();
+    static I2cError classify(esp_err_t err);
+    static bool onTransferDone(i2c_master_dev_handle_t dev, const i2c_master_event_data_t* evt, void* arg);
+};
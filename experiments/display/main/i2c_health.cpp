@@ -0,0 +1,82 @@
+#include "i2c_health.hpp"
+
+I2cHealth::I2cHealth(const Config& config_param)
+    : config(config_param), devices(), device_count(0) {}
+
+int I2cHealth::addDevice() {
+    if (device_count >= MAX_DEVICES) {
+        return -1;
+    }
+    devices[device_count] = Device();
+    devices[device_count].stats.online = true;
+    return device_count++;
+}
+
+I2cHealth::Action I2cHealth::record(int device, I2cError error, int attempt, int64_t now_us) {
+    DeviceStats& stats = devices[device].stats;
+
+    switch (error) {
+        case I2cError::NONE:
+            stats.successes++;
+            stats.consecutive_failures = 0;
+            return Action::OK;
+        case I2cError::NACK:
+            stats.nacks++;
+            break;
+        case I2cError::TIMEOUT:
+            stats.timeouts++;
+            break;
+        case I2cError::ARBITRATION:
+            stats.arbitration_losses++;
+            break;
+        case I2cError::OTHER:
+            stats.other_errors++;
+            break;
+    }
+    stats.consecutive_failures++;
+
+    if (stats.consecutive_failures >= (uint32_t)config.offline_after) {
+        setOffline(device, now_us);
+        return Action::OFFLINE;
+    }
+
+    // A stuck line shows up as timeouts/arbitration on every device, so
+    // recover on those right away and on repeated NACKs otherwise
+    bool bus_fault = error == I2cError::TIMEOUT || error == I2cError::ARBITRATION;
+    if (bus_fault || stats.consecutive_failures % config.recover_after == 0) {
+        stats.recoveries++;
+        if (retriesLeft(attempt)) {
+            stats.retries++;
+        }
+        return Action::RECOVER_BUS;
+    }
+
+    if (retriesLeft(attempt)) {
+        stats.retries++;
+        return Action::RETRY;
+    }
+    return Action::FAIL;
+}
+
+void I2cHealth::setOffline(int device, int64_t now_us) {
+    devices[device].stats.online = false;
+    devices[device].next_probe_us = now_us + config.probe_period_us;
+}
+
+bool I2cHealth::probeDue(int device, int64_t now_us) {
+    Device& dev = devices[device];
+    if (dev.stats.online || now_us < dev.next_probe_us) {
+        return false;
+    }
+    dev.next_probe_us = now_us + config.probe_period_us;
+    return true;
+}
+
+void I2cHealth::probeResult(int device, bool ok) {
+    if (ok) {
+        DeviceStats& stats = devices[device].stats;
+        stats.online = true;
+        stats.consecutive_failures = 0;
+        stats.reinits++;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+// Failure class of one I2C transfer
+enum class I2cError : uint8_t {
+    NONE,
+    NACK,          // Address or data not acknowledged (device absent/busy)
+    TIMEOUT,       // Transfer never completed (SCL held, bus stuck)
+    ARBITRATION,   // Bus lost to / held by another driver
+    OTHER,
+};
+
+// ============================================================================
+// I2cHealth - Retry, recovery and offline policy per device
+// ============================================================================
+// Pure bookkeeping: callers report the outcome of every attempt and get back
+// what to do next. Consecutive failures escalate from a retry with
+// exponential backoff, to a bus recovery (clock pulses to free SDA), to
+// taking the device offline. Offline devices are re-probed on a fixed period
+// and re-initialized when they answer again.
+class I2cHealth {
+public:
+    static constexpr int MAX_DEVICES = 4;
+
+    // attempt value for operations that can't be repeated (never retried)
+    static constexpr int NO_RETRY = 1 << 30;
+
+    enum class Action {
+        OK,            // Attempt succeeded
+        RETRY,         // Wait retryDelay(attempt) and try again
+        RECOVER_BUS,   // Recover the bus, then retry if retriesLeft(attempt)
+        FAIL,          // Out of retries for this operation
+        OFFLINE,       // Stop using the device until a probe succeeds
+    };
+
+    struct Config {
+        int max_retries;            // Retries per operation
+        int64_t backoff_us;         // First retry delay, doubled per attempt
+        int recover_after;          // Consecutive failures per bus recovery
+        int offline_after;          // Consecutive failures before going offline
+        int64_t probe_period_us;    // Re-init attempts while offline
+    };
+
+    struct DeviceStats {
+        uint32_t successes;
+        uint32_t nacks;
+        uint32_t timeouts;
+        uint32_t arbitration_losses;
+        uint32_t other_errors;
+        uint32_t retries;
+        uint32_t recoveries;
+        uint32_t reinits;           // Times the device came back
+        uint32_t consecutive_failures;
+        bool online;
+    };
+
+    explicit I2cHealth(const Config& config);
+
+    // Register a device, returns its index (-1 if full)
+    int addDevice();
+
+    // Report one attempt (attempt = 0 for the first try)
+    Action record(int device, I2cError error, int attempt, int64_t now_us);
+
+    int64_t retryDelay(int attempt) const { return config.backoff_us << attempt; }
+    bool retriesLeft(int attempt) const { return attempt < config.max_retries; }
+
+    // Take a device offline for a reason the bus can't see (e.g. it stopped
+    // producing data after a brown-out)
+    void setOffline(int device, int64_t now_us);
+
+    bool isOnline(int device) const { return devices[device].stats.online; }
+
+    // True once per probe period while the device is offline
+    bool probeDue(int device, int64_t now_us);
+
+    // Result of a re-init attempt after probeDue
+    void probeResult(int device, bool ok);
+
+    const DeviceStats& getStats(int device) const { return devices[device].stats; }
+    int getDeviceCount() const { return device_count; }
+
+private:
+    struct Device {
+        DeviceStats stats;
+        int64_t next_probe_us;
+    };
+
+    Config config;
+    Device devices[MAX_DEVICES];
+    int device_count;
+};
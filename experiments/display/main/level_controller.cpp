@@ -0,0 +1,141 @@
+#include "level_controller.hpp"
+#include <cmath>
+
+LevelController::LevelController(const Config& config_param)
+    : config(config_param), state(State::IDLE), pitch(), roll(), output(), metrics(), start_us(0),
+      last_us(0), level_since_us(-1) {}
+
+const char* LevelController::stateName(State state) {
+    switch (state) {
+        case State::IDLE:
+            return "idle";
+        case State::LEVELING:
+            return "leveling";
+        case State::SETTLED:
+            return "level";
+        case State::TIMED_OUT:
+            return "timed out";
+        case State::NO_ATTITUDE:
+            return "no attitude";
+        case State::LIMITED:
+            return "at a joint limit";
+        case State::CANCELLED:
+            return "cancelled";
+    }
+    return "?";
+}
+
+void LevelController::start(int64_t now_us) {
+    state = State::LEVELING;
+    pitch = {};
+    roll = {};
+    output = {};
+    metrics = {};
+    start_us = now_us;
+    last_us = now_us;
+    level_since_us = -1;
+}
+
+void LevelController::cancel() {
+    if (state == State::LEVELING) {
+        finish(State::CANCELLED, last_us);
+    }
+}
+
+void LevelController::finish(State final_state, int64_t now_us) {
+    state = final_state;
+    output = {};
+    metrics.duration_us = now_us - start_us;
+}
+
+// Returns true if a limit held the output this step. Inside the tolerance
+// the axis ramps to a stop and holds its integral (deadband), so noise and
+// motor vibration around level don't keep the motors hunting.
+bool LevelController::stepAxis(Axis* axis, float error, float dt, bool hold) {
+    if (metrics.updates == 0) {
+        axis->initial_error = error;
+    }
+    // Past zero, measured against the side the move started from
+    if (error * axis->initial_error < 0) {
+        axis->overshoot = fmaxf(axis->overshoot, fabsf(error));
+    }
+
+    // Drive the angle toward zero
+    float wanted = hold ? 0.0f : -(config.kp * error + config.ki * axis->integral);
+    float limited = fmaxf(-config.max_rate_dps, fminf(config.max_rate_dps, wanted));
+    float max_change = config.max_rate_change_dps2 * dt;
+    limited = fmaxf(axis->output - max_change, fminf(axis->output + max_change, limited));
+
+    // Integrate unless held by a limit in the direction the error pushes
+    bool saturated = fabsf(limited - wanted) > 1e-6f;
+    bool unwinds = (wanted - limited) * error > 0;
+    if (!hold && (!saturated || unwinds)) {
+        axis->integral += error * dt;
+    }
+    axis->output = limited;
+    return saturated;
+}
+
+void LevelController::mix() {
+    float pose_rate[FrameKinematics::AXIS_COUNT] = {};
+    pose_rate[FrameKinematics::PITCH] = output.pitch_rate_dps;
+    pose_rate[FrameKinematics::ROLL] = output.roll_rate_dps;
+    config.kinematics->toJoints(pose_rate, output.motor_rad_s);
+    FrameKinematics::limitSpeed(output.motor_rad_s, config.max_motor_rad_s);
+}
+
+const LevelController::Output& LevelController::update(int64_t now_us, float pitch_deg, float roll_deg,
+                                                       int64_t attitude_us, const float* joint_rad) {
+    if (state != State::LEVELING) {
+        return output;
+    }
+    if (now_us - attitude_us > config.max_attitude_age_us) {
+        finish(State::NO_ATTITUDE, now_us);
+        return output;
+    }
+    if (now_us - start_us > config.timeout_us) {
+        finish(State::TIMED_OUT, now_us);
+        return output;
+    }
+
+    // Settled: in tolerance long enough
+    bool in_tolerance = fabsf(pitch_deg) <= config.tolerance_deg && fabsf(roll_deg) <= config.tolerance_deg;
+    if (!in_tolerance) {
+        level_since_us = -1;
+    } else if (level_since_us < 0) {
+        level_since_us = now_us;
+    }
+    if (level_since_us >= 0 && now_us - level_since_us >= config.settle_us) {
+        metrics.time_to_level_us = level_since_us - start_us;
+        finish(State::SETTLED, now_us);
+        return output;
+    }
+
+    float dt = (now_us - last_us) * 1e-6f;
+    last_us = now_us;
+    bool saturated = stepAxis(&pitch, pitch_deg, dt, in_tolerance);
+    saturated = stepAxis(&roll, roll_deg, dt, in_tolerance) || saturated;
+
+    output.pitch_rate_dps = pitch.output;
+    output.roll_rate_dps = roll.output;
+    mix();
+
+    // Stop short of a joint limit rather than drive into the end stop
+    float step[MOTORS];
+    for (int i = 0; i < MOTORS; i++) {
+        step[i] = output.motor_rad_s[i] * dt;
+    }
+    if (config.kinematics->clampStep(joint_rad, step) < 1.0f) {
+        finish(State::LIMITED, now_us);
+        return output;
+    }
+
+    if (metrics.updates == 0) {
+        metrics.initial_pitch_deg = pitch_deg;
+        metrics.initial_roll_deg = roll_deg;
+    }
+    metrics.updates++;
+    metrics.saturated_updates += saturated ? 1 : 0;
+    metrics.overshoot_deg = fmaxf(pitch.overshoot, roll.overshoot);
+    return output;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include "frame_kinematics.hpp"
+
+// ============================================================================
+// LevelController - Closed-loop leveling from the attitude estimate
+// ============================================================================
+// One PI loop per axis turns pitch and roll error into an angular rate for
+// the frame; FrameKinematics turns the rates into differential corner
+// motion (height and torsion unchanged) and motor speeds. The owning task calls update() at a fixed rate
+// with the latest attitude.
+//
+// The output rate is clamped and slew limited; the integrator only runs
+// while the output is not held by either limit, or when the error would pull
+// it back (conditional integration, so it can't wind up during a long
+// saturated approach). Within the tolerance the output ramps to zero; the
+// move is done once both angles stay there for settle_us, and is abandoned
+// after timeout_us or when the attitude goes stale. A corner that would pass
+// its joint limit (the kinematics' limits) within a step ends the run too:
+// the correction is differential, so no corner is stopped on its own. Pure
+// arithmetic, so it runs unchanged on host.
+class LevelController {
+public:
+    static constexpr int MOTORS = FrameKinematics::MOTORS;
+
+    struct Config {
+        float kp;                     // deg/s per deg of error
+        float ki;                     // deg/s per deg*s of error
+        float max_rate_dps;           // Output clamp per axis
+        float max_rate_change_dps2;   // Output slew limit per axis
+        float tolerance_deg;          // Level when both errors are within
+        int64_t settle_us;            // ...continuously for this long
+        int64_t timeout_us;           // Give up after this long
+        int64_t max_attitude_age_us;  // Give up on an attitude older than this
+        const FrameKinematics* kinematics;
+        float max_motor_rad_s;        // All corners scale down together past this
+    };
+
+    enum class State : uint8_t {
+        IDLE,
+        LEVELING,
+        SETTLED,     // Level within tolerance; motors stopped
+        TIMED_OUT,
+        NO_ATTITUDE, // Attitude went stale
+        LIMITED,     // A corner reached its joint limit
+        CANCELLED,
+    };
+
+    struct Output {
+        float pitch_rate_dps;
+        float roll_rate_dps;
+        float motor_rad_s[MOTORS];
+    };
+
+    // Result of the last run
+    struct Metrics {
+        float initial_pitch_deg;
+        float initial_roll_deg;
+        float overshoot_deg;          // Largest error past zero, either axis
+        int64_t time_to_level_us;     // Start -> entering tolerance for good
+        int64_t duration_us;          // Start -> end (settle time included)
+        uint32_t updates;
+        uint32_t saturated_updates;   // Output held by a limit
+    };
+
+    explicit LevelController(const Config& config);
+
+    void start(int64_t now_us);
+    void cancel();
+
+    // One control step; attitude_us is when pitch/roll were measured,
+    // joint_rad the corners' current positions
+    const Output& update(int64_t now_us, float pitch_deg, float roll_deg, int64_t attitude_us,
+                         const float* joint_rad);
+
+    bool isActive() const { return state == State::LEVELING; }
+    State getState() const { return state; }
+    const Metrics& getMetrics() const { return metrics; }
+    static const char* stateName(State state);
+
+private:
+    struct Axis {
+        float integral;          // deg*s
+        float output;            // deg/s after limits
+        float initial_error;
+        float overshoot;
+    };
+
+    Config config;
+    State state;
+    Axis pitch;
+    Axis roll;
+    Output output;
+    Metrics metrics;
+    int64_t start_us;
+    int64_t last_us;
+    int64_t level_since_us;      // Both in tolerance since (-1 if not)
+
+    bool stepAxis(Axis* axis, float error, float dt, bool hold);
+    void mix();
+    void finish(State final_state, int64_t now_us);
+};
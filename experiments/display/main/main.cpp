@@ -1,19 +1,42 @@
 #include <stdio.h>
 #include <math.h>
+#include <atomic>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_cpu.h"
 #include "esp_log.h"
 #include "esp_sleep.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "driver/rtc_io.h"
-#include "driver/i2c.h"
 #include "lgfx_config.hpp"
 #include "pins.hpp"
 #include "config.hpp"
 #include "ui_manager.hpp"
-#include "i2c.hpp"
-#include "adxl345.hpp"
+#include "button_scanner.hpp"
+#include "actuator_sequencer.hpp"
+#include "mode_state_machine.hpp"
+#include "i2c_bus.hpp"
+#include "i2c_health.hpp"
+#include "accel_sensor.hpp"
+#include "attitude_estimator.hpp"
+#include "fixed_attitude.hpp"
+#include "accel_calibration.hpp"
+#include "decimator.hpp"
+#include "sampling_policy.hpp"
+#include "twai_bus.hpp"
+#include "can_telemetry.hpp"
+#include "can_scheduler.hpp"
+#include "motor_controller.hpp"
+#include "motor_state_cache.hpp"
+#include "trajectory_planner.hpp"
+#include "frame_kinematics.hpp"
+#include "level_controller.hpp"
+#include "motor_homing.hpp"
+#include "motor_supervisor.hpp"
+#include "nvs_store.hpp"
 
 static const char *TAG = "BedLift";
 
@@ -22,13 +45,229 @@ LGFX display;
 UIManager ui;
 
 // I2C and Accelerometer instances
-static std::shared_ptr<espp::I2c> i2c;
-static std::unique_ptr<espp::Adxl345> acc_front;
-static std::unique_ptr<espp::Adxl345> acc_rear;
+static I2cBus i2c_bus;
+static std::unique_ptr<AccelSensor> acc_front;
+static std::unique_ptr<AccelSensor> acc_rear;
+static Decimator front_decimator;
+static Decimator rear_decimator;
+static AccelMotionConfig accel_motion = {};
+
+// CAN bus and the four CyberGear motors (commands from motor_task, feedback
+// from can_rx_task into motor_states)
+static TwaiBus can_bus;
+static MotorStateCache motor_states;
+static std::atomic<uint32_t> can_feedback_frames{0};
+static std::atomic<uint32_t> can_other_frames{0};
+static CanTelemetry can_telemetry({
+    .bitrate = CAN_BITRATE,
+    .id_mask = CAN_TELEMETRY_ID_MASK,
+    .motor_count = MOTOR_COUNT,
+    .motor_ids = MOTOR_CAN_IDS,
+    .reply_timeout_us = CAN_REPLY_TIMEOUT_MS * 1000,
+});
+
+// Every command batch goes through here so telemetry sees what the driver
+// took and how deep its queue got
+static int can_transmit(const CanFrame* frames, int count) {
+    int sent = can_bus.transmit(frames, count);
+    can_telemetry.onTransmit(frames, sent, esp_timer_get_time());
+    CanBusStatus status;
+    if (can_bus.readStatus(&status)) {
+        can_telemetry.onStatus(status);
+    }
+    return sent;
+}
+
+// Room for the scheduler's flush: frames already with the driver can no
+// longer be replaced, so it gets at most CAN_TX_IN_FLIGHT
+static int can_free_slots(void) {
+    CanBusStatus status;
+    return can_bus.readStatus(&status) ? CAN_TX_IN_FLIGHT - (int)status.msgs_to_tx : 0;
+}
+
+// Commands queue here and motor_task flushes them once per cycle, control
+// first, then setpoints, then status requests
+static CanScheduler can_scheduler({
+    .master_id = MOTOR_CAN_MASTER_ID,
+    .motor_count = MOTOR_COUNT,
+    .motor_ids = MOTOR_CAN_IDS,
+    .setpoint_deadline_us = CAN_SETPOINT_DEADLINE_MS * 1000,
+    .status_period_us = CAN_STATUS_PERIOD_MS * 1000,
+    .status_deadline_us = CAN_STATUS_DEADLINE_MS * 1000,
+    .transmit = can_transmit,
+    .free_slots = can_free_slots,
+});
+
+static std::atomic<bool> motor_halt{false};      // Shutdown: ignore the plan
+static std::atomic<TaskHandle_t> motor_halt_waiter{nullptr};  // Notified once the motors are off
+
+// Once halted the scheduler is bypassed: the stop frames go out at once
+// rather than behind setpoints still queued for the next flush
+static int motor_transmit(const CanFrame* frames, int count) {
+    return motor_halt.load() ? can_transmit(frames, count) : can_scheduler.submit(frames, count);
+}
+
+static MotorController motors({
+    .master_id = MOTOR_CAN_MASTER_ID,
+    .motor_count = MOTOR_COUNT,
+    .motor_ids = MOTOR_CAN_IDS,
+    .directions = MOTOR_DIRECTIONS,
+    .current_limit_a = MOTOR_CURRENT_LIMIT_A,
+    .stop_cycles = MOTOR_STOP_CYCLES,
+    .transmit = motor_transmit,
+});
+
+static TrajectoryPlanner::Config motor_planner_config() {
+    TrajectoryPlanner::Config config = {};
+    config.axis_count = MOTOR_COUNT;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        config.max_velocity[i] = MOTOR_SPEED_RAD_S;
+        config.max_acceleration[i] = MOTOR_ACCEL_RAD_S2;
+    }
+    return config;
+}
+
+// Synchronized moves, owned by motor_task; spin_motors posts the request
+static TrajectoryPlanner planner(motor_planner_config());
+static std::atomic<int> motor_direction{0};
+static std::atomic<uint8_t> motor_selection{0};  // Bit per motor
+static_assert(MOTOR_STOP_DELAY_MS >= 1000.0f * MOTOR_SPEED_RAD_S / MOTOR_ACCEL_RAD_S2,
+              "Locks would engage before the planned stop completes");
+
+// Pose <-> corner motion for Roll/Pitch/Torsion steps and leveling
+static FrameKinematics kinematics({
+    .length_mm = FRAME_LENGTH_MM,
+    .width_mm = FRAME_WIDTH_MM,
+    .mm_per_rad = ACTUATOR_MM_PER_RAD,
+    .pitch_signs = MOTOR_PITCH_SIGNS,
+    .roll_signs = MOTOR_ROLL_SIGNS,
+});
+
+// LEVEL mode closed loop, run by motor_task on the latest attitude (pitch and
+// roll may come from adjacent estimator updates; harmless at this rate)
+static LevelController leveler({
+    .kp = LEVEL_KP,
+    .ki = LEVEL_KI,
+    .max_rate_dps = LEVEL_MAX_RATE_DPS,
+    .max_rate_change_dps2 = LEVEL_MAX_ACCEL_DPS2,
+    .tolerance_deg = LEVEL_TOLERANCE_DEG,
+    .settle_us = LEVEL_SETTLE_MS * 1000LL,
+    .timeout_us = LEVEL_TIMEOUT_MS * 1000LL,
+    .max_attitude_age_us = LEVEL_ATTITUDE_MAX_AGE_MS * 1000LL,
+    .kinematics = &kinematics,
+    .max_motor_rad_s = MOTOR_SPEED_RAD_S,
+});
+static std::atomic<bool> level_requested{false};
+static std::atomic<int> adjust_steps[FrameKinematics::AXIS_COUNT];  // Presses not yet planned
+static std::atomic<float> attitude_pitch_deg{0};
+static std::atomic<float> attitude_roll_deg{0};
+static std::atomic<int64_t> attitude_time_us{INT64_MIN / 2};  // Never
+
+// Joint positions (owned by motor_task) and the homing run. Positions are
+// published for perform_shutdown, which saves them if they are referenced;
+// boot restores them once, so a power cut without a clean shutdown falls
+// back to unreferenced.
+static MotorHoming homing({
+    .motor_count = MOTOR_COUNT,
+    .speed_rad_s = -MOTOR_HOMING_RAD_S,
+    .stall_speed_rad_s = MOTOR_HOMING_STALL_RAD_S,
+    .stall_torque_nm = MOTOR_HOMING_STALL_NM,
+    .stall_samples = MOTOR_HOMING_STALL_SAMPLES,
+    .spinup_us = MOTOR_HOMING_SPINUP_MS * 1000LL,
+    .max_feedback_age_us = MOTOR_FEEDBACK_MAX_AGE_MS * 1000LL,
+    .timeout_us = MOTOR_HOMING_TIMEOUT_MS * 1000LL,
+    .home_position_rad = 0.0f,
+});
+static std::atomic<float> motor_position_rad[MOTOR_COUNT];
+
+// Planned moves are watched for stalled or overloaded motors, and balanced
+// by slowing the planner's clock (owned by motor_task)
+static MotorSupervisor supervisor({
+    .motor_count = MOTOR_COUNT,
+    .overload_torque_nm = MOTOR_OVERLOAD_NM,
+    .stall_speed_ratio = MOTOR_STALL_SPEED_RATIO,
+    .min_command_rad_s = MOTOR_STALL_MIN_RAD_S,
+    .detect_samples = MOTOR_STALL_SAMPLES,
+    .lag_deadband_rad = MOTOR_LAG_DEADBAND_RAD,
+    .lag_gain = MOTOR_LAG_SLOWDOWN_PER_RAD,
+    .catch_up_gain = MOTOR_CATCH_UP_GAIN,
+    .max_catch_up_rad_s = MOTOR_CATCH_UP_RAD_S,
+    .min_scale = MOTOR_BALANCE_MIN_SCALE,
+    .scale_rate = MOTOR_BALANCE_RATE,
+    .stall_timeout_us = MOTOR_STALL_TIMEOUT_MS * 1000LL,
+});
+static std::atomic<bool> motors_referenced{false};
+
+// Joint rad from the bottom stops, valid once referenced
+struct MotorSoftLimits {
+    float min_rad[MOTOR_COUNT];
+    float max_rad[MOTOR_COUNT];
+};
+struct MotorPositions {
+    float position_rad[MOTOR_COUNT];
+};
+static const char* NVS_KEY_SOFT_LIMITS = "soft_limits";
+static const char* NVS_KEY_MOTOR_POSITIONS = "motor_pos";
+static MotorSoftLimits soft_limits = {};
+
+// Retry / recovery / offline policy for both sensors
+static I2cHealth i2c_health({
+    .max_retries = ACCEL_I2C_MAX_RETRIES,
+    .backoff_us = ACCEL_I2C_BACKOFF_MS * 1000,
+    .recover_after = ACCEL_I2C_RECOVER_AFTER,
+    .offline_after = ACCEL_I2C_OFFLINE_AFTER,
+    .probe_period_us = ACCEL_I2C_PROBE_PERIOD_MS * 1000,
+});
+static int front_health = -1;
+static int rear_health = -1;
+#if ATTITUDE_FIXED_POINT
+static FixedAttitudeEstimator attitude({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+#else
+static AttitudeEstimator attitude({.cutoff_hz = ATTITUDE_CUTOFF_HZ});
+#endif
+
+// Sensor data rate / task period per activity level (FULL is the build's rate)
+static SamplingPolicy sampling({
+    .profiles = {
+        {ACCEL_LOW_RATE_CODE, ACCEL_IDLE_WATERMARK, ACCEL_LOW_PERIOD_MS, 1},          // STANDBY
+        {ACCEL_LOW_RATE_CODE, ACCEL_IDLE_WATERMARK, ACCEL_LOW_PERIOD_MS, 1},          // LOW
+        {ACCEL_REDUCED_RATE_CODE, ACCEL_IDLE_WATERMARK, ACCEL_REDUCED_PERIOD_MS, 1},  // REDUCED
+        {ACCEL_RATE_CODE, ACCEL_FIFO_WATERMARK, ACCEL_TASK_PERIOD_MS, ACCEL_DECIMATION},  // FULL
+    },
+    .busy_rms_mg = ACCEL_BUSY_RMS_MG,
+    .quiet_rms_mg = ACCEL_QUIET_RMS_MG,
+    .quiet_hold_us = ACCEL_QUIET_HOLD_MS * 1000LL,
+    .motor_settle_us = ACCEL_MOTOR_SETTLE_MS * 1000LL,
+    .standby_hold_us = ACCEL_STANDBY_HOLD_MS * 1000LL,
+    .allow_standby = ACCEL_STANDBY_ALLOWED,
+});
+static OperationMode sampled_mode = OperationMode::UP_DOWN;  // Mode sampling last followed (accelerometer task)
+
+// Accelerometer calibration (offset registers of both sensors, kept in NVS)
+struct AccelCalibration {
+    AccelOffsets front;
+    AccelOffsets rear;
+};
+
+enum class CalibrationRequest {
+    NONE,
+    CAPTURE,   // Average the current pose as level and write offsets
+    CLEAR,     // Zero the offsets and forget the stored calibration
+};
+
+static const char* NVS_KEY_ACCEL_CAL = "accel_cal";
+static std::atomic<CalibrationRequest> calibration_request{CalibrationRequest::NONE};
+static bool calibration_capturing = false;  // Owned by the accelerometer task
+
+// Wakes the accelerometer task while it idles (activity interrupt or request)
+static SemaphoreHandle_t accel_wake_semaphore = NULL;
 
 // GPIO event queue
 static QueueHandle_t gpio_event_queue = NULL;
 
+// GPIO ISR statistics (interrupt input path)
+static ButtonInputStats gpio_isr_stats = {};
+
 // Activity tracking
 static volatile int64_t last_activity_time = 0;
 static volatile bool is_dimmed = false;
@@ -60,8 +299,26 @@ int64_t get_idle_time_ms(void) {
 void perform_shutdown(void) {
     ESP_LOGI(TAG, "Performing shutdown sequence...");
 
-    // TODO: Stop any active motor movements
-    // TODO: Save current state/settings to NVS
+    // Stop any active motor movements (without ramping back up). motor_task
+    // owns the controller: it sends the stop frames on its next cycle and
+    // notifies this task
+    motor_halt_waiter = xTaskGetCurrentTaskHandle();
+    motor_halt = true;
+    if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5 * MOTOR_CYCLE_MS))) {
+        ESP_LOGE(TAG, "Motor task did not confirm the stop");
+    }
+
+    // Positions for the next boot, once the last feedback is in
+    vTaskDelay(pdMS_TO_TICKS(2 * MOTOR_CYCLE_MS));
+    if (motors_referenced.load()) {
+        MotorPositions saved;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            saved.position_rad[i] = motor_position_rad[i].load();
+        }
+        if (nvs_store_save(NVS_KEY_MOTOR_POSITIONS, &saved, sizeof(saved))) {
+            ESP_LOGI(TAG, "Motor positions saved");
+        }
+    }
     // TODO: Disable power outputs
     // TODO: Turn off display backlight
 
@@ -91,6 +348,18 @@ void enter_deep_sleep(void) {
     // Generate io_mask for GPIO 1 (MODE) and GPIO 2 (UP)
     uint64_t io_mask = (1ULL << GPIO_BUTTON_MODE) | (1ULL << GPIO_BUTTON_UP);
 
+#if ACCEL_WAKE_ON_MOTION
+    // Activity interrupts wake too; keep the sensors powered and the front
+    // address strap driven through sleep
+    io_mask |= (1ULL << GPIO_ACC_FRONT_INT1) | (1ULL << GPIO_ACC_REAR_INT1);
+    rtc_gpio_pullup_dis((gpio_num_t)GPIO_ACC_FRONT_INT1);
+    rtc_gpio_pulldown_en((gpio_num_t)GPIO_ACC_FRONT_INT1);
+    rtc_gpio_pullup_dis((gpio_num_t)GPIO_ACC_REAR_INT1);
+    rtc_gpio_pulldown_en((gpio_num_t)GPIO_ACC_REAR_INT1);
+    rtc_gpio_hold_en((gpio_num_t)TFT_I2C_POWER);
+    rtc_gpio_hold_en((gpio_num_t)GPIO_ACC_FRONT_SDO);
+#endif
+
     // Keep RTC peripherals powered during sleep for GPIO wakeup
     esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
 
@@ -109,6 +378,10 @@ void enter_deep_sleep(void) {
 
     ESP_LOGI(TAG, "Wake sources configured: GPIO %d (MODE), GPIO %d (UP)",
              GPIO_BUTTON_MODE, GPIO_BUTTON_UP);
+#if ACCEL_WAKE_ON_MOTION
+    ESP_LOGI(TAG, "Motion wake configured: GPIO %d (front INT1), GPIO %d (rear INT1)",
+             GPIO_ACC_FRONT_INT1, GPIO_ACC_REAR_INT1);
+#endif
 
     // Small delay to ensure log is flushed
     vTaskDelay(pdMS_TO_TICKS(100));
@@ -206,31 +479,599 @@ void unlock_solenoids(void) {
 // ============================================================================
 // Motor Control Functions
 // ============================================================================
+// direction: 1 = up/forward, -1 = down/reverse, 0 = stop. Only posts the
+// request; motor_task replans on its next cycle. Up/Down moves all motors
+// (Down homes them while the positions aren't referenced), the Motor N
+// modes only their own. In Level the direction only says the
+// locks are open; the leveling loop drives the motors.
 void spin_motors(int direction) {
-    // Stub function for motor control
-    // direction: 1 = up/forward, -1 = down/reverse, 0 = stop
-    // TODO: Implement CAN bus motor commands
-    static int call_count = 0;
-    if (++call_count % 10 == 0) {  // Log every 10th call to avoid spam
-        ESP_LOGI(TAG, "spin_motors: direction=%d", direction);
+    OperationMode mode = ui.getMode();
+    int selected = (int)mode - (int)OperationMode::MOTOR_1;
+    uint8_t selection = 0;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        if (mode == OperationMode::UP_DOWN || selected == i) {
+            selection |= 1 << i;
+        }
+    }
+    motor_selection = selection;
+    motor_direction = direction;
+}
+
+// Replan from the current setpoint, so a release or reverse mid-move ramps
+// rather than steps. A held button plans a long move (up to the joint
+// limits); release stops it.
+static void plan_motion(int64_t now, int direction, uint8_t selection) {
+    if (direction == 0) {
+        planner.stop(now);
+        return;
+    }
+    TrajectoryPlanner::Setpoint current;
+    planner.sample(now, &current);
+    float step[MOTOR_COUNT];
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        bool moves = selection & (1 << i);
+        step[i] = moves ? direction * MOTOR_HOLD_TRAVEL_RAD : 0.0f;
+    }
+    kinematics.clampStep(current.position, step);
+    float targets[MOTOR_COUNT];
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        targets[i] = current.position[i] + step[i];
+    }
+    planner.plan(now, targets);
+}
+
+// Roll/Pitch/Torsion presses: one pose step each through the Jacobian,
+// planned once the locks are open. Presses during a step extend its target.
+// Returns true if a step was (re)planned.
+static bool plan_adjustment(int64_t now, bool adjusting, float* target) {
+    float pose[FrameKinematics::AXIS_COUNT];
+    bool pending = false;
+    for (int axis = 0; axis < FrameKinematics::AXIS_COUNT; axis++) {
+        int steps = adjust_steps[axis].exchange(0);
+        pose[axis] = steps * ADJUST_STEP_DEG;
+        pending = pending || steps != 0;
+    }
+    if (!pending) {
+        return false;
+    }
+
+    if (!adjusting) {
+        TrajectoryPlanner::Setpoint current;
+        planner.sample(now, &current);
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            target[i] = current.position[i];
+        }
+    }
+    float step[MOTOR_COUNT];
+    kinematics.toJoints(pose, step);
+    float kept = kinematics.clampStep(target, step);
+    if (kept < 1.0f) {
+        ESP_LOGW(TAG, "Adjust: step cut to %.0f%% by joint limits", kept * 100.0f);
+    }
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        target[i] += step[i];
+    }
+    planner.plan(now, target);
+    return true;
+}
+
+void actuator_stop(void);  // See Actuator Sequencing
+
+// Referenced: full speed within the soft limits. Otherwise creep, and the
+// only sure bound is one stroke either way from where the motors booted.
+static void apply_motion_limits(bool referenced) {
+    float joint_min[MOTOR_COUNT];
+    float joint_max[MOTOR_COUNT];
+    float speed[MOTOR_COUNT];
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        joint_min[i] = referenced ? soft_limits.min_rad[i] : -ACTUATOR_STROKE_MM / ACTUATOR_MM_PER_RAD;
+        joint_max[i] = referenced ? soft_limits.max_rad[i] : ACTUATOR_STROKE_MM / ACTUATOR_MM_PER_RAD;
+        speed[i] = referenced ? MOTOR_SPEED_RAD_S : MOTOR_CREEP_RAD_S;
+    }
+    kinematics.setJointLimits(joint_min, joint_max);
+    planner.setMaxVelocity(speed);
+}
+
+// Moves start from where the motors are, not where the last plan left them
+// (leveling and homing bypass the planner, and the motors lag it)
+static void sync_planner(int64_t now) {
+    if (planner.isDone(now)) {
+        planner.reset(homing.getPositions());
+    }
+}
+
+static void log_homing_result(void) {
+    const MotorHoming::Metrics& metrics = homing.getMetrics();
+    ESP_LOGI(TAG, "Homing: %s after %.1f s", MotorHoming::stateName(homing.getState()), metrics.duration_us * 1e-6f);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        if (metrics.stop_us[i] >= 0) {
+            ESP_LOGI(TAG, "Motor %d at the stop after %.2f s, %.1f rad, %.2f Nm peak", i + 1,
+                     metrics.stop_us[i] * 1e-6f, metrics.travel_rad[i], metrics.peak_torque_nm[i]);
+        } else {
+            ESP_LOGW(TAG, "Motor %d: stop not found", i + 1);
+        }
+    }
+}
+
+// Overload / stall events as they start and end
+static void log_supervisor_conditions(uint8_t* last_conditions) {
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        uint8_t conditions = supervisor.getConditions(i);
+        if (conditions == last_conditions[i]) {
+            continue;
+        }
+        if (conditions) {
+            bool overloaded = conditions & MotorSupervisor::OVERLOADED;
+            bool stalled = conditions & MotorSupervisor::STALLED;
+            ESP_LOGW(TAG, "Motor %d %s - balancing", i + 1,
+                     overloaded && stalled ? "overloaded and stalled" : overloaded ? "overloaded" : "stalled");
+        } else {
+            ESP_LOGI(TAG, "Motor %d recovered", i + 1);
+        }
+        last_conditions[i] = conditions;
+    }
+}
+
+static void log_level_result(void) {
+    const LevelController::Metrics& metrics = leveler.getMetrics();
+    ESP_LOGI(TAG, "Level: %s after %.1f s (pitch %+.2f, roll %+.2f deg at start), time to level %.1f s, "
+             "overshoot %.2f deg, %lu/%lu updates saturated",
+             LevelController::stateName(leveler.getState()), metrics.duration_us * 1e-6f,
+             metrics.initial_pitch_deg, metrics.initial_roll_deg, metrics.time_to_level_us * 1e-6f,
+             metrics.overshoot_deg, (unsigned long)metrics.saturated_updates, (unsigned long)metrics.updates);
+}
+
+// Latest telemetry window: load and errors, then round trips per motor and
+// (at debug level) the rate of every identifier
+static void log_can_telemetry(void) {
+    static CanTelemetry::Report report;  // Too big for the motor task's stack
+    if (!can_telemetry.read(&report)) {
+        return;
+    }
+    const CanBusStatus& status = report.status;
+    ESP_LOGI(TAG, "CAN last %lld ms: load %.1f%%, %.0f tx/s, %.0f rx/s, TX queue high-water %lu/%d, "
+             "TEC %lu REC %lu%s, %lu bus errors, %lu TX failed, %lu RX missed, %lu arbitration lost",
+             report.window_us / 1000, report.load_pct, report.tx_per_second, report.rx_per_second,
+             (unsigned long)report.tx_queue_high_water, CAN_TX_QUEUE_LEN, (unsigned long)status.tx_error_counter,
+             (unsigned long)status.rx_error_counter, status.bus_off ? " (bus off)" : "",
+             (unsigned long)report.bus_errors, (unsigned long)report.tx_failed, (unsigned long)report.rx_missed,
+             (unsigned long)report.arb_lost);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const CanTelemetry::RoundTrip& trip = report.round_trip[i];
+        ESP_LOGI(TAG, "Motor %d round trip: %lu replies, %lu lost, %lu/%lu/%lu us min/avg/max", i + 1,
+                 (unsigned long)trip.samples, (unsigned long)trip.lost, (unsigned long)trip.min_us,
+                 (unsigned long)trip.avg_us, (unsigned long)trip.max_us);
+    }
+    for (int i = 0; i < report.id_count; i++) {
+        ESP_LOGD(TAG, "CAN %s 0x%08lX: %.1f/s", report.ids[i].received ? "rx" : "tx",
+                 (unsigned long)report.ids[i].id, report.ids[i].per_second);
+    }
+    if (report.untracked_frames) {
+        ESP_LOGD(TAG, "CAN: %lu frames from untracked identifiers", (unsigned long)report.untracked_frames);
+    }
+}
+
+// Receive dispatcher: sleeps until the driver raises an RX alert, then
+// decodes everything queued into the per-motor state cache. Runs above every
+// task that reads the cache (see MotorStateCache).
+void can_rx_task(void *pvParameter) {
+    ESP_LOGI(TAG, "CAN receive task started");
+
+    CanFrame frame;
+    while (1) {
+        if (!can_bus.waitForReceive(portMAX_DELAY)) {
+            continue;
+        }
+        while (can_bus.receive(&frame, 0)) {
+            int motor;
+            MotorState state;
+            int64_t now = esp_timer_get_time();
+            can_telemetry.onReceive(frame, now);
+            if (motors.decode(frame, now, &motor, &state)) {
+                motor_states.publish(motor, state);
+                can_feedback_frames++;
+            } else {
+                can_other_frames++;
+            }
+        }
+    }
+}
+
+// Fixed-rate command cycle: replan on a new request or adjustment step,
+// then stream the planner's velocity setpoints through the supervisor (or,
+// while homing or leveling, their speeds) as one batch for all motors per
+// period. Speed references only:
+// feedback positions span just +-4 pi rad, so they can't close a position
+// loop over a full move.
+void motor_task(void *pvParameter) {
+    ESP_LOGI(TAG, "Motor task started (%d motors, %d ms cycle)", MOTOR_COUNT, MOTOR_CYCLE_MS);
+    if (!kinematics.isValid()) {
+        ESP_LOGE(TAG, "MOTOR_PITCH_SIGNS / MOTOR_ROLL_SIGNS don't put one motor on each corner");
+    }
+
+    int64_t stats_start = esp_timer_get_time();
+    uint8_t last_faults[MOTOR_COUNT] = {};
+    int direction = 0;
+    uint8_t selection = 0;
+    uint32_t plans = 0;
+    int64_t plan_max_us = 0;
+    bool leveling = false;
+    bool adjusting = false;
+    float adjust_target[MOTOR_COUNT] = {};
+    const uint8_t all_motors = (1 << MOTOR_COUNT) - 1;
+    uint8_t last_conditions[MOTOR_COUNT] = {};
+    bool motors_off = false;    // Shutdown's stop frames sent
+
+    bool referenced = homing.isReferenced();
+    ESP_LOGI(TAG, "Motor positions %s",
+             referenced ? "restored" : "not referenced (Down homes; until then moves creep)");
+    apply_motion_limits(referenced);
+    planner.reset(homing.getPositions());
+    TickType_t last_wake = xTaskGetTickCount();
+
+    // The planner runs on its own clock, slowed while the supervisor balances
+    int64_t last_cycle = esp_timer_get_time();
+    int64_t plan_clock = last_cycle;
+
+    while (1) {
+        int64_t now = esp_timer_get_time();
+        plan_clock += (int64_t)((now - last_cycle) * supervisor.getScale());
+        last_cycle = now;
+
+        // Positions follow the feedback, whatever is driving the motors
+        MotorState states[MOTOR_COUNT];
+        bool valid[MOTOR_COUNT];
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            valid[i] = motor_states.read(i, &states[i]);
+            if (valid[i]) {
+                homing.track(i, states[i]);
+            }
+            motor_position_rad[i] = homing.getPositions()[i];
+        }
+
+        bool halted = motor_halt.load();
+        int requested = motor_direction.load();
+        uint8_t requested_selection = motor_selection.load();
+        if (requested != direction || requested_selection != selection) {
+            direction = requested;
+            selection = requested_selection;
+            if (homing.isActive()) {
+                homing.cancel();
+                log_homing_result();
+                planner.reset(homing.getPositions());
+            }
+            if (direction < 0 && selection == all_motors && !homing.isReferenced() && !level_requested.load()) {
+                ESP_LOGI(TAG, "Homing: all motors down to the stops");
+                homing.start(now);
+            } else {
+                sync_planner(plan_clock);
+                plan_motion(plan_clock, direction, selection);
+                int64_t plan_us = esp_timer_get_time() - now;
+                plan_max_us = plan_us > plan_max_us ? plan_us : plan_max_us;
+                plans++;
+            }
+        }
+
+        if (homing.isActive() && !halted) {
+            // Each motor runs until it stalls against its stop
+            const MotorHoming::Output& out = homing.update(now, states, valid);
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                motors.setVelocity(i, out.motor_rad_s[i]);
+            }
+            if (!homing.isActive()) {
+                log_homing_result();
+                if (homing.isReferenced()) {
+                    motors_referenced = true;
+                    apply_motion_limits(true);
+                }
+                planner.reset(homing.getPositions());
+                actuator_stop();
+            }
+        } else if (level_requested.load() && direction != 0 && !halted) {
+            // Leveling once the locks are open, until it ends or is cancelled
+            if (!leveling) {
+                leveler.start(now);
+                leveling = true;
+            }
+            const LevelController::Output& out =
+                leveler.update(now, attitude_pitch_deg.load(), attitude_roll_deg.load(), attitude_time_us.load(),
+                               homing.getPositions());
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                motors.setVelocity(i, out.motor_rad_s[i]);
+            }
+            if (!leveler.isActive()) {
+                log_level_result();
+                leveling = false;
+                level_requested = false;
+                actuator_stop();
+            }
+        } else {
+            if (leveling) {
+                leveler.cancel();
+                log_level_result();
+                leveling = false;
+            }
+            if (direction == 0) {
+                adjusting = false;
+            } else if (!adjusting) {
+                sync_planner(plan_clock);
+            }
+            if (direction != 0 && plan_adjustment(plan_clock, adjusting, adjust_target)) {
+                adjusting = true;
+            }
+
+            TrajectoryPlanner::Setpoint setpoint;
+            planner.sample(plan_clock, &setpoint);
+            if (setpoint.done || halted) {
+                supervisor.idle(now);
+                motors.stopAll();
+            } else {
+                const MotorSupervisor::Output& out = supervisor.update(
+                    now, setpoint.position, setpoint.velocity, homing.getPositions(), states, valid);
+                for (int i = 0; i < MOTOR_COUNT; i++) {
+                    motors.setVelocity(i, out.motor_rad_s[i]);
+                }
+                if (out.abort) {
+                    // Stalled for good: stop where the motors are
+                    ESP_LOGE(TAG, "Move aborted: motor stalled for %d ms", MOTOR_STALL_TIMEOUT_MS);
+                    planner.reset(homing.getPositions());
+                    adjusting = false;
+                    actuator_stop();
+                }
+            }
+            log_supervisor_conditions(last_conditions);
+            if (adjusting && setpoint.done) {
+                adjusting = false;
+                actuator_stop();
+            }
+        }
+        if (halted && !motors_off) {
+            motors.disableAll();
+            motors_off = true;
+            TaskHandle_t waiter = motor_halt_waiter.load();
+            if (waiter) {
+                xTaskNotifyGive(waiter);
+            }
+        }
+        motors.cycle();
+        if (!halted) {
+            can_scheduler.flush(now);
+        }
+        can_telemetry.roll(now, CAN_TELEMETRY_WINDOW_MS * 1000);
+
+        // Faults are latched by the motor; log when they change
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (valid[i] && states[i].faults != last_faults[i]) {
+                last_faults[i] = states[i].faults;
+                ESP_LOGW(TAG, "Motor %d faults 0x%02X", i + 1, states[i].faults);
+            }
+        }
+
+        if (now - stats_start >= 10000000) {
+            MotorController::Stats stats = motors.takeStats();
+            TwaiBus::Stats bus_stats = can_bus.takeStats();
+            ESP_LOGI(TAG, "CAN: %lu frames sent, %lu dropped, %lu received (%lu feedback, %lu other), "
+                     "%lu lost (queue full %lu), %lu bus errors",
+                     (unsigned long)stats.frames_sent, (unsigned long)stats.frames_dropped,
+                     (unsigned long)bus_stats.rx_frames, (unsigned long)can_feedback_frames.exchange(0),
+                     (unsigned long)can_other_frames.exchange(0),
+                     (unsigned long)(bus_stats.rx_missed + bus_stats.rx_queue_full),
+                     (unsigned long)bus_stats.rx_queue_full, (unsigned long)bus_stats.bus_errors);
+            log_can_telemetry();
+            CanScheduler::Stats tx = can_scheduler.takeStats();
+            ESP_LOGI(TAG, "CAN TX: %lu control, %lu setpoints (%lu replaced unsent), %lu status requests "
+                     "(%lu redundant), %lu deadline misses, %lu refused, backlog %lu max",
+                     (unsigned long)tx.control_sent, (unsigned long)tx.setpoints_sent,
+                     (unsigned long)tx.setpoints_replaced, (unsigned long)tx.status_sent,
+                     (unsigned long)tx.status_redundant, (unsigned long)tx.deadline_misses,
+                     (unsigned long)tx.control_refused, (unsigned long)tx.max_backlog);
+            MotorSupervisor::Stats balance = supervisor.takeStats();
+            if (balance.events || balance.balancing_us) {
+                ESP_LOGI(TAG, "Balance: %lu overload/stall events, %lu stalls avoided, %lu aborted, "
+                         "balancing %.1f s, %.1f s lost, worst spread %.2f rad",
+                         (unsigned long)balance.events, (unsigned long)balance.stalls_avoided,
+                         (unsigned long)balance.aborts, balance.balancing_us * 1e-6f, balance.time_lost_us * 1e-6f,
+                         balance.max_lag_spread_rad);
+            }
+            if (plans) {
+                ESP_LOGI(TAG, "Planner: %lu plans, %lld us max", (unsigned long)plans, plan_max_us);
+                plans = 0;
+                plan_max_us = 0;
+            }
+            for (int i = 0; i < MOTOR_COUNT; i++) {
+                MotorState state;
+                if (motor_states.read(i, &state)) {
+                    ESP_LOGI(TAG, "Motor %d: %.2f rad (joint %.1f rad%s), %.2f rad/s, %.2f Nm, %.1f C, %lld ms old",
+                             i + 1, state.position, homing.getPositions()[i],
+                             homing.isReferenced() ? "" : ", not referenced", state.velocity, state.torque,
+                             state.temperature, (now - state.timestamp_us) / 1000);
+                }
+            }
+            stats_start = now;
+        }
+
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(MOTOR_CYCLE_MS));
+    }
+}
+
+// Soft limits from NVS (defaults saved on first boot), and the positions
+// saved at the last clean shutdown. Those are used once: erased here so a
+// power cut before the next shutdown boots unreferenced.
+static void restore_motor_positions(void) {
+    if (!nvs_store_load(NVS_KEY_SOFT_LIMITS, &soft_limits, sizeof(soft_limits))) {
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            soft_limits.min_rad[i] = ACTUATOR_SOFT_MARGIN_MM / ACTUATOR_MM_PER_RAD;
+            soft_limits.max_rad[i] = (ACTUATOR_STROKE_MM - ACTUATOR_SOFT_MARGIN_MM) / ACTUATOR_MM_PER_RAD;
+        }
+        nvs_store_save(NVS_KEY_SOFT_LIMITS, &soft_limits, sizeof(soft_limits));
+    }
+
+    MotorPositions saved;
+    if (nvs_store_load(NVS_KEY_MOTOR_POSITIONS, &saved, sizeof(saved))) {
+        nvs_store_erase(NVS_KEY_MOTOR_POSITIONS);
+        homing.restore(saved.position_rad);
+        motors_referenced = true;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            ESP_LOGI(TAG, "Motor %d: restored at %.1f rad (soft limits %.1f..%.1f)", i + 1, saved.position_rad[i],
+                     soft_limits.min_rad[i], soft_limits.max_rad[i]);
+        }
+    }
+}
+
+void init_motors(void) {
+    restore_motor_positions();
+    if (!can_bus.init(TwaiBus::Config{
+            .tx_io_num = (gpio_num_t)GPIO_CAN_TX,
+            .rx_io_num = (gpio_num_t)GPIO_CAN_RX,
+            .tx_queue_len = CAN_TX_QUEUE_LEN,
+            .rx_queue_len = CAN_RX_QUEUE_LEN,
+        })) {
+        ESP_LOGE(TAG, "Failed to initialize CAN bus");
+        return;
     }
+    ESP_LOGI(TAG, "CAN initialized: TX=%d, RX=%d, 1 Mbit/s", GPIO_CAN_TX, GPIO_CAN_RX);
+}
+
+// ============================================================================
+// Actuator Sequencing
+// ============================================================================
+// Button handlers only post the latest request here; the actuator task owns
+// the sequencer and an esp_timer wakes it for each scheduled step. Both wake
+// it through notification bits, which can't be dropped or pile up: a stop
+// is never lost behind button traffic, and a burst of requests collapses
+// into the last one (the sequencer only needs the final direction).
+static constexpr uint32_t ACTUATOR_NOTIFY_REQUEST = 0x01;  // actuator_request changed
+static constexpr uint32_t ACTUATOR_NOTIFY_TICK = 0x02;     // Scheduled step is due
+
+static TaskHandle_t actuator_task_handle = NULL;
+static std::atomic<int> actuator_request{0};     // +1 up, -1 down, 0 stop
+static esp_timer_handle_t actuator_timer = NULL;
+static std::atomic<bool> motors_running{false};  // Sequencer out of LOCKED (sampling policy)
+
+static void actuator_notify(uint32_t bits) {
+    if (actuator_task_handle) {
+        xTaskNotify(actuator_task_handle, bits, eSetBits);
+    }
+}
+
+static void actuator_timer_callback(void* arg) {
+    actuator_notify(ACTUATOR_NOTIFY_TICK);
+}
+
+void actuator_task(void *pvParameter) {
+    ActuatorSequencer sequencer(ActuatorSequencer::Config{
+        .unlock = unlock_solenoids,
+        .lock = lock_solenoids,
+        .spin = spin_motors,
+        .unlock_settle_us = LOCK_RELEASE_DELAY_MS * 1000LL,
+        .stop_settle_us = MOTOR_STOP_DELAY_MS * 1000LL,
+        .repeat_period_us = MOTOR_SPIN_PERIOD_MS * 1000LL,
+    });
+
+    ESP_LOGI(TAG, "Actuator task started");
+
+    while (1) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+
+        int64_t now = esp_timer_get_time();
+        if (bits & ACTUATOR_NOTIFY_REQUEST) {
+            int request = actuator_request.load();
+            if (request != 0) {
+                sequencer.move(request, now);
+            } else {
+                sequencer.stop(now);
+            }
+        }
+        // Stale ticks are harmless - update() ignores steps not yet due
+        int64_t deadline = sequencer.update(now);
+
+        // Bring the accelerometers to full rate as soon as a move starts
+        bool running = sequencer.getPhase() != ActuatorSequencer::Phase::LOCKED;
+        if (running != motors_running.exchange(running) && running) {
+            xSemaphoreGive(accel_wake_semaphore);
+        }
+
+        // Re-arm the step timer for the next deadline
+        esp_timer_stop(actuator_timer);
+        if (deadline != ActuatorSequencer::NO_DEADLINE) {
+            int64_t wait_us = deadline - esp_timer_get_time();
+            esp_timer_start_once(actuator_timer, wait_us > 0 ? wait_us : 0);
+        }
+    }
+}
+
+void init_actuators(void) {
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = actuator_timer_callback;
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+    timer_args.name = "actuator";
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &actuator_timer));
+}
+
+// Non-blocking requests (safe to call from any task)
+void actuator_move(int direction) {
+    actuator_request = direction > 0 ? 1 : -1;
+    actuator_notify(ACTUATOR_NOTIFY_REQUEST);
+}
+
+void actuator_stop(void) {
+    actuator_request = 0;
+    actuator_notify(ACTUATOR_NOTIFY_REQUEST);
 }
 
 // ============================================================================
 // Accelerometer Initialization
 // ============================================================================
+#if ACCEL_WAKE_ON_MOTION
+static void IRAM_ATTR accel_motion_isr_handler(void* arg) {
+    BaseType_t high_task_awoken = pdFALSE;
+    xSemaphoreGiveFromISR(accel_wake_semaphore, &high_task_awoken);
+    if (high_task_awoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Activity interrupt pins (rising edge = motion detected)
+static void init_accel_motion_pins(void) {
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_POSEDGE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << GPIO_ACC_FRONT_INT1) | (1ULL << GPIO_ACC_REAR_INT1);
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
+    gpio_config(&io_conf);
+
+    // Shared with the button handlers (already-installed is fine)
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add((gpio_num_t)GPIO_ACC_FRONT_INT1, accel_motion_isr_handler, NULL);
+    gpio_isr_handler_add((gpio_num_t)GPIO_ACC_REAR_INT1, accel_motion_isr_handler, NULL);
+}
+
+static bool accel_motion_pending(void) {
+    return gpio_get_level((gpio_num_t)GPIO_ACC_FRONT_INT1) || gpio_get_level((gpio_num_t)GPIO_ACC_REAR_INT1);
+}
+#endif
+
 void init_accelerometers(void) {
     ESP_LOGI(TAG, "Initializing accelerometers");
 
-    // Initialize I2C bus
-    i2c = std::make_shared<espp::I2c>(espp::I2c::Config{
-        .port = I2C_NUM_0,
-        .sda_io_num = (gpio_num_t)GPIO_I2C_SDA,
-        .scl_io_num = (gpio_num_t)GPIO_I2C_SCL,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .clk_speed = I2C_FREQ_HZ,
-    });
+    accel_wake_semaphore = xSemaphoreCreateBinary();
+
+    // Initialize I2C bus (async transaction queue)
+    if (!i2c_bus.init(I2cBus::Config{
+            .port = I2C_NUM_0,
+            .sda_io_num = (gpio_num_t)GPIO_I2C_SDA,
+            .scl_io_num = (gpio_num_t)GPIO_I2C_SCL,
+            .clk_speed = I2C_FREQ_HZ,
+            .queue_depth = I2C_QUEUE_DEPTH,
+            .timeout_ms = I2C_TIMEOUT_MS,
+        })) {
+        ESP_LOGE(TAG, "Failed to initialize I2C bus");
+        return;
+    }
+    i2c_bus.addDevice(I2C_ADDR_ACC_REAR);
+    i2c_bus.addDevice(I2C_ADDR_ACC_FRONT);
 
     ESP_LOGI(TAG, "I2C initialized: SDA=%d, SCL=%d, Freq=%dHz",
              GPIO_I2C_SDA, GPIO_I2C_SCL, I2C_FREQ_HZ);
@@ -239,39 +1080,73 @@ void init_accelerometers(void) {
     vTaskDelay(pdMS_TO_TICKS(50));
 
     // Initialize rear accelerometer (address 0x53)
-    acc_rear = std::make_unique<espp::Adxl345>(espp::Adxl345::Config{
+    acc_rear = std::make_unique<AccelSensor>(AccelSensor::Config{
         .device_address = I2C_ADDR_ACC_REAR,
-        .write = std::bind(&espp::I2c::write, i2c.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-        .read = std::bind(&espp::I2c::read, i2c.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-        .log_level = espp::Logger::Verbosity::WARN
+        .write = std::bind(&I2cBus::write, &i2c_bus, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+        .write_read = std::bind(&I2cBus::write_read, &i2c_bus, std::placeholders::_1, std::placeholders::_2,
+                                std::placeholders::_3, std::placeholders::_4, std::placeholders::_5),
+        .wait = std::bind(&I2cBus::wait, &i2c_bus),
     });
 
     // Initialize front accelerometer (address 0x1D)
-    acc_front = std::make_unique<espp::Adxl345>(espp::Adxl345::Config{
+    acc_front = std::make_unique<AccelSensor>(AccelSensor::Config{
         .device_address = I2C_ADDR_ACC_FRONT,
-        .write = std::bind(&espp::I2c::write, i2c.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-        .read = std::bind(&espp::I2c::read, i2c.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-        .log_level = espp::Logger::Verbosity::WARN
+        .write = std::bind(&I2cBus::write, &i2c_bus, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+        .write_read = std::bind(&I2cBus::write_read, &i2c_bus, std::placeholders::_1, std::placeholders::_2,
+                                std::placeholders::_3, std::placeholders::_4, std::placeholders::_5),
+        .wait = std::bind(&I2cBus::wait, &i2c_bus),
     });
 
-    // Configure rear accelerometer
-    std::error_code ec_rear;
-    if (acc_rear->initialize(ec_rear)) {
-        acc_rear->set_range(espp::Adxl345::RANGE_4G, ec_rear);
-        acc_rear->set_data_rate(espp::Adxl345::RATE_100_HZ, ec_rear);
-        ESP_LOGI(TAG, "Rear accelerometer initialized (0x%02X)", I2C_ADDR_ACC_REAR);
+    // Restore offsets from the last calibration (zero if never calibrated)
+    AccelCalibration calibration = {};
+    if (nvs_store_load(NVS_KEY_ACCEL_CAL, &calibration, sizeof(calibration))) {
+        ESP_LOGI(TAG, "Calibration restored: front (%d, %d, %d), rear (%d, %d, %d)",
+                 calibration.front.x, calibration.front.y, calibration.front.z,
+                 calibration.rear.x, calibration.rear.y, calibration.rear.z);
+    }
+
+    // Anti-alias filters down to the control rate
+    const Decimator::Config decimator_config = {
+        .factor = ACCEL_DECIMATION,
+        .taps = ACCEL_DECIMATOR_TAPS,
+        .cutoff = ACCEL_DECIMATOR_CUTOFF,
+    };
+    front_decimator.init(decimator_config);
+    rear_decimator.init(decimator_config);
+    if (ACCEL_DECIMATION > 1) {
+        ESP_LOGI(TAG, "Decimating %.0f Hz by %d, %d taps, stopband %.1f dB",
+                 adxl345::rate_hz(ACCEL_RATE_CODE), ACCEL_DECIMATION, ACCEL_DECIMATOR_TAPS,
+                 front_decimator.getStopbandDb());
+    }
+
+#if ACCEL_WAKE_ON_MOTION
+    accel_motion = {
+        .activity_threshold = ACCEL_ACTIVITY_THRESHOLD,
+        .inactivity_threshold = ACCEL_INACTIVITY_THRESHOLD,
+        .inactivity_time_s = ACCEL_INACTIVITY_TIME_S,
+    };
+    init_accel_motion_pins();
+#endif
+
+    // Sensors that fail here start offline and are re-probed by the task
+    rear_health = i2c_health.addDevice();
+    front_health = i2c_health.addDevice();
+
+    // Configure both in FIFO stream mode
+    if (acc_rear->init(ACCEL_RATE_CODE, ACCEL_FIFO_WATERMARK, calibration.rear, accel_motion)) {
+        ESP_LOGI(TAG, "Rear accelerometer initialized (0x%02X), FIFO stream at %.0f Hz",
+                 I2C_ADDR_ACC_REAR, adxl345::rate_hz(ACCEL_RATE_CODE));
     } else {
-        ESP_LOGE(TAG, "Failed to initialize rear accelerometer: %s", ec_rear.message().c_str());
+        ESP_LOGE(TAG, "Failed to initialize rear accelerometer (0x%02X)", I2C_ADDR_ACC_REAR);
+        i2c_health.setOffline(rear_health, esp_timer_get_time());
     }
 
-    // Configure front accelerometer
-    std::error_code ec_front;
-    if (acc_front->initialize(ec_front)) {
-        acc_front->set_range(espp::Adxl345::RANGE_4G, ec_front);
-        acc_front->set_data_rate(espp::Adxl345::RATE_100_HZ, ec_front);
-        ESP_LOGI(TAG, "Front accelerometer initialized (0x%02X)", I2C_ADDR_ACC_FRONT);
+    if (acc_front->init(ACCEL_RATE_CODE, ACCEL_FIFO_WATERMARK, calibration.front, accel_motion)) {
+        ESP_LOGI(TAG, "Front accelerometer initialized (0x%02X), FIFO stream at %.0f Hz",
+                 I2C_ADDR_ACC_FRONT, adxl345::rate_hz(ACCEL_RATE_CODE));
     } else {
-        ESP_LOGE(TAG, "Failed to initialize front accelerometer: %s", ec_front.message().c_str());
+        ESP_LOGE(TAG, "Failed to initialize front accelerometer (0x%02X)", I2C_ADDR_ACC_FRONT);
+        i2c_health.setOffline(front_health, esp_timer_get_time());
     }
 
     // Update sensor monitor state
@@ -332,17 +1207,32 @@ void init_gpio_pins(void) {
 // GPIO Interrupt Handling
 // ============================================================================
 static void IRAM_ATTR gpio_isr_handler(void* arg) {
+    uint32_t start = esp_cpu_get_cycle_count();
     gpio_num_t gpio_num = (gpio_num_t)(uint32_t)arg;
     xQueueSendFromISR(gpio_event_queue, &gpio_num, NULL);
+
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    gpio_isr_stats.isr_count++;
+    gpio_isr_stats.isr_cycles += cycles;
+    if (cycles > gpio_isr_stats.isr_cycles_max) {
+        gpio_isr_stats.isr_cycles_max = cycles;
+    }
 }
 
 void init_gpio_buttons(void) {
     // Create event queue
     gpio_event_queue = xQueueCreate(10, sizeof(gpio_num_t));
 
+#if BUTTON_SCANNER_ENABLED
+    // Scanner samples the input register itself, no pin interrupts needed
+    const gpio_int_type_t button_intr_type = GPIO_INTR_DISABLE;
+#else
+    const gpio_int_type_t button_intr_type = GPIO_INTR_ANYEDGE;
+#endif
+
     // Configure GPIO_BUTTON_UP (D2)
     gpio_config_t io_conf_up = {};
-    io_conf_up.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf_up.intr_type = button_intr_type;
     io_conf_up.mode = GPIO_MODE_INPUT;
     io_conf_up.pin_bit_mask = (1ULL << GPIO_BUTTON_UP);
     io_conf_up.pull_up_en = GPIO_PULLUP_DISABLE;
@@ -351,7 +1241,7 @@ void init_gpio_buttons(void) {
 
     // Configure GPIO_BUTTON_MODE (D1)
     gpio_config_t io_conf_mode = {};
-    io_conf_mode.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf_mode.intr_type = button_intr_type;
     io_conf_mode.mode = GPIO_MODE_INPUT;
     io_conf_mode.pin_bit_mask = (1ULL << GPIO_BUTTON_MODE);
     io_conf_mode.pull_up_en = GPIO_PULLUP_DISABLE;
@@ -360,13 +1250,18 @@ void init_gpio_buttons(void) {
 
     // Configure GPIO_BUTTON_DOWN (D0)
     gpio_config_t io_conf_down = {};
-    io_conf_down.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf_down.intr_type = button_intr_type;
     io_conf_down.mode = GPIO_MODE_INPUT;
     io_conf_down.pin_bit_mask = (1ULL << GPIO_BUTTON_DOWN);
     io_conf_down.pull_up_en = GPIO_PULLUP_ENABLE;
     io_conf_down.pull_down_en = GPIO_PULLDOWN_DISABLE;
     gpio_config(&io_conf_down);
 
+#if BUTTON_SCANNER_ENABLED
+    // Start timer-driven scanner
+    ESP_ERROR_CHECK(button_scanner_start(gpio_event_queue));
+    ESP_LOGI(TAG, "GPIO buttons initialized (scanner mode)");
+#else
     // Install ISR service
     gpio_install_isr_service(0);
 
@@ -375,117 +1270,171 @@ void init_gpio_buttons(void) {
     gpio_isr_handler_add((gpio_num_t)GPIO_BUTTON_MODE, gpio_isr_handler, (void*)GPIO_BUTTON_MODE);
     gpio_isr_handler_add((gpio_num_t)GPIO_BUTTON_DOWN, gpio_isr_handler, (void*)GPIO_BUTTON_DOWN);
 
-    ESP_LOGI(TAG, "GPIO buttons initialized");
+    ESP_LOGI(TAG, "GPIO buttons initialized (interrupt mode)");
+#endif
+}
+
+// Read a button's pressed state from the active input path
+static bool read_button_pressed(gpio_num_t gpio_num, bool active_low) {
+#if BUTTON_SCANNER_ENABLED
+    return button_scanner_is_pressed(gpio_num);
+#else
+    return gpio_get_level(gpio_num) == !active_low;
+#endif
+}
+
+// Log ISR cost of the active input path (for comparing scanner vs interrupts)
+void log_button_input_stats(void) {
+#if BUTTON_SCANNER_ENABLED
+    ButtonInputStats stats = button_scanner_get_stats();
+    const char* path = "scanner";
+#else
+    ButtonInputStats stats = gpio_isr_stats;
+    const char* path = "gpio isr";
+#endif
+    uint32_t avg_cycles = stats.isr_count ? (uint32_t)(stats.isr_cycles / stats.isr_count) : 0;
+    ESP_LOGI(TAG, "Button input (%s): %lu ISRs, avg %lu cycles, max %lu cycles, total %llu cycles",
+             path, (unsigned long)stats.isr_count, (unsigned long)avg_cycles,
+             (unsigned long)stats.isr_cycles_max, stats.isr_cycles);
 }
 
 // ============================================================================
-// Button Event Handlers
+// Mode Action Handlers
 // ============================================================================
-void handle_button_up_press() {
-    reset_activity_timer();
-    OperationMode mode = ui.getMode();
-    ESP_LOGI(TAG, "Button UP pressed in mode %d", (int)mode);
+// Indexed by ModeAction; the (mode, event) -> action mapping lives in
+// mode_state_machine.hpp
+static void action_none(OperationMode mode) {}
 
-    switch (mode) {
-        case OperationMode::UP_DOWN:
-            ESP_LOGI(TAG, "Up/Down: Move up - unlocking and starting motors");
-            unlock_solenoids();
-            vTaskDelay(pdMS_TO_TICKS(100));  // Brief delay for locks to release
-            break;
-        case OperationMode::ROLL:
-        case OperationMode::PITCH:
-        case OperationMode::TORSION:
-            ESP_LOGI(TAG, "%s: Increase", MODE_CONFIGS[(int)mode].name);
-            // TODO: Adjust orientation
-            break;
-        case OperationMode::LEVEL:
-            ESP_LOGI(TAG, "Level: Calibrate +");
-            // TODO: Calibration adjustment
-            break;
-        case OperationMode::MOTOR_1:
-        case OperationMode::MOTOR_2:
-        case OperationMode::MOTOR_3:
-        case OperationMode::MOTOR_4:
-            ESP_LOGI(TAG, "%s: Forward", MODE_CONFIGS[(int)mode].name);
-            // TODO: Individual motor control
-            break;
-        default:
-            break;
+static void action_move_up(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Move up - unlocking and starting motors", MODE_CONFIGS[(int)mode].name);
+    actuator_move(1);
+}
+
+static void action_move_down(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Move down - unlocking and starting motors", MODE_CONFIGS[(int)mode].name);
+    actuator_move(-1);
+}
+
+static void action_move_stop(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Stop motors and lock", MODE_CONFIGS[(int)mode].name);
+    actuator_stop();
+}
+
+// One ADJUST_STEP_DEG step of the mode's axis; motor_task plans it once the
+// sequencer has opened the locks (direction 1 only means "unlocked" here)
+static void adjust_pose(OperationMode mode, int steps) {
+    FrameKinematics::Axis axis = mode == OperationMode::ROLL    ? FrameKinematics::ROLL :
+                                 mode == OperationMode::PITCH   ? FrameKinematics::PITCH :
+                                                                  FrameKinematics::TORSION;
+    adjust_steps[axis] += steps;
+    actuator_move(1);
+}
+
+static void action_adjust_increase(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Increase %.1f deg", MODE_CONFIGS[(int)mode].name, ADJUST_STEP_DEG);
+    adjust_pose(mode, 1);
+}
+
+static void action_adjust_decrease(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Decrease %.1f deg", MODE_CONFIGS[(int)mode].name, ADJUST_STEP_DEG);
+    adjust_pose(mode, -1);
+}
+
+// Leveling runs in motor_task once the sequencer has released the locks;
+// pressing again cancels it
+static void action_level_start(OperationMode mode) {
+    if (level_requested.exchange(false)) {
+        ESP_LOGI(TAG, "Level: cancelled");
+        actuator_stop();
+        return;
     }
+    ESP_LOGI(TAG, "Level: leveling - unlocking and starting motors");
+    level_requested = true;
+    actuator_move(1);
 }
 
-void handle_button_up_release() {
-    reset_activity_timer();
-    OperationMode mode = ui.getMode();
-    ESP_LOGI(TAG, "Button UP released in mode %d", (int)mode);
-
-    switch (mode) {
-        case OperationMode::UP_DOWN:
-            ESP_LOGI(TAG, "Up/Down: Stop motors and lock");
-            spin_motors(0);  // Stop motors
-            vTaskDelay(pdMS_TO_TICKS(50));  // Brief delay for motors to stop
-            lock_solenoids();
-            break;
-        default:
-            break;
+// Calibration runs in the accelerometer task (it owns the bus). Down
+// captures on release; held for ACCEL_CALIBRATION_CLEAR_HOLD_MS it clears the
+// offsets instead (Calibrate -). Capturing on a frame the motors are tilting
+// would store a wrong reference.
+static int64_t calibrate_pressed_us = -1;
+
+static void action_calibrate_hold(OperationMode mode) {
+    calibrate_pressed_us = esp_timer_get_time();
+}
+
+static void action_calibrate(OperationMode mode) {
+    bool clear = calibrate_pressed_us >= 0 &&
+                 esp_timer_get_time() - calibrate_pressed_us >= ACCEL_CALIBRATION_CLEAR_HOLD_MS * 1000LL;
+    calibrate_pressed_us = -1;
+    if (level_requested.load()) {
+        ESP_LOGW(TAG, "Level: not calibrating while leveling");
+        return;
     }
+    if (clear) {
+        ESP_LOGI(TAG, "Level: Calibrate - (clearing offsets)");
+        calibration_request = CalibrationRequest::CLEAR;
+    } else {
+        ESP_LOGI(TAG, "Level: Calibrate + (capturing level reference)");
+        calibration_request = CalibrationRequest::CAPTURE;
+    }
+    xSemaphoreGive(accel_wake_semaphore);
 }
 
-void handle_button_mode_press() {
-    reset_activity_timer();
-    ESP_LOGI(TAG, "Button MODE pressed - cycling mode");
-    ui.cycleMode();
-    ui.refreshModePanel();
-    ui.refreshButtonPanel();
+// Same lock/motor sequence as Up/Down; spin_motors picks the mode's motor
+static void action_motor_forward(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Forward", MODE_CONFIGS[(int)mode].name);
+    actuator_move(1);
 }
 
-void handle_button_down_press() {
-    reset_activity_timer();
-    OperationMode mode = ui.getMode();
-    ESP_LOGI(TAG, "Button DOWN pressed in mode %d", (int)mode);
+static void action_motor_reverse(OperationMode mode) {
+    ESP_LOGI(TAG, "%s: Reverse", MODE_CONFIGS[(int)mode].name);
+    actuator_move(-1);
+}
 
-    switch (mode) {
-        case OperationMode::UP_DOWN:
-            ESP_LOGI(TAG, "Up/Down: Move down - unlocking and starting motors");
-            unlock_solenoids();
-            vTaskDelay(pdMS_TO_TICKS(100));  // Brief delay for locks to release
-            break;
-        case OperationMode::ROLL:
-        case OperationMode::PITCH:
-        case OperationMode::TORSION:
-            ESP_LOGI(TAG, "%s: Decrease", MODE_CONFIGS[(int)mode].name);
-            // TODO: Adjust orientation
-            break;
-        case OperationMode::LEVEL:
-            ESP_LOGI(TAG, "Level: Calibrate -");
-            // TODO: Calibration adjustment
-            break;
-        case OperationMode::MOTOR_1:
-        case OperationMode::MOTOR_2:
-        case OperationMode::MOTOR_3:
-        case OperationMode::MOTOR_4:
-            ESP_LOGI(TAG, "%s: Reverse", MODE_CONFIGS[(int)mode].name);
-            // TODO: Individual motor control
-            break;
-        default:
-            break;
+static void action_cycle_mode(OperationMode mode) {
+    ESP_LOGI(TAG, "Button MODE pressed - cycling mode");
+    level_requested = false;
+    for (std::atomic<int>& steps : adjust_steps) {
+        steps = 0;
     }
+    actuator_stop();  // Leaving the mode ends any move or leveling
 }
 
-void handle_button_down_release() {
+typedef void (*ModeActionHandler)(OperationMode mode);
+
+static const ModeActionHandler MODE_ACTION_HANDLERS[] = {
+    action_none,             // NONE
+    action_move_up,          // MOVE_UP
+    action_move_down,        // MOVE_DOWN
+    action_move_stop,        // MOVE_STOP
+    action_adjust_increase,  // ADJUST_INCREASE
+    action_adjust_decrease,  // ADJUST_DECREASE
+    action_level_start,      // LEVEL_START
+    action_calibrate_hold,   // CALIBRATE_HOLD
+    action_calibrate,        // CALIBRATE
+    action_motor_forward,    // MOTOR_FORWARD
+    action_motor_reverse,    // MOTOR_REVERSE
+    action_cycle_mode,       // CYCLE_MODE
+};
+
+static_assert(sizeof(MODE_ACTION_HANDLERS) / sizeof(MODE_ACTION_HANDLERS[0]) == (int)ModeAction::ACTION_COUNT,
+              "MODE_ACTION_HANDLERS must have one entry per ModeAction");
+
+// Run the action for a button event and apply the resulting mode
+void dispatch_mode_event(ModeEvent event) {
     reset_activity_timer();
     OperationMode mode = ui.getMode();
-    ESP_LOGI(TAG, "Button DOWN released in mode %d", (int)mode);
-
-    switch (mode) {
-        case OperationMode::UP_DOWN:
-            ESP_LOGI(TAG, "Up/Down: Stop motors and lock");
-            spin_motors(0);  // Stop motors
-            vTaskDelay(pdMS_TO_TICKS(50));  // Brief delay for motors to stop
-            lock_solenoids();
-            break;
-        default:
-            break;
+    const ModeTransition& transition = mode_transition(dev_flag, mode, event);
+    ESP_LOGI(TAG, "Event %d in mode %d -> action %d", (int)event, (int)mode, (int)transition.action);
+
+    MODE_ACTION_HANDLERS[(int)transition.action](mode);
+
+    if (transition.next != mode) {
+        ui.setMode(transition.next);
+        ui.refreshModePanel();
+        ui.refreshButtonPanel();
+        xSemaphoreGive(accel_wake_semaphore);  // Sampling follows the mode
     }
 }
 
@@ -501,149 +1450,582 @@ void gpio_event_task(void *pvParameter) {
     ESP_LOGI(TAG, "GPIO event task started");
 
     // Initialize button states
-    last_up_state = (gpio_get_level((gpio_num_t)GPIO_BUTTON_UP) == !BUTTON_UP_ACTIVE_LOW);
-    last_mode_state = (gpio_get_level((gpio_num_t)GPIO_BUTTON_MODE) == !BUTTON_MODE_ACTIVE_LOW);
-    last_down_state = (gpio_get_level((gpio_num_t)GPIO_BUTTON_DOWN) == !BUTTON_DOWN_ACTIVE_LOW);
+    last_up_state = read_button_pressed((gpio_num_t)GPIO_BUTTON_UP, BUTTON_UP_ACTIVE_LOW);
+    last_mode_state = read_button_pressed((gpio_num_t)GPIO_BUTTON_MODE, BUTTON_MODE_ACTIVE_LOW);
+    last_down_state = read_button_pressed((gpio_num_t)GPIO_BUTTON_DOWN, BUTTON_DOWN_ACTIVE_LOW);
 
     ui.setButtonState(0, last_up_state);
     ui.setButtonState(1, last_mode_state);
     ui.setButtonState(2, last_down_state);
 
-    const TickType_t motor_spin_period = pdMS_TO_TICKS(50);  // Spin motors every 50ms while held
-
     while (1) {
-        // Wait for button event with timeout to allow continuous motor spinning
-        if (xQueueReceive(gpio_event_queue, &gpio_num, motor_spin_period)) {
-            // Debounce delay
+        // Wait for button event
+        if (xQueueReceive(gpio_event_queue, &gpio_num, portMAX_DELAY)) {
+#if !BUTTON_SCANNER_ENABLED
+            // Debounce delay (scanner events are already debounced)
             vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_DELAY_MS));
-
-            // Read current state
-            int level = gpio_get_level((gpio_num_t)gpio_num);
+#endif
 
             // Process based on which button
             if (gpio_num == GPIO_BUTTON_UP) {
-                bool pressed = (level == !BUTTON_UP_ACTIVE_LOW);
+                bool pressed = read_button_pressed(gpio_num, BUTTON_UP_ACTIVE_LOW);
                 if (pressed != last_up_state) {
                     last_up_state = pressed;
                     ui.setButtonState(0, pressed);
                     ui.refreshButtonPanel();
-                    if (pressed) {
-                        handle_button_up_press();
-                    } else {
-                        handle_button_up_release();
-                    }
+                    dispatch_mode_event(pressed ? ModeEvent::UP_PRESS : ModeEvent::UP_RELEASE);
                 }
             } else if (gpio_num == GPIO_BUTTON_MODE) {
-                bool pressed = (level == !BUTTON_MODE_ACTIVE_LOW);
+                bool pressed = read_button_pressed(gpio_num, BUTTON_MODE_ACTIVE_LOW);
                 if (pressed != last_mode_state) {
                     last_mode_state = pressed;
                     ui.setButtonState(1, pressed);
                     ui.refreshButtonPanel();
                     if (pressed) {
-                        handle_button_mode_press();
+                        dispatch_mode_event(ModeEvent::MODE_PRESS);
                     }
                 }
             } else if (gpio_num == GPIO_BUTTON_DOWN) {
-                bool pressed = (level == !BUTTON_DOWN_ACTIVE_LOW);
+                bool pressed = read_button_pressed(gpio_num, BUTTON_DOWN_ACTIVE_LOW);
                 if (pressed != last_down_state) {
                     last_down_state = pressed;
                     ui.setButtonState(2, pressed);
                     ui.refreshButtonPanel();
-                    if (pressed) {
-                        handle_button_down_press();
-                    } else {
-                        handle_button_down_release();
-                    }
+                    dispatch_mode_event(pressed ? ModeEvent::DOWN_PRESS : ModeEvent::DOWN_RELEASE);
                 }
             }
         }
+    }
+}
 
-        // Continuously spin motors while buttons are held in UP_DOWN mode
-        OperationMode mode = ui.getMode();
-        if (mode == OperationMode::UP_DOWN) {
-            if (last_up_state) {
-                spin_motors(1);  // Spin up
-            } else if (last_down_state) {
-                spin_motors(-1);  // Spin down
-            }
+// ============================================================================
+// Accelerometer Bus Health
+// ============================================================================
+// Queue the per-cycle status reads for one sensor
+static bool request_accel_status(AccelSensor* sensor) {
+    bool ok = sensor->requestStatus();
+#if ACCEL_WAKE_ON_MOTION
+    ok = sensor->requestInterruptSource() && ok;
+#endif
+    return ok;
+}
+
+// Classify a finished stage for one sensor and apply the health policy:
+// retry with backoff (re-queueing via requeue, if the stage can be repeated),
+// recover the bus, or take the sensor offline. Call with the bus idle.
+static bool check_accel_stage(AccelSensor* sensor, int health_id, bool queued,
+                              bool (*requeue)(AccelSensor*)) {
+    int attempt = requeue ? 0 : I2cHealth::NO_RETRY;
+    while (1) {
+        I2cError error = i2c_bus.takeError(sensor->getAddress());
+        if (!queued && error == I2cError::NONE) {
+            error = I2cError::OTHER;
+        }
+
+        switch (i2c_health.record(health_id, error, attempt, esp_timer_get_time())) {
+            case I2cHealth::Action::OK:
+                return true;
+            case I2cHealth::Action::FAIL:
+                return false;
+            case I2cHealth::Action::OFFLINE:
+                ESP_LOGW(TAG, "Accelerometer 0x%02X offline after %lu failures",
+                         sensor->getAddress(),
+                         (unsigned long)i2c_health.getStats(health_id).consecutive_failures);
+                return false;
+            case I2cHealth::Action::RECOVER_BUS:
+                i2c_bus.recover();
+                if (!i2c_health.retriesLeft(attempt)) {
+                    return false;
+                }
+                break;
+            case I2cHealth::Action::RETRY:
+                break;
         }
+
+        // Back off, then repeat the stage for this sensor alone
+        TickType_t backoff = pdMS_TO_TICKS(i2c_health.retryDelay(attempt) / 1000);
+        vTaskDelay(backoff > 0 ? backoff : 1);
+        attempt++;
+        queued = requeue(sensor);
+        i2c_bus.wait();
+    }
+}
+
+// Re-initialize an offline sensor when its probe is due (keeps offsets)
+static void probe_accel(AccelSensor* sensor, int health_id) {
+    if (!i2c_health.probeDue(health_id, esp_timer_get_time())) {
+        return;
     }
+
+    const SamplingPolicy::Profile& profile = sampling.getProfile();
+    bool ok = sensor->init(profile.rate_code, profile.fifo_watermark, sensor->getOffsets(), accel_motion);
+    i2c_bus.takeError(sensor->getAddress());  // Probe failures aren't counted
+    i2c_health.probeResult(health_id, ok);
+    if (ok) {
+        ESP_LOGI(TAG, "Accelerometer 0x%02X back online (re-initialized)", sensor->getAddress());
+    }
+}
+
+static void log_accel_health(const char* name, AccelSensor* sensor, int health_id) {
+    const I2cHealth::DeviceStats& stats = i2c_health.getStats(health_id);
+    if (stats.nacks + stats.timeouts + stats.arbitration_losses + stats.other_errors == 0 && stats.online) {
+        return;
+    }
+    ESP_LOGI(TAG, "%s 0x%02X %s: ok %lu, nack %lu, timeout %lu, arbitration %lu, other %lu, "
+             "retries %lu, recoveries %lu, reinits %lu",
+             name, sensor->getAddress(), stats.online ? "online" : "OFFLINE",
+             (unsigned long)stats.successes, (unsigned long)stats.nacks, (unsigned long)stats.timeouts,
+             (unsigned long)stats.arbitration_losses, (unsigned long)stats.other_errors,
+             (unsigned long)stats.retries, (unsigned long)stats.recoveries, (unsigned long)stats.reinits);
 }
 
 // ============================================================================
 // Accelerometer Reading Task
 // ============================================================================
+// Mean of a block in g (0 if empty)
+static void accel_block_mean(const AccelBlock& block, float* x, float* y, float* z) {
+    int32_t sum_x = 0, sum_y = 0, sum_z = 0;
+    for (int i = 0; i < block.count; i++) {
+        sum_x += block.x[i];
+        sum_y += block.y[i];
+        sum_z += block.z[i];
+    }
+    float scale = block.count ? 1.0f / (block.count * adxl345::LSB_PER_G) : 0.0f;
+    *x = sum_x * scale;
+    *y = sum_y * scale;
+    *z = sum_z * scale;
+}
+
+// Turn one batch of blocks into angles and monitor state
+static void process_accel_blocks(const AccelBlock& front_block, bool front_ok,
+                                 const AccelBlock& rear_block, bool rear_ok) {
+    // Filter every sample of both sensors into pitch/roll/torsion
+#if ATTITUDE_FIXED_POINT
+    const FixedAttitudeEstimator::Attitude& fixed = attitude.update(front_block, front_ok, rear_block, rear_ok);
+    const AttitudeEstimator::Attitude att = {
+        .pitch = fixed.pitch_cdeg / 100.0f,
+        .roll = fixed.roll_cdeg / 100.0f,
+        .torsion = fixed.torsion_cdeg / 100.0f,
+        .front_valid = fixed.front_valid,
+        .rear_valid = fixed.rear_valid,
+    };
+#else
+    const AttitudeEstimator::Attitude& att = attitude.update(front_block, front_ok, rear_block, rear_ok);
+#endif
+
+    // Update sensor monitor state
+    ui.getMonitors().sensors = (front_ok && rear_ok);
+
+    if (att.front_valid || att.rear_valid) {
+        // Update UI with orientation data
+        ui.setLevelAngle(att.pitch, att.roll);
+        attitude_pitch_deg = att.pitch;
+        attitude_roll_deg = att.roll;
+        attitude_time_us = esp_timer_get_time();
+
+        // Log periodically (every 2 seconds, whatever the task period)
+        static int64_t last_log_us = 0;
+        int64_t now = esp_timer_get_time();
+        if (now - last_log_us >= 2000000) {
+            last_log_us = now;
+            float front_x = 0, front_y = 0, front_z = 0;
+            float rear_x = 0, rear_y = 0, rear_z = 0;
+            accel_block_mean(front_block, &front_x, &front_y, &front_z);
+            accel_block_mean(rear_block, &rear_x, &rear_y, &rear_z);
+            ESP_LOGI(TAG, "Pitch=%.2f° Roll=%.2f° Torsion=%.2f° (front %s, rear %s)",
+                     att.pitch, att.roll, att.torsion,
+                     att.front_valid ? "ok" : "--", att.rear_valid ? "ok" : "--");
+            ESP_LOGI(TAG, "Front: %d samples X=%.2fg Y=%.2fg Z=%.2fg, Rear: %d samples X=%.2fg Y=%.2fg Z=%.2fg",
+                     front_block.count, front_x, front_y, front_z,
+                     rear_block.count, rear_x, rear_y, rear_z);
+        }
+    }
+
+    // Update status bar if sensor state changed
+    static bool last_sensor_state = false;
+    bool current_sensor_state = ui.getMonitors().sensors;
+    if (current_sensor_state != last_sensor_state) {
+        last_sensor_state = current_sensor_state;
+        ui.refreshStatusBar();
+    }
+}
+
+// Write new offsets to both sensors and persist them (or erase the stored
+// calibration when clearing)
+static bool apply_accel_calibration(const AccelCalibration& calibration, bool persist) {
+    bool ok = acc_front->setOffsets(calibration.front);
+    ok = acc_rear->setOffsets(calibration.rear) && ok;
+    ok = i2c_bus.wait() && ok;
+
+    if (persist) {
+        ok = nvs_store_save(NVS_KEY_ACCEL_CAL, &calibration, sizeof(calibration)) && ok;
+    } else {
+        ok = nvs_store_erase(NVS_KEY_ACCEL_CAL) && ok;
+    }
+    return ok;
+}
+
+// Run pending calibration requests on freshly collected blocks.
+// Returns true if the offsets changed (buffered samples are then stale).
+static bool service_accel_calibration(const AccelBlock& front_block, bool front_ok,
+                                      const AccelBlock& rear_block, bool rear_ok) {
+    static AccelCalibrator front_cal;
+    static AccelCalibrator rear_cal;
+
+    switch (calibration_request.exchange(CalibrationRequest::NONE)) {
+        case CalibrationRequest::CAPTURE:
+            front_cal.reset(acc_front->getOffsets());
+            rear_cal.reset(acc_rear->getOffsets());
+            front_cal.beginOrientation(AccelCalibrator::LEVEL);
+            rear_cal.beginOrientation(AccelCalibrator::LEVEL);
+            calibration_capturing = true;
+            return false;
+        case CalibrationRequest::CLEAR: {
+            calibration_capturing = false;
+            bool ok = apply_accel_calibration(AccelCalibration{}, false);
+            ESP_LOGI(TAG, "Calibration cleared%s", ok ? "" : " (write failed)");
+            return true;
+        }
+        case CalibrationRequest::NONE:
+            break;
+    }
+
+    if (!calibration_capturing) {
+        return false;
+    }
+
+    if (front_ok) {
+        front_cal.addBlock(front_block);
+    }
+    if (rear_ok) {
+        rear_cal.addBlock(rear_block);
+    }
+    if (front_cal.getSampleCount() < ACCEL_CALIBRATION_SAMPLES ||
+        rear_cal.getSampleCount() < ACCEL_CALIBRATION_SAMPLES) {
+        return false;
+    }
+
+    calibration_capturing = false;
+    AccelCalibration calibration = {};
+    front_cal.compute(&calibration.front);
+    rear_cal.compute(&calibration.rear);
+    bool ok = apply_accel_calibration(calibration, true);
+    ESP_LOGI(TAG, "Calibrated%s: front (%d, %d, %d), rear (%d, %d, %d)", ok ? "" : " (write failed)",
+             calibration.front.x, calibration.front.y, calibration.front.z,
+             calibration.rear.x, calibration.rear.y, calibration.rear.z);
+    return true;
+}
+
+// ============================================================================
+// Adaptive Sampling
+// ============================================================================
+// RMS deviation of a block around its mean over all axes (mg, -1 if too short)
+static float accel_block_rms_mg(const AccelBlock& block) {
+    if (block.count < 2) {
+        return -1.0f;
+    }
+    float mean_x = 0, mean_y = 0, mean_z = 0;
+    accel_block_mean(block, &mean_x, &mean_y, &mean_z);
+    float sum = 0;
+    for (int i = 0; i < block.count; i++) {
+        float dx = block.x[i] / adxl345::LSB_PER_G - mean_x;
+        float dy = block.y[i] / adxl345::LSB_PER_G - mean_y;
+        float dz = block.z[i] / adxl345::LSB_PER_G - mean_z;
+        sum += dx * dx + dy * dy + dz * dz;
+    }
+    return sqrtf(sum / block.count) * 1000.0f;
+}
+
+#if ACCEL_ADAPTIVE_SAMPLING
+// Queue the current level's rate / watermark / power state for one sensor
+static bool request_sampling_profile(AccelSensor* sensor) {
+    const SamplingPolicy::Profile& profile = sampling.getProfile();
+    bool measure = sampling.getLevel() != SamplingPolicy::Level::STANDBY;
+    return sensor->setSampling(profile.rate_code, profile.fifo_watermark, measure);
+}
+#endif
+
+// Re-evaluate the sampling level and reprogram sensors and decimators when
+// it changes (the task period follows getProfile())
+static void service_sampling_policy(float rms_mg, int64_t now) {
+    sampled_mode = ui.getMode();
+#if ACCEL_ADAPTIVE_SAMPLING
+    SamplingPolicy::Level previous = sampling.getLevel();
+    SamplingPolicy::Inputs inputs = {
+        .mode = sampled_mode,
+        .motors_active = motors_running.load(),
+        .calibrating = calibration_capturing || calibration_request.load() != CalibrationRequest::NONE,
+        .rms_mg = rms_mg,
+    };
+    if (!sampling.update(inputs, now)) {
+        return;
+    }
+
+    const SamplingPolicy::Profile& profile = sampling.getProfile();
+    ESP_LOGI(TAG, "Sampling %s -> %s (%s): %.1f Hz every %u ms",
+             SamplingPolicy::levelName(previous), SamplingPolicy::levelName(sampling.getLevel()),
+             sampling.getReason(), sampling.getLevel() == SamplingPolicy::Level::STANDBY ? 0.0f :
+             adxl345::rate_hz(profile.rate_code), profile.period_ms);
+
+    bool front_online = i2c_health.isOnline(front_health);
+    bool rear_online = i2c_health.isOnline(rear_health);
+    bool front_queued = front_online && request_sampling_profile(acc_front.get());
+    bool rear_queued = rear_online && request_sampling_profile(acc_rear.get());
+    i2c_bus.wait();
+    if (front_online) {
+        check_accel_stage(acc_front.get(), front_health, front_queued, request_sampling_profile);
+    }
+    if (rear_online) {
+        check_accel_stage(acc_rear.get(), rear_health, rear_queued, request_sampling_profile);
+    }
+
+    // Staged inputs belong to the old rate
+    const Decimator::Config decimator_config = {
+        .factor = profile.decimation,
+        .taps = ACCEL_DECIMATOR_TAPS,
+        .cutoff = ACCEL_DECIMATOR_CUTOFF,
+    };
+    front_decimator.init(decimator_config);
+    rear_decimator.init(decimator_config);
+#endif
+}
+
+// Residency, average sensor current and I2C traffic since boot
+static void log_sampling_stats(int64_t now, uint64_t i2c_transfers) {
+    const SamplingPolicy::Stats& stats = sampling.getStats(now);
+    int64_t total_us = 0;
+    for (int i = 0; i < (int)SamplingPolicy::Level::LEVEL_COUNT; i++) {
+        total_us += stats.residency_us[i];
+    }
+    if (total_us == 0) {
+        return;
+    }
+    auto percent = [&](SamplingPolicy::Level level) {
+        return stats.residency_us[(int)level] * 100.0f / total_us;
+    };
+    ESP_LOGI(TAG, "Sampling %s: full %.0f%%, reduced %.0f%%, low %.0f%%, standby %.0f%%, %lu transitions; "
+             "sensors %.0f uA avg each, I2C %.0f transfers/h",
+             SamplingPolicy::levelName(sampling.getLevel()),
+             percent(SamplingPolicy::Level::FULL), percent(SamplingPolicy::Level::REDUCED),
+             percent(SamplingPolicy::Level::LOW), percent(SamplingPolicy::Level::STANDBY),
+             (unsigned long)stats.transitions, sampling.getAverageCurrentUa(now),
+             i2c_transfers * 3.6e9f / total_us);
+}
+
+#if ACCEL_WAKE_ON_MOTION
+// Track a sensor's still state from its INT_SOURCE bits
+static void update_still_flag(uint8_t int_source, bool* still) {
+    if (int_source & adxl345::INT_ACTIVITY) {
+        *still = false;
+    } else if (int_source & adxl345::INT_INACTIVITY) {
+        *still = true;
+    }
+}
+#endif
+
 void accelerometer_task(void *pvParameter) {
     ESP_LOGI(TAG, "Accelerometer task started");
 
-    float front_x, front_y, front_z;
-    float rear_x, rear_y, rear_z;
+    if (!acc_front || !acc_rear) {
+        ESP_LOGE(TAG, "Accelerometers not initialized");
+        vTaskDelete(NULL);
+    }
+
+    // Raw blocks from the FIFOs, decimated into the double-buffered pair
+    static AccelBlock front_raw;
+    static AccelBlock rear_raw;
+
+    // Double-buffered blocks: the bus fills one pair while the previous
+    // pair is processed
+    static AccelBlock front_blocks[2];
+    static AccelBlock rear_blocks[2];
+    bool front_ok[2] = {false, false};
+    bool rear_ok[2] = {false, false};
+    int current = 0;
+    bool have_previous = false;
+
+    int64_t stats_start = esp_timer_get_time();
+    uint64_t i2c_transfers = 0;
+    uint32_t decimator_cycles = 0;
+    int front_empty_cycles = 0;
+    int rear_empty_cycles = 0;
+#if ACCEL_WAKE_ON_MOTION
+    int64_t idle_us = 0;
+    bool front_still = false;
+    bool rear_still = false;
+#endif
+    TickType_t last_wake = xTaskGetTickCount();
 
     while (1) {
-        // Read both accelerometers
-        bool front_ok = false;
-        bool rear_ok = false;
-
-        if (acc_front) {
-            std::error_code ec;
-            auto front_data = acc_front->read(ec);
-            if (!ec) {
-                front_x = front_data.x;
-                front_y = front_data.y;
-                front_z = front_data.z;
-                front_ok = true;
-            }
+        int64_t now = esp_timer_get_time();
+        int previous = current ^ 1;
+
+        // Standby: nothing to read until the policy wakes the sensors
+        if (sampling.getLevel() == SamplingPolicy::Level::STANDBY) {
+            service_sampling_policy(-1.0f, now);
+            have_previous = false;
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(sampling.getProfile().period_ms));
+            continue;
         }
 
-        if (acc_rear) {
-            std::error_code ec;
-            auto rear_data = acc_rear->read(ec);
-            if (!ec) {
-                rear_x = rear_data.x;
-                rear_y = rear_data.y;
-                rear_z = rear_data.z;
-                rear_ok = true;
-            }
+        // Bring back sensors that dropped off the bus
+        probe_accel(acc_front.get(), front_health);
+        probe_accel(acc_rear.get(), rear_health);
+        bool front_online = i2c_health.isOnline(front_health);
+        bool rear_online = i2c_health.isOnline(rear_health);
+
+        // Queue both FIFO_STATUS reads together (plus INT_SOURCE, which
+        // also re-arms the activity interrupt)
+        bool front_queued = front_online && request_accel_status(acc_front.get());
+        bool rear_queued = rear_online && request_accel_status(acc_rear.get());
+        i2c_bus.wait();
+        bool front_status_ok = front_online &&
+                               check_accel_stage(acc_front.get(), front_health, front_queued, request_accel_status);
+        bool rear_status_ok = rear_online &&
+                              check_accel_stage(acc_rear.get(), rear_health, rear_queued, request_accel_status);
+
+        // Queue every FIFO entry of both sensors
+        front_queued = front_status_ok && acc_front->requestEntries();
+        rear_queued = rear_status_ok && acc_rear->requestEntries();
+
+        // Filter the previous batch while the transfers run
+        if (have_previous) {
+            process_accel_blocks(front_blocks[previous], front_ok[previous],
+                                 rear_blocks[previous], rear_ok[previous]);
         }
 
-        // Update sensor monitor state
-        ui.getMonitors().sensors = (front_ok && rear_ok);
+        // Entries are popped as they are read, so a failed drain isn't
+        // repeated (the FIFO keeps the rest for the next cycle)
+        i2c_bus.wait();
+        bool front_read_ok = front_status_ok && check_accel_stage(acc_front.get(), front_health, front_queued, NULL);
+        bool rear_read_ok = rear_status_ok && check_accel_stage(acc_rear.get(), rear_health, rear_queued, NULL);
+        acc_front->collect(&front_raw, now);
+        acc_rear->collect(&rear_raw, now);
+        if (!front_read_ok) {
+            front_raw.count = 0;
+        }
+        if (!rear_read_ok) {
+            rear_raw.count = 0;
+        }
 
-        // Calculate pitch and roll from accelerometer data
-        // Using rear accelerometer for now (TODO: combine both sensors)
-        if (rear_ok) {
-            // Calculate pitch (rotation around X-axis): atan2(y, z)
-            float pitch = atan2f(rear_y, rear_z) * 180.0f / M_PI;
+        // A sensor that browned out answers but has stopped measuring
+        front_empty_cycles = front_read_ok && front_raw.count == 0 ? front_empty_cycles + 1 : 0;
+        rear_empty_cycles = rear_read_ok && rear_raw.count == 0 ? rear_empty_cycles + 1 : 0;
+        if (front_empty_cycles >= ACCEL_STALL_CYCLES) {
+            ESP_LOGW(TAG, "Front accelerometer stopped producing data, re-initializing");
+            i2c_health.setOffline(front_health, 0);
+            front_empty_cycles = 0;
+        }
+        if (rear_empty_cycles >= ACCEL_STALL_CYCLES) {
+            ESP_LOGW(TAG, "Rear accelerometer stopped producing data, re-initializing");
+            i2c_health.setOffline(rear_health, 0);
+            rear_empty_cycles = 0;
+        }
 
-            // Calculate roll (rotation around Y-axis): atan2(x, z)
-            float roll = atan2f(rear_x, rear_z) * 180.0f / M_PI;
+        // Low-pass and decimate to the control rate
+        uint32_t start = esp_cpu_get_cycle_count();
+        front_decimator.process(front_raw, &front_blocks[current]);
+        rear_decimator.process(rear_raw, &rear_blocks[current]);
+        decimator_cycles += esp_cpu_get_cycle_count() - start;
+
+        front_ok[current] = front_read_ok && front_blocks[current].count > 0;
+        rear_ok[current] = rear_read_ok && rear_blocks[current].count > 0;
+
+        // Vibration for the sampling policy (the busier sensor)
+        float front_rms = front_ok[current] ? accel_block_rms_mg(front_blocks[current]) : -1.0f;
+        float rear_rms = rear_ok[current] ? accel_block_rms_mg(rear_blocks[current]) : -1.0f;
+        float rms_mg = front_rms > rear_rms ? front_rms : rear_rms;
+
+        // New offsets invalidate everything sampled under the old ones
+        if (service_accel_calibration(front_blocks[current], front_ok[current],
+                                      rear_blocks[current], rear_ok[current])) {
+            front_decimator.reset();
+            rear_decimator.reset();
+            attitude.reset();
+            have_previous = false;
+        } else {
+            have_previous = true;
+            current = previous;
+        }
 
-            // Update UI with orientation data
-            ui.setLevelAngle(pitch, roll);
+        // Follow mode, motors and vibration with the data rate
+        service_sampling_policy(rms_mg, now);
 
-            // Log periodically (every 2 seconds)
-            static int log_counter = 0;
-            if (++log_counter >= 20) {  // 20 * 100ms = 2s
-                log_counter = 0;
-                ESP_LOGI(TAG, "Rear: X=%.2fg Y=%.2fg Z=%.2fg, Pitch=%.1f° Roll=%.1f°",
-                         rear_x, rear_y, rear_z, pitch, roll);
-                if (front_ok) {
-                    ESP_LOGI(TAG, "Front: X=%.2fg Y=%.2fg Z=%.2fg",
-                             front_x, front_y, front_z);
-                }
-            }
+#if ACCEL_WAKE_ON_MOTION
+        // Inactivity/activity latch separately per sensor; stop polling
+        // once both are still until activity (or a request) wakes the task
+        if (front_status_ok) {
+            update_still_flag(acc_front->getInterruptSource(), &front_still);
+        }
+        if (rear_status_ok) {
+            update_still_flag(acc_rear->getInterruptSource(), &rear_still);
         }
+        // Slow moves (leveling) may not trip the activity threshold, so
+        // never pause while the motors run
+        if (front_still && rear_still && calibration_request.load() == CalibrationRequest::NONE &&
+            !motors_running.load()) {
+            ESP_LOGI(TAG, "Frame still, accelerometer polling paused");
+            int64_t idle_start = esp_timer_get_time();
+
+            // Drop edges the INT_SOURCE read already handled, then re-check
+            // every wake reason: a request, motor start or mode change posted
+            // before the drain lost its give, and activity may have latched
+            // with no new edge to come. Anything posted after the drain
+            // leaves the semaphore given.
+            xSemaphoreTake(accel_wake_semaphore, 0);
+            if (!accel_motion_pending() && calibration_request.load() == CalibrationRequest::NONE &&
+                !motors_running.load() && ui.getMode() == sampled_mode) {
+                xSemaphoreTake(accel_wake_semaphore, portMAX_DELAY);
+            }
 
-        // Update status bar if sensor state changed
-        static bool last_sensor_state = false;
-        bool current_sensor_state = ui.getMonitors().sensors;
-        if (current_sensor_state != last_sensor_state) {
-            last_sensor_state = current_sensor_state;
-            ui.refreshStatusBar();
+            int64_t idle_time = esp_timer_get_time() - idle_start;
+            idle_us += idle_time;
+            ESP_LOGI(TAG, "Accelerometer polling resumed after %lld ms idle", idle_time / 1000);
+
+            // FIFO overflowed while idle: restart filters on fresh samples
+            front_decimator.reset();
+            rear_decimator.reset();
+            have_previous = false;
+            front_still = false;
+            rear_still = false;
+            last_wake = xTaskGetTickCount();
+            continue;
+        }
+#endif
+
+        // Report bus utilization and per-transfer latency
+        if (now - stats_start >= 10000000) {
+            I2cBus::Stats stats = i2c_bus.takeStats();
+            int64_t window_us = now - stats_start;
+            i2c_transfers += stats.transfers;
+            ESP_LOGI(TAG, "I2C: %lu transfers, %lu errors, utilization %.1f%%, latency avg %lld us max %lld us",
+                     (unsigned long)stats.transfers, (unsigned long)stats.errors,
+                     stats.busy_us * 100.0f / window_us,
+                     stats.transfers ? stats.latency_total_us / stats.transfers : 0,
+                     stats.latency_max_us);
+            log_accel_health("Front", acc_front.get(), front_health);
+            log_accel_health("Rear", acc_rear.get(), rear_health);
+            log_sampling_stats(now, i2c_transfers);
+#if ACCEL_WAKE_ON_MOTION
+            ESP_LOGI(TAG, "Accelerometer task idle %.1f%% of the window", idle_us * 100.0f / window_us);
+            idle_us = 0;
+#endif
+
+            // Filter cost normalized to one second of sensor data (both sensors)
+            uint32_t samples = front_decimator.takeInputCount();
+            rear_decimator.takeInputCount();
+            if (ACCEL_DECIMATION > 1 && samples > 0) {
+                // Only FULL decimates
+                float cycles_per_second = (float)decimator_cycles * adxl345::rate_hz(ACCEL_RATE_CODE) / samples;
+                ESP_LOGI(TAG, "Decimator: %.0f cycles per second of data (%.2f%% CPU)",
+                         cycles_per_second, cycles_per_second * 100.0f / (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1e6f));
+            }
+            decimator_cycles = 0;
+            stats_start = now;
         }
 
-        // Read at 10 Hz (every 100ms)
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Wake once per FIFO period of the current level
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(sampling.getProfile().period_ms));
     }
 }
 
@@ -672,6 +2054,19 @@ void inactivity_monitor_task(void *pvParameter) {
             UBaseType_t stack_hwm = uxTaskGetStackHighWaterMark(NULL);
             ESP_LOGI(TAG, "Idle: %lld s, Dimmed: %s, Stack HWM: %u bytes",
                      idle_time_sec, is_dimmed ? "YES" : "NO", stack_hwm);
+            if (dev_flag) {
+                log_button_input_stats();
+            }
+        }
+
+        // Dev mode shows the CAN bus load in the status bar
+        static CanTelemetry::Report report;
+        if (dev_flag && can_telemetry.read(&report)) {
+            int load = (int)(report.load_pct + 0.5f);
+            if (load != ui.getMonitors().bus_load_pct) {
+                ui.getMonitors().bus_load_pct = load;
+                ui.refreshStatusBar();
+            }
         }
 
         // Auto-dim after dim timeout (with fade)
@@ -735,10 +2130,18 @@ extern "C" void app_main(void) {
     esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
     if (wakeup_reason == ESP_SLEEP_WAKEUP_GPIO) {
         ESP_LOGI(TAG, "Woke up from deep sleep via GPIO");
+    } else if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT1) {
+        uint64_t wake_pins = esp_sleep_get_ext1_wakeup_status();
+        bool motion = wake_pins & ((1ULL << GPIO_ACC_FRONT_INT1) | (1ULL << GPIO_ACC_REAR_INT1));
+        ESP_LOGI(TAG, "Woke up from deep sleep via %s", motion ? "motion" : "button");
     } else {
         ESP_LOGI(TAG, "Cold boot or reset");
     }
 
+    // Release pins held through sleep (sensor power, front address strap)
+    rtc_gpio_hold_dis((gpio_num_t)TFT_I2C_POWER);
+    rtc_gpio_hold_dis((gpio_num_t)GPIO_ACC_FRONT_SDO);
+
     // Check for dev mode activation (D1 and D2 held on boot)
     // Configure pins temporarily to read state
     gpio_set_direction((gpio_num_t)GPIO_BUTTON_MODE, GPIO_MODE_INPUT);
@@ -774,12 +2177,24 @@ extern "C" void app_main(void) {
     // Initialize GPIO pins (power switches and accelerometer address)
     init_gpio_pins();
 
+    // Settings storage (calibration is restored during sensor init)
+    nvs_store_init();
+
     // Initialize accelerometers (I2C and sensors)
     init_accelerometers();
 
     // Initial refresh (will show motor/lock/sensor monitor states)
     ui.refresh();
 
+    // Initialize actuator sequencing (before buttons can post commands)
+    init_actuators();
+    xTaskCreate(actuator_task, "actuator", 4096, NULL, 6, &actuator_task_handle);
+
+    // Install CAN and start the motor command cycle
+    init_motors();
+    xTaskCreate(can_rx_task, "can_rx", 4096, NULL, 7, NULL);
+    xTaskCreate(motor_task, "motor", 4096, NULL, 6, NULL);
+
     // Initialize GPIO buttons
     init_gpio_buttons();
 
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include "config.hpp"
+
+// ============================================================================
+// Mode State Machine - constexpr (mode, event) -> (action, next mode) table
+// ============================================================================
+// All mode behaviour lives in MODE_ACTIONS below; the mode cycles (with and
+// without dev modes) are derived from MODE_CONFIGS at compile time. Dispatch
+// is a single table lookup, and the static_asserts at the bottom check table
+// coverage whenever this header is compiled. host/mode_runner pins every row
+// and both cycle orders.
+
+enum class ModeEvent {
+    UP_PRESS = 0,
+    UP_RELEASE,
+    MODE_PRESS,
+    DOWN_PRESS,
+    DOWN_RELEASE,
+    EVENT_COUNT     // Must be last
+};
+
+enum class ModeAction {
+    NONE = 0,
+    MOVE_UP,           // Up/Down: unlock and raise
+    MOVE_DOWN,         // Up/Down: unlock and lower
+    MOVE_STOP,         // Up/Down: stop and lock
+    ADJUST_INCREASE,   // Roll/Pitch/Torsion: increase
+    ADJUST_DECREASE,   // Roll/Pitch/Torsion: decrease
+    LEVEL_START,       // Level: start closed-loop leveling (or cancel it)
+    CALIBRATE_HOLD,    // Level: Down pressed, timing the hold
+    CALIBRATE,         // Level: capture the pose as level, or clear after a long hold
+    MOTOR_FORWARD,     // Motor N: unlock and run forward (MOVE_STOP on release)
+    MOTOR_REVERSE,     // Motor N: unlock and run reverse
+    CYCLE_MODE,        // Switch to the next available mode
+    ACTION_COUNT       // Must be last
+};
+
+struct ModeTransition {
+    ModeAction action;
+    OperationMode next;
+};
+
+constexpr int MODE_COUNT = (int)OperationMode::MODE_COUNT;
+constexpr int MODE_EVENT_COUNT = (int)ModeEvent::EVENT_COUNT;
+
+// Actions indexed by [OperationMode][ModeEvent]
+constexpr ModeAction MODE_ACTIONS[MODE_COUNT][MODE_EVENT_COUNT] = {
+    //              UP_PRESS                     UP_RELEASE             MODE_PRESS              DOWN_PRESS                   DOWN_RELEASE
+    /* UP_DOWN */ { ModeAction::MOVE_UP,         ModeAction::MOVE_STOP, ModeAction::CYCLE_MODE, ModeAction::MOVE_DOWN,       ModeAction::MOVE_STOP },
+    /* ROLL    */ { ModeAction::ADJUST_INCREASE, ModeAction::NONE,      ModeAction::CYCLE_MODE, ModeAction::ADJUST_DECREASE, ModeAction::NONE },
+    /* PITCH   */ { ModeAction::ADJUST_INCREASE, ModeAction::NONE,      ModeAction::CYCLE_MODE, ModeAction::ADJUST_DECREASE, ModeAction::NONE },
+    /* TORSION */ { ModeAction::ADJUST_INCREASE, ModeAction::NONE,      ModeAction::CYCLE_MODE, ModeAction::ADJUST_DECREASE, ModeAction::NONE },
+    /* LEVEL   */ { ModeAction::LEVEL_START,     ModeAction::NONE,      ModeAction::CYCLE_MODE, ModeAction::CALIBRATE_HOLD,  ModeAction::CALIBRATE },
+    /* MOTOR_1 */ { ModeAction::MOTOR_FORWARD,   ModeAction::MOVE_STOP, ModeAction::CYCLE_MODE, ModeAction::MOTOR_REVERSE,   ModeAction::MOVE_STOP },
+    /* MOTOR_2 */ { ModeAction::MOTOR_FORWARD,   ModeAction::MOVE_STOP, ModeAction::CYCLE_MODE, ModeAction::MOTOR_REVERSE,   ModeAction::MOVE_STOP },
+    /* MOTOR_3 */ { ModeAction::MOTOR_FORWARD,   ModeAction::MOVE_STOP, ModeAction::CYCLE_MODE, ModeAction::MOTOR_REVERSE,   ModeAction::MOVE_STOP },
+    /* MOTOR_4 */ { ModeAction::MOTOR_FORWARD,   ModeAction::MOVE_STOP, ModeAction::CYCLE_MODE, ModeAction::MOTOR_REVERSE,   ModeAction::MOVE_STOP },
+};
+
+// Next mode after MODE_PRESS, skipping dev_only modes unless dev_flag is set
+constexpr std::array<OperationMode, MODE_COUNT> build_mode_cycle(bool dev_flag) {
+    std::array<OperationMode, MODE_COUNT> next = {};
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        int candidate = mode;
+        do {
+            candidate = (candidate + 1) % MODE_COUNT;
+        } while (candidate != mode && MODE_CONFIGS[candidate].dev_only && !dev_flag);
+        next[mode] = (OperationMode)candidate;
+    }
+    return next;
+}
+
+using ModeTransitionTable = std::array<std::array<ModeTransition, MODE_EVENT_COUNT>, MODE_COUNT>;
+
+constexpr ModeTransitionTable build_transitions(bool dev_flag) {
+    const auto cycle = build_mode_cycle(dev_flag);
+    ModeTransitionTable table = {};
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        for (int event = 0; event < MODE_EVENT_COUNT; event++) {
+            ModeAction action = MODE_ACTIONS[mode][event];
+            table[mode][event] = {
+                action,
+                action == ModeAction::CYCLE_MODE ? cycle[mode] : (OperationMode)mode
+            };
+        }
+    }
+    return table;
+}
+
+// Precomputed tables indexed by [dev_flag][OperationMode][ModeEvent]
+constexpr ModeTransitionTable MODE_TRANSITIONS[2] = {
+    build_transitions(false),
+    build_transitions(true),
+};
+
+inline const ModeTransition& mode_transition(bool dev_flag, OperationMode mode, ModeEvent event) {
+    return MODE_TRANSITIONS[dev_flag][(int)mode][(int)event];
+}
+
+// ============================================================================
+// Compile-time coverage checks
+// ============================================================================
+
+// Every mode must be able to leave via MODE_PRESS
+constexpr bool every_mode_can_cycle() {
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        if (MODE_ACTIONS[mode][(int)ModeEvent::MODE_PRESS] != ModeAction::CYCLE_MODE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Starting from UP_DOWN, MODE_PRESS visits every available mode exactly once
+constexpr bool cycle_visits_available_modes(bool dev_flag) {
+    const auto& table = MODE_TRANSITIONS[dev_flag];
+    int available = 0;
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        if (!MODE_CONFIGS[mode].dev_only || dev_flag) {
+            available++;
+        }
+    }
+
+    bool visited[MODE_COUNT] = {};
+    int mode = (int)OperationMode::UP_DOWN;
+    for (int step = 0; step < available; step++) {
+        if (visited[mode] || (MODE_CONFIGS[mode].dev_only && !dev_flag)) {
+            return false;
+        }
+        visited[mode] = true;
+        mode = (int)table[mode][(int)ModeEvent::MODE_PRESS].next;
+    }
+    return mode == (int)OperationMode::UP_DOWN;
+}
+
+// Only MODE_PRESS may change mode
+constexpr bool only_mode_press_changes_mode(bool dev_flag) {
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        for (int event = 0; event < MODE_EVENT_COUNT; event++) {
+            if (event != (int)ModeEvent::MODE_PRESS &&
+                MODE_TRANSITIONS[dev_flag][mode][event].next != (OperationMode)mode) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(every_mode_can_cycle(), "MODE_PRESS must cycle in every mode");
+static_assert(cycle_visits_available_modes(false), "Normal mode cycle must cover all non-dev modes");
+static_assert(cycle_visits_available_modes(true), "Dev mode cycle must cover all modes");
+static_assert(only_mode_press_changes_mode(false) && only_mode_press_changes_mode(true),
+              "Only MODE_PRESS may change the operating mode");
@@ -0,0 +1,139 @@
+#include "motor_controller.hpp"
+
+using cybergear::RunMode;
+
+MotorController::MotorController(const Config& config_param)
+    : config(config_param), targets(), motors(), batch(), stats() {
+    if (config.motor_count > MAX_MOTORS) {
+        config.motor_count = MAX_MOTORS;
+    }
+    for (int i = 0; i < MAX_MOTORS; i++) {
+        targets[i] = 0.0f;
+        motors[i].phase = Phase::DISABLED;
+    }
+}
+
+void MotorController::setVelocity(int motor, float rad_s) {
+    if (motor >= 0 && motor < config.motor_count) {
+        targets[motor] = rad_s;
+    }
+}
+
+void MotorController::stopAll() {
+    for (int i = 0; i < config.motor_count; i++) {
+        targets[i] = 0.0f;
+    }
+}
+
+int MotorController::cycle() {
+    int count = 0;
+    uint8_t master = config.master_id;
+
+    for (int i = 0; i < config.motor_count; i++) {
+        Motor& motor = motors[i];
+        uint8_t id = config.motor_ids[i];
+        float target = targets[i].load() * config.directions[i];
+        motor.start_index = -1;
+
+        switch (motor.phase) {
+            case Phase::DISABLED:
+                if (target == 0.0f) {
+                    break;
+                }
+                // Speed mode can only be selected while disabled
+                motor.start_index = count;
+                cybergear::encode_stop(&batch[count++], master, id, true);
+                cybergear::encode_write_u8(&batch[count++], master, id, cybergear::PARAM_RUN_MODE,
+                                           (uint8_t)RunMode::SPEED);
+                cybergear::encode_write_float(&batch[count++], master, id, cybergear::PARAM_LIMIT_CUR,
+                                              config.current_limit_a);
+                cybergear::encode_enable(&batch[count++], master, id);
+                cybergear::encode_write_float(&batch[count++], master, id, cybergear::PARAM_SPD_REF, target);
+                motor.phase = Phase::RUNNING;
+                break;
+
+            case Phase::RUNNING:
+            case Phase::STOPPING:
+                if (target != 0.0f) {
+                    motor.phase = Phase::RUNNING;
+                } else if (motor.phase == Phase::RUNNING) {
+                    motor.phase = Phase::STOPPING;
+                    motor.zero_cycles = 0;
+                }
+
+                // Decelerate under the speed loop, then let go
+                if (motor.phase == Phase::STOPPING && ++motor.zero_cycles > config.stop_cycles) {
+                    cybergear::encode_stop(&batch[count++], master, id, false);
+                    motor.phase = Phase::DISABLED;
+                } else {
+                    cybergear::encode_write_float(&batch[count++], master, id, cybergear::PARAM_SPD_REF, target);
+                }
+                break;
+        }
+    }
+
+    int sent = count ? config.transmit(batch, count) : 0;
+    if (sent < 0) {
+        sent = 0;
+    }
+
+    // A start sequence cut short leaves the motor disabled; redo it next cycle
+    for (int i = 0; i < config.motor_count; i++) {
+        if (motors[i].start_index >= 0 && motors[i].start_index + START_FRAMES > sent) {
+            motors[i].phase = Phase::DISABLED;
+        }
+    }
+
+    stats.cycles++;
+    stats.frames_sent += sent;
+    stats.frames_dropped += count - sent;
+    return sent;
+}
+
+int MotorController::disableAll() {
+    for (int i = 0; i < config.motor_count; i++) {
+        targets[i] = 0.0f;
+        cybergear::encode_stop(&batch[i], config.master_id, config.motor_ids[i], false);
+        motors[i].phase = Phase::DISABLED;
+    }
+    int sent = config.transmit(batch, config.motor_count);
+    return sent > 0 ? sent : 0;
+}
+
+int MotorController::findMotor(uint8_t can_id) const {
+    for (int i = 0; i < config.motor_count; i++) {
+        if (config.motor_ids[i] == can_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool MotorController::decode(const CanFrame& frame, int64_t now_us, int* motor, MotorState* state) const {
+    cybergear::Feedback feedback;
+    if (!cybergear::decode_feedback(frame, &feedback)) {
+        return false;
+    }
+    int index = findMotor(feedback.motor_id);
+    if (index < 0) {
+        return false;
+    }
+
+    // Report in the frame's convention (positive = up for every motor)
+    float direction = config.directions[index];
+    *motor = index;
+    state->position = feedback.position * direction;
+    state->velocity = feedback.velocity * direction;
+    state->torque = feedback.torque * direction;
+    state->temperature = feedback.temperature;
+    state->faults = feedback.faults;
+    state->mode = feedback.state;
+    state->timestamp_us = now_us;
+    return true;
+}
+
+MotorController::Stats MotorController::takeStats() {
+    Stats snapshot = stats;
+    stats = {};
+    return snapshot;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "can_frame.hpp"
+#include "cybergear.hpp"
+#include "motor_state_cache.hpp"
+
+// ============================================================================
+// MotorController - CyberGear motors in speed mode on one CAN bus
+// ============================================================================
+// Callers set target speeds from any task; the owning task calls cycle() at
+// a fixed rate, which turns the targets into one batch of frames for all
+// motors (start sequence, speed reference, stop) and hands it to transmit.
+// Every command is answered by a FEEDBACK frame; decode() maps one to its
+// motor in the frame's sign convention without touching controller state,
+// so a separate receive task can feed a MotorStateCache. The bus is reached
+// only through transmit, so the controller runs unchanged against a fake
+// bus on host.
+class MotorController {
+public:
+    static constexpr int MAX_MOTORS = 4;
+    static constexpr int START_FRAMES = 5;   // stop/clear, run_mode, limit_cur, enable, spd_ref
+    static constexpr int MAX_BATCH = MAX_MOTORS * START_FRAMES;
+
+    // Queue frames for transmission; returns how many were accepted
+    typedef std::function<int(const CanFrame* frames, int count)> transmit_fn;
+
+    struct Config {
+        uint8_t master_id;
+        int motor_count;
+        uint8_t motor_ids[MAX_MOTORS];
+        int8_t directions[MAX_MOTORS];   // +1 / -1 per motor (mirrored mounting)
+        float current_limit_a;           // limit_cur in speed mode
+        int stop_cycles;                 // Cycles at zero speed before disabling
+        transmit_fn transmit;
+    };
+
+    enum class Phase : uint8_t {
+        DISABLED,   // Motor off (freewheeling)
+        RUNNING,    // Speed reference sent every cycle
+        STOPPING,   // Holding zero speed before disabling
+    };
+
+    struct Stats {
+        uint32_t cycles;
+        uint32_t frames_sent;
+        uint32_t frames_dropped;         // Refused by transmit (queue full)
+    };
+
+    explicit MotorController(const Config& config);
+
+    // Target speed in rad/s (0 = stop, then disable). Safe from any task.
+    void setVelocity(int motor, float rad_s);
+    void stopAll();
+
+    // Build and send this cycle's batch; returns frames accepted
+    int cycle();
+
+    // Disable every motor now, outside the cycle (shutdown). Same task as
+    // cycle(): both build in the one batch
+    int disableAll();
+
+    // Decode a FEEDBACK frame from one of our motors into its index and
+    // state (direction applied); false for any other frame. Thread-safe.
+    bool decode(const CanFrame& frame, int64_t now_us, int* motor, MotorState* state) const;
+
+    int getMotorCount() const { return config.motor_count; }
+    int findMotor(uint8_t can_id) const;
+    Phase getPhase(int motor) const { return motors[motor].phase; }
+
+    // Snapshot and reset statistics
+    Stats takeStats();
+
+private:
+    struct Motor {
+        Phase phase;
+        int zero_cycles;
+        int start_index;   // First frame of a start sequence in the batch (-1 if none)
+    };
+
+    Config config;
+    std::atomic<float> targets[MAX_MOTORS];
+    Motor motors[MAX_MOTORS];
+    CanFrame batch[MAX_BATCH];
+    Stats stats;
+};
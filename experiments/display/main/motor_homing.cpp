@@ -0,0 +1,134 @@
+#include "motor_homing.hpp"
+#include <cmath>
+
+MotorHoming::MotorHoming(const Config& config_param)
+    : config(config_param), state(State::IDLE), referenced(false), positions(), motors(), output(), metrics(),
+      start_us(0), last_us(0) {
+    if (config.motor_count > MAX_MOTORS) {
+        config.motor_count = MAX_MOTORS;
+    }
+    for (Motor& motor : motors) {
+        motor.last_sample_us = -1;
+    }
+}
+
+const char* MotorHoming::stateName(State state) {
+    switch (state) {
+        case State::IDLE:
+            return "idle";
+        case State::HOMING:
+            return "homing";
+        case State::HOMED:
+            return "homed";
+        case State::TIMED_OUT:
+            return "timed out";
+        case State::NO_FEEDBACK:
+            return "no feedback";
+        case State::CANCELLED:
+            return "cancelled";
+    }
+    return "?";
+}
+
+void MotorHoming::track(int motor_index, const MotorState& sample) {
+    Motor& motor = motors[motor_index];
+    if (sample.timestamp_us == motor.last_sample_us) {
+        return;
+    }
+    if (motor.last_sample_us >= 0) {
+        // Shortest way round the field's 8 pi span
+        float step = sample.position - motor.last_raw;
+        if (step > cybergear::POSITION_MAX) {
+            step -= 2.0f * cybergear::POSITION_MAX;
+        } else if (step < -cybergear::POSITION_MAX) {
+            step += 2.0f * cybergear::POSITION_MAX;
+        }
+        positions[motor_index] += step;
+    }
+    motor.last_sample_us = sample.timestamp_us;
+    motor.last_raw = sample.position;
+}
+
+void MotorHoming::restore(const float* saved) {
+    for (int i = 0; i < config.motor_count; i++) {
+        positions[i] = saved[i];
+    }
+    referenced = true;
+}
+
+void MotorHoming::start(int64_t now_us) {
+    state = State::HOMING;
+    output = {};
+    metrics = {};
+    start_us = now_us;
+    last_us = now_us;
+    for (int i = 0; i < config.motor_count; i++) {
+        Motor& motor = motors[i];
+        motor.last_checked_us = now_us;
+        motor.stall_count = 0;
+        motor.start_position = positions[i];
+        motor.home = false;
+        metrics.stop_us[i] = -1;
+    }
+}
+
+void MotorHoming::cancel() {
+    if (state == State::HOMING) {
+        finish(State::CANCELLED, last_us);
+    }
+}
+
+void MotorHoming::finish(State final_state, int64_t now_us) {
+    state = final_state;
+    output = {};
+    metrics.duration_us = now_us - start_us;
+}
+
+const MotorHoming::Output& MotorHoming::update(int64_t now_us, const MotorState* states, const bool* valid) {
+    if (state != State::HOMING) {
+        return output;
+    }
+    last_us = now_us;
+    bool spun_up = now_us - start_us >= config.spinup_us;
+    bool all_home = true;
+
+    for (int i = 0; i < config.motor_count; i++) {
+        Motor& motor = motors[i];
+        if (motor.home) {
+            continue;
+        }
+        if (spun_up && (!valid[i] || now_us - states[i].timestamp_us > config.max_feedback_age_us)) {
+            finish(State::NO_FEEDBACK, now_us);
+            return output;
+        }
+
+        // Each new frame after spin-up either extends the stall or ends it
+        const MotorState& sample = states[i];
+        if (valid[i] && sample.timestamp_us > motor.last_checked_us) {
+            motor.last_checked_us = sample.timestamp_us;
+            metrics.peak_torque_nm[i] = fmaxf(metrics.peak_torque_nm[i], fabsf(sample.torque));
+            bool stalled = fabsf(sample.velocity) < config.stall_speed_rad_s ||
+                           fabsf(sample.torque) >= config.stall_torque_nm;
+            if (sample.timestamp_us - start_us < config.spinup_us) {
+                stalled = false;
+            }
+            motor.stall_count = stalled ? motor.stall_count + 1 : 0;
+            if (motor.stall_count >= config.stall_samples) {
+                motor.home = true;
+                metrics.stop_us[i] = sample.timestamp_us - start_us;
+                metrics.travel_rad[i] = positions[i] - motor.start_position;
+                positions[i] = config.home_position_rad;
+            }
+        }
+        output.motor_rad_s[i] = motor.home ? 0.0f : config.speed_rad_s;
+        all_home = all_home && motor.home;
+    }
+
+    if (all_home) {
+        referenced = true;
+        finish(State::HOMED, now_us);
+    } else if (now_us - start_us >= config.timeout_us) {
+        finish(State::TIMED_OUT, now_us);
+    }
+    return output;
+}
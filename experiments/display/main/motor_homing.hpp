@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include "cybergear.hpp"
+#include "motor_state_cache.hpp"
+
+// ============================================================================
+// MotorHoming - Joint positions from feedback, referenced at the hard stops
+// ============================================================================
+// Tracks each motor's joint position by unwrapping the position in its
+// feedback: the field spans only +-4 pi rad and wraps, but between two
+// frames a motor moves far less than half of that (0.6 rad at 30 rad/s and
+// 20 ms), so the shortest step is the true one and nothing drifts at rest.
+// Positions count from wherever the motors were at boot until they are
+// referenced, either by restore() (positions saved at the last clean
+// shutdown) or by homing.
+//
+// Homing drives every motor towards its stop at the same speed, in
+// parallel, and stops each one on its own when it reaches the stop: the
+// speed collapses or the torque climbs as the speed loop winds up against
+// the stop, in stall_samples feedback frames in a row once the spin-up
+// grace period is over. The CyberGear has no index input, so the stall is
+// the only reference. That motor's position becomes home_position_rad; once
+// all are home the positions are referenced. A motor that stops reporting,
+// or a stop not found within timeout_us, ends the run and leaves the
+// positions as they were. The owning task calls track() and, while homing,
+// update() every cycle. Pure arithmetic, so it runs unchanged on host.
+class MotorHoming {
+public:
+    static constexpr int MAX_MOTORS = 4;
+
+    struct Config {
+        int motor_count;
+        float speed_rad_s;            // Towards the stops (the sign picks which)
+        float stall_speed_rad_s;      // At the stop: speed below this...
+        float stall_torque_nm;        // ...or torque at least this...
+        int stall_samples;            // ...in this many feedback frames in a row
+        int64_t spinup_us;            // No stall detection while starting
+        int64_t max_feedback_age_us;  // Give up on a motor silent this long
+        int64_t timeout_us;           // Give up on stops not found by then
+        float home_position_rad;      // Joint position at the stop
+    };
+
+    enum class State : uint8_t {
+        IDLE,
+        HOMING,
+        HOMED,        // Every motor at its stop; positions referenced
+        TIMED_OUT,
+        NO_FEEDBACK,  // A motor stopped reporting
+        CANCELLED,
+    };
+
+    struct Output {
+        float motor_rad_s[MAX_MOTORS];
+    };
+
+    // Result of the last run
+    struct Metrics {
+        int64_t duration_us;
+        int64_t stop_us[MAX_MOTORS];     // Start -> stall detected (-1 if not)
+        float travel_rad[MAX_MOTORS];    // Distance run to the stop
+        float peak_torque_nm[MAX_MOTORS];
+    };
+
+    explicit MotorHoming(const Config& config);
+
+    // Unwrap the latest feedback of one motor (once per cycle is enough; a
+    // frame already seen is skipped)
+    void track(int motor, const MotorState& state);
+
+    // Referenced positions from a previous run
+    void restore(const float* positions);
+
+    void start(int64_t now_us);
+    void cancel();
+
+    // One homing step on the latest feedback (states[i] valid if valid[i])
+    const Output& update(int64_t now_us, const MotorState* states, const bool* valid);
+
+    bool isActive() const { return state == State::HOMING; }
+    bool isReferenced() const { return referenced; }
+    bool isHome(int motor) const { return motors[motor].home; }
+    const float* getPositions() const { return positions; }
+    State getState() const { return state; }
+    const Metrics& getMetrics() const { return metrics; }
+    static const char* stateName(State state);
+
+private:
+    struct Motor {
+        int64_t last_sample_us;    // Feedback tracked up to (-1 if none yet)
+        float last_raw;            // Its position field
+        int64_t last_checked_us;   // Feedback last tested for a stall
+        int stall_count;
+        float start_position;
+        bool home;
+    };
+
+    Config config;
+    State state;
+    bool referenced;
+    float positions[MAX_MOTORS];
+    Motor motors[MAX_MOTORS];
+    Output output;
+    Metrics metrics;
+    int64_t start_us;
+    int64_t last_us;
+
+    void finish(State final_state, int64_t now_us);
+};
@@ -0,0 +1,36 @@
+#include "motor_state_cache.hpp"
+#include <cstring>
+
+void MotorStateCache::publish(int motor, const MotorState& state) {
+    if (motor < 0 || motor >= MAX_MOTORS) {
+        return;
+    }
+    Slot& slot = slots[motor];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.state, &state, sizeof(state));
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool MotorStateCache::read(int motor, MotorState* state) const {
+    if (motor < 0 || motor >= MAX_MOTORS) {
+        return false;
+    }
+    const Slot& slot = slots[motor];
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (!(before & 1)) {
+            memcpy(state, &slot.state, sizeof(*state));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        read_retries.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "cybergear.hpp"
+
+// Latest decoded status of one motor
+struct MotorState {
+    float position;         // rad (frame convention: positive = up)
+    float velocity;         // rad/s
+    float torque;           // Nm
+    float temperature;      // deg C
+    uint8_t faults;         // cybergear::FAULT_* bits
+    cybergear::MotorState mode;
+    int64_t timestamp_us;   // When the feedback frame was received
+};
+
+// ============================================================================
+// MotorStateCache - Lock-free latest state per motor (one writer, any readers)
+// ============================================================================
+// Each slot is a seqlock: the writer bumps the sequence to odd, stores the
+// state and bumps it back to even; readers copy the state and retry if the
+// sequence moved or was odd. Readers never block the writer (the receive
+// dispatcher) and never touch the bus. The writer must not be preempted by
+// a reader mid-publish on its core, so it runs above every reader's priority;
+// read() still gives up after a bounded number of attempts.
+class MotorStateCache {
+public:
+    static constexpr int MAX_MOTORS = 4;
+    static constexpr int MAX_READ_ATTEMPTS = 64;
+
+    // Writer side (single task)
+    void publish(int motor, const MotorState& state);
+
+    // Copy the latest state; false if the motor never reported (or the slot
+    // stayed busy for MAX_READ_ATTEMPTS)
+    bool read(int motor, MotorState* state) const;
+
+    // Reads that had to retry because a publish overlapped (contention)
+    uint32_t getReadRetries() const { return read_retries.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};   // Odd while a write is in progress, 0 = never written
+        MotorState state = {};
+    };
+
+    Slot slots[MAX_MOTORS];
+    mutable std::atomic<uint32_t> read_retries{0};
+};
@@ -0,0 +1,138 @@
+#include "motor_supervisor.hpp"
+#include <cmath>
+
+MotorSupervisor::MotorSupervisor(const Config& config_param)
+    : config(config_param), motors(), scale(1.0f), last_us(-1), output(), stats() {
+    if (config.motor_count > MAX_MOTORS) {
+        config.motor_count = MAX_MOTORS;
+    }
+}
+
+void MotorSupervisor::endEvent(Motor* motor, bool cleared) {
+    if (cleared && ((motor->seen & STALLED) || motor->slowed)) {
+        stats.stalls_avoided++;
+    }
+    motor->conditions = 0;
+    motor->seen = 0;
+    motor->slowed = false;
+    motor->overload_count = 0;
+    motor->stall_count = 0;
+}
+
+void MotorSupervisor::idle(int64_t now_us) {
+    for (int i = 0; i < config.motor_count; i++) {
+        endEvent(&motors[i], false);
+        motors[i].command = 0.0f;
+    }
+    scale = 1.0f;
+    last_us = now_us;
+}
+
+const MotorSupervisor::Output& MotorSupervisor::update(int64_t now_us, const float* setpoint_position,
+                                                      const float* setpoint_velocity, const float* position,
+                                                      const MotorState* states, const bool* valid) {
+    int64_t dt_us = last_us >= 0 ? now_us - last_us : 0;
+    last_us = now_us;
+
+    // Lag of each moving motor behind its setpoint, along its motion
+    float lag[MAX_MOTORS] = {};
+    float lag_min = INFINITY;
+    float lag_max = -INFINITY;
+    bool overloaded = false;
+    bool stalled_any = false;
+    output.abort = false;
+    for (int i = 0; i < config.motor_count; i++) {
+        Motor& motor = motors[i];
+        if (setpoint_velocity[i] != 0.0f) {
+            lag[i] = (setpoint_position[i] - position[i]) * (setpoint_velocity[i] > 0 ? 1.0f : -1.0f);
+            lag_min = fminf(lag_min, lag[i]);
+            lag_max = fmaxf(lag_max, lag[i]);
+        }
+
+        // Each new frame extends or clears the overload and stall counts,
+        // judged against the speed the motor was last asked for
+        const MotorState& state = states[i];
+        if (valid[i] && state.timestamp_us > motor.last_checked_us) {
+            motor.last_checked_us = state.timestamp_us;
+            float torque = fabsf(state.torque);
+            stats.peak_torque_nm[i] = fmaxf(stats.peak_torque_nm[i], torque);
+            float asked = fabsf(motor.command);
+            float speed = state.velocity * (motor.command > 0 ? 1.0f : -1.0f);
+            bool stalled = asked >= config.min_command_rad_s && speed < config.stall_speed_ratio * asked;
+            motor.overload_count = torque >= config.overload_torque_nm ? motor.overload_count + 1 : 0;
+            motor.stall_count = stalled ? motor.stall_count + 1 : 0;
+
+            uint8_t conditions = (motor.overload_count >= config.detect_samples ? OVERLOADED : 0) |
+                                 (motor.stall_count >= config.detect_samples ? STALLED : 0);
+            if (conditions && !motor.conditions) {
+                stats.events++;
+            } else if (!conditions && motor.conditions) {
+                endEvent(&motor, true);
+            }
+            if ((conditions & STALLED) && !(motor.conditions & STALLED)) {
+                motor.stalled_since_us = now_us;
+            }
+            motor.conditions = conditions;
+            motor.seen |= conditions;
+        }
+        overloaded = overloaded || (motor.conditions & OVERLOADED);
+        stalled_any = stalled_any || (motor.conditions & STALLED);
+        if ((motor.conditions & STALLED) && now_us - motor.stalled_since_us >= config.stall_timeout_us) {
+            output.abort = true;
+        }
+    }
+
+    if (output.abort) {
+        stats.aborts++;
+        for (int i = 0; i < config.motor_count; i++) {
+            endEvent(&motors[i], false);
+            motors[i].command = 0.0f;
+            output.motor_rad_s[i] = 0.0f;
+        }
+        scale = 1.0f;
+        return output;
+    }
+
+    // Slow the move while the motor lagging most is behind, as far as it
+    // goes while one is stalled
+    float spread = lag_max > lag_min ? lag_max - lag_min : 0.0f;
+    stats.max_lag_spread_rad = fmaxf(stats.max_lag_spread_rad, spread);
+    float target = 1.0f - config.lag_gain * (lag_max - config.lag_deadband_rad);
+    target = stalled_any ? config.min_scale : fminf(1.0f, fmaxf(config.min_scale, target));
+    if (overloaded && target > scale) {
+        target = scale;
+    }
+    float step = config.scale_rate * dt_us * 1e-6f;
+    scale = target > scale ? fminf(target, scale + step) : fmaxf(target, scale - step);
+
+    // Past the deadband each motor is pulled towards its setpoint: ahead, it
+    // gives way; behind, it catches up
+    bool balancing = scale < 1.0f;
+    for (int i = 0; i < config.motor_count; i++) {
+        float command = setpoint_velocity[i] * scale;
+        float excess = fabsf(lag[i]) - config.lag_deadband_rad;
+        if (setpoint_velocity[i] != 0.0f && excess > 0) {
+            float correction = fminf(config.catch_up_gain * excess, config.max_catch_up_rad_s);
+            float speed = fabsf(command) + (lag[i] > 0 ? correction : -correction);
+            command = speed > 0 ? copysignf(speed, setpoint_velocity[i]) : 0.0f;
+            balancing = true;
+        }
+        motors[i].command = command;
+        output.motor_rad_s[i] = command;
+        if (motors[i].conditions && scale < 1.0f) {
+            motors[i].slowed = true;
+        }
+    }
+
+    if (balancing) {
+        stats.balancing_us += dt_us;
+        stats.time_lost_us += (int64_t)((1.0f - scale) * dt_us);
+    }
+    return output;
+}
+
+MotorSupervisor::Stats MotorSupervisor::takeStats() {
+    Stats snapshot = stats;
+    stats = {};
+    return snapshot;
+}
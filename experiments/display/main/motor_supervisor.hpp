@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include "motor_state_cache.hpp"
+
+// ============================================================================
+// MotorSupervisor - Stall / overload detection and load balancing on a move
+// ============================================================================
+// Watches every motor of a planned move against its setpoint. A motor is
+// overloaded when its torque reaches overload_torque_nm (its current limit
+// is near) and stalled when its speed collapses below stall_speed_ratio of
+// what it is asked for; either, in detect_samples feedback frames in a row,
+// starts an event.
+//
+// Balancing works on the tracking lag of each motor behind its setpoint
+// (tracked positions, so some lag is normal; lag_deadband_rad covers it).
+// When the motor lagging most falls further behind, the move slows (to
+// min_scale while a motor is stalled): the owning task runs the planner on a
+// clock that advances at getScale() times real time, slew limited both ways,
+// and the scale never rises while a motor is overloaded. Past the deadband
+// every motor is also pulled towards its setpoint, never reversing: the
+// leading motors give way to the slowed setpoints while the lagging one gets
+// up to max_catch_up_rad_s extra to catch up, so the frame doesn't rack.
+//
+// A motor stalled for stall_timeout_us ends the move (abort). An event that
+// clears before then counts as a stall avoided if the motor stalled or the
+// move was slowed for it; a torque spike that passes on its own, or an event
+// still open when the move completes, doesn't. Pure arithmetic, so it runs
+// unchanged on host.
+class MotorSupervisor {
+public:
+    static constexpr int MAX_MOTORS = 4;
+
+    struct Config {
+        int motor_count;
+        float overload_torque_nm;     // Overloaded at this torque or more...
+        float stall_speed_ratio;      // ...stalled below this fraction of the command...
+        float min_command_rad_s;      // ...(for commands at least this fast)...
+        int detect_samples;           // ...in this many feedback frames in a row
+        float lag_deadband_rad;       // Lag left alone
+        float lag_gain;               // Scale reduction per rad of worst lag past the deadband
+        float catch_up_gain;          // 1/s: correction per rad of lag past the deadband
+        float max_catch_up_rad_s;     // Most a motor is sped up
+        float min_scale;              // Slowest planner clock (0 pauses the move)
+        float scale_rate;             // Max scale change per second
+        int64_t stall_timeout_us;     // Stalled this long: abort the move
+    };
+
+    enum Condition : uint8_t {
+        OVERLOADED = 0x01,
+        STALLED = 0x02,
+    };
+
+    struct Output {
+        float motor_rad_s[MAX_MOTORS];
+        bool abort;                   // A motor stalled for stall_timeout_us
+    };
+
+    struct Stats {
+        uint32_t events;              // Overload / stall episodes detected
+        uint32_t stalls_avoided;      // ...stalled or slowed for, cleared before an abort
+        uint32_t aborts;
+        int64_t balancing_us;         // Time with the move slowed or a motor corrected
+        int64_t time_lost_us;         // Integral of (1 - scale): the move's extra duration
+        float max_lag_spread_rad;     // Between motors: how far the frame racked
+        float peak_torque_nm[MAX_MOTORS];
+    };
+
+    explicit MotorSupervisor(const Config& config);
+
+    // One step of a move: setpoint positions and velocities at the planner
+    // clock, tracked positions and the latest feedback (states[i] valid if
+    // valid[i]); returns the speeds to command
+    const Output& update(int64_t now_us, const float* setpoint_position, const float* setpoint_velocity,
+                         const float* position, const MotorState* states, const bool* valid);
+
+    // Between moves (the planner is done or stopped): close open events
+    void idle(int64_t now_us);
+
+    // Planner clock rate (0..1)
+    float getScale() const { return scale; }
+
+    // OVERLOADED / STALLED bits of the motor's open event (0 if none)
+    uint8_t getConditions(int motor) const { return motors[motor].conditions; }
+
+    // Snapshot and reset statistics
+    Stats takeStats();
+
+private:
+    struct Motor {
+        int64_t last_checked_us;   // Feedback last tested
+        int overload_count;
+        int stall_count;
+        uint8_t conditions;
+        uint8_t seen;              // Every condition of the open event
+        bool slowed;               // The move ran slowed during it
+        int64_t stalled_since_us;
+        float command;             // Last speed commanded
+    };
+
+    Config config;
+    Motor motors[MAX_MOTORS];
+    float scale;
+    int64_t last_us;
+    Output output;
+    Stats stats;
+
+    void endEvent(Motor* motor, bool cleared);
+};
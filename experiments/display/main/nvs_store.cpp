@@ -0,0 +1,73 @@
+#include "nvs_store.hpp"
+#include "esp_log.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+static const char* TAG = "NvsStore";
+static const char* NVS_NAMESPACE = "bedlift";
+
+bool nvs_store_init(void) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_LOGW(TAG, "NVS partition needs erase (%s)", esp_err_to_name(err));
+        nvs_flash_erase();
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS init failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+bool nvs_store_load(const char* key, void* data, size_t len) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    size_t stored_len = len;
+    esp_err_t err = nvs_get_blob(handle, key, data, &stored_len);
+    nvs_close(handle);
+
+    if (err == ESP_OK && stored_len != len) {
+        ESP_LOGW(TAG, "Ignoring '%s': size %u, expected %u", key, (unsigned)stored_len, (unsigned)len);
+        return false;
+    }
+    return err == ESP_OK;
+}
+
+bool nvs_store_save(const char* key, const void* data, size_t len) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    err = nvs_set_blob(handle, key, data, len);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save '%s': %s", key, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+bool nvs_store_erase(const char* key) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+
+    esp_err_t err = nvs_erase_key(handle, key);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// ============================================================================
+// NVS Store - Persistent settings as fixed-size blobs
+// ============================================================================
+// Thin wrapper over one NVS namespace. Each setting is a plain struct stored
+// under its own key; a load only succeeds if the stored size matches, so a
+// struct change reads as "not saved" rather than as garbage.
+
+// Initialize NVS flash (erases and retries if the partition layout changed)
+bool nvs_store_init(void);
+
+bool nvs_store_load(const char* key, void* data, size_t len);
+bool nvs_store_save(const char* key, const void* data, size_t len);
+bool nvs_store_erase(const char* key);
@@ -47,6 +47,14 @@
 #define BUTTON_MODE_ACTIVE_LOW false
 #define BUTTON_DOWN_ACTIVE_LOW true
 
+// Button masks over GPIO_IN_REG (all buttons live on GPIO 0-31)
+#define BUTTON_SCAN_MASK ((1UL << GPIO_BUTTON_UP) | \
+                          (1UL << GPIO_BUTTON_MODE) | \
+                          (1UL << GPIO_BUTTON_DOWN))
+#define BUTTON_ACTIVE_LOW_MASK (((uint32_t)BUTTON_UP_ACTIVE_LOW << GPIO_BUTTON_UP) | \
+                                ((uint32_t)BUTTON_MODE_ACTIVE_LOW << GPIO_BUTTON_MODE) | \
+                                ((uint32_t)BUTTON_DOWN_ACTIVE_LOW << GPIO_BUTTON_DOWN))
+
 // ============================================================================
 // Power Control - Load Switches
 // ============================================================================
@@ -58,6 +66,9 @@
 // ============================================================================
 #define GPIO_CAN_TX  38  // CAN TX
 #define GPIO_CAN_RX  39  // CAN RX
+#define CAN_TX_QUEUE_LEN  32  // Frames (a full start batch for four motors is 20)
+#define CAN_RX_QUEUE_LEN  32
+#define CAN_BITRATE       1000000  // bit/s (TWAI_TIMING_CONFIG_1MBITS)
 
 // ============================================================================
 // I2C Bus
@@ -65,6 +76,8 @@
 #define GPIO_I2C_SDA  3   // I2C Data
 #define GPIO_I2C_SCL  4   // I2C Clock
 #define I2C_FREQ_HZ   400000  // 400kHz Fast Mode
+#define I2C_QUEUE_DEPTH 72    // Async transfers in flight (2 sensors x 32 FIFO entries + slack)
+#define I2C_TIMEOUT_MS  50
 
 // ============================================================================
 // Accelerometer Configuration
@@ -72,5 +85,10 @@
 #define GPIO_ACC_FRONT_SDO  8   // Front accelerometer SDO/ALT ADDRESS pin (controls address)
 // Rear accelerometer SDO not connected (defaults to 0x53)
 
+// Activity interrupt outputs (INT1, active high); RTC-capable so they can
+// also wake the chip from deep sleep
+#define GPIO_ACC_FRONT_INT1 9
+#define GPIO_ACC_REAR_INT1  10
+
 #define I2C_ADDR_ACC_REAR   0x53  // Rear accelerometer (SDO floating/low)
 #define I2C_ADDR_ACC_FRONT  0x1D  // Front accelerometer (SDO high via GPIO)
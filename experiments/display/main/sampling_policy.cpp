@@ -0,0 +1,108 @@
+#include "sampling_policy.hpp"
+#include "adxl345_regs.hpp"
+
+SamplingPolicy::SamplingPolicy(const Config& config_param)
+    : config(config_param), level(Level::FULL), reason("boot"), level_since_us(0), last_busy_us(0),
+      motors_stopped_us(INT64_MIN / 2), accounted_us(0), stats() {}
+
+const char* SamplingPolicy::levelName(Level level) {
+    switch (level) {
+        case Level::STANDBY:
+            return "STANDBY";
+        case Level::LOW:
+            return "LOW";
+        case Level::REDUCED:
+            return "REDUCED";
+        case Level::FULL:
+            return "FULL";
+        default:
+            return "?";
+    }
+}
+
+SamplingPolicy::Level SamplingPolicy::choose(const Inputs& inputs, int64_t now_us) {
+    // The bubble, the controllers and the calibrator need every sample
+    switch (inputs.mode) {
+        case OperationMode::ROLL:
+        case OperationMode::PITCH:
+        case OperationMode::TORSION:
+        case OperationMode::LEVEL:
+            reason = "attitude mode";
+            return Level::FULL;
+        default:
+            break;
+    }
+    if (inputs.calibrating) {
+        reason = "calibration";
+        return Level::FULL;
+    }
+    if (inputs.motors_active) {
+        motors_stopped_us = now_us;
+        reason = "motors";
+        return Level::FULL;
+    }
+    if (now_us - motors_stopped_us < config.motor_settle_us) {
+        reason = "motor settle";
+        return Level::FULL;
+    }
+
+    // Idle: follow the vibration, with quiet_hold of hysteresis on the way down
+    if (inputs.rms_mg >= config.busy_rms_mg) {
+        last_busy_us = now_us;
+        reason = "movement";
+        return Level::REDUCED;
+    }
+    if (level == Level::FULL) {
+        last_busy_us = now_us;  // Step down through REDUCED
+    }
+    if (level >= Level::REDUCED) {
+        if (inputs.rms_mg >= config.quiet_rms_mg) {
+            last_busy_us = now_us;
+        }
+        if (now_us - last_busy_us < config.quiet_hold_us) {
+            reason = "settling";
+            return Level::REDUCED;
+        }
+    }
+
+    if (config.allow_standby &&
+        (level == Level::STANDBY || (level == Level::LOW && now_us - level_since_us >= config.standby_hold_us))) {
+        reason = "quiet (standby)";
+        return Level::STANDBY;
+    }
+    reason = "quiet";
+    return Level::LOW;
+}
+
+bool SamplingPolicy::update(const Inputs& inputs, int64_t now_us) {
+    getStats(now_us);
+    Level next = choose(inputs, now_us);
+    if (next == level) {
+        return false;
+    }
+    level = next;
+    level_since_us = now_us;
+    stats.transitions++;
+    return true;
+}
+
+const SamplingPolicy::Stats& SamplingPolicy::getStats(int64_t now_us) {
+    if (now_us > accounted_us) {
+        stats.residency_us[(int)level] += now_us - accounted_us;
+        accounted_us = now_us;
+    }
+    return stats;
+}
+
+float SamplingPolicy::getAverageCurrentUa(int64_t now_us) {
+    getStats(now_us);
+    double charge = 0;
+    int64_t total_us = 0;
+    for (int i = 0; i < (int)Level::LEVEL_COUNT; i++) {
+        float current = i == (int)Level::STANDBY ? adxl345::STANDBY_CURRENT_UA
+                                                  : adxl345::supply_current_ua(config.profiles[i].rate_code);
+        charge += (double)current * stats.residency_us[i];
+        total_us += stats.residency_us[i];
+    }
+    return total_us ? (float)(charge / total_us) : 0.0f;
+}
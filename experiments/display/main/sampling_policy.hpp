@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+
+// ============================================================================
+// SamplingPolicy - Accelerometer duty cycle from what the bed is doing
+// ============================================================================
+// Picks one of four sampling levels each task cycle from the operation mode,
+// motor activity and the measured vibration (RMS deviation of the samples):
+//
+//   FULL     attitude modes, motors moving (and settling), calibration
+//   REDUCED  idle but something is moving on the frame
+//   LOW      idle and quiet for quiet_hold
+//   STANDBY  LOW for standby_hold, if allowed (sensor stops measuring)
+//
+// A level is a data rate and a task period applied together, so the FIFO
+// always holds about the same number of samples per drain. Pure bookkeeping:
+// the caller applies the profile and reports time; the policy also keeps
+// residency per level for current and traffic estimates.
+class SamplingPolicy {
+public:
+    enum class Level : uint8_t {
+        STANDBY,
+        LOW,
+        REDUCED,
+        FULL,
+        LEVEL_COUNT
+    };
+
+    struct Profile {
+        uint8_t rate_code;        // BW_RATE code (ignored in STANDBY)
+        uint8_t fifo_watermark;   // Samples per task period
+        uint16_t period_ms;       // Task period
+        uint8_t decimation;       // Decimator factor down to the output rate
+    };
+
+    struct Config {
+        Profile profiles[(int)Level::LEVEL_COUNT];
+        float busy_rms_mg;         // Vibration that counts as movement
+        float quiet_rms_mg;        // Vibration below which the frame is quiet
+        int64_t quiet_hold_us;     // Quiet time before dropping to LOW
+        int64_t motor_settle_us;   // FULL kept after the motors stop
+        int64_t standby_hold_us;   // Time in LOW before STANDBY
+        bool allow_standby;        // False when motion detection must keep running
+    };
+
+    struct Inputs {
+        OperationMode mode;
+        bool motors_active;
+        bool calibrating;
+        float rms_mg;              // Negative if no samples this cycle
+    };
+
+    struct Stats {
+        int64_t residency_us[(int)Level::LEVEL_COUNT];
+        uint32_t transitions;
+    };
+
+    explicit SamplingPolicy(const Config& config);
+
+    // Evaluate one cycle; returns true if the level changed (apply getProfile())
+    bool update(const Inputs& inputs, int64_t now_us);
+
+    Level getLevel() const { return level; }
+    const Profile& getProfile() const { return config.profiles[(int)level]; }
+    const Profile& getProfile(Level l) const { return config.profiles[(int)l]; }
+
+    // Why the current level was chosen (for logs)
+    const char* getReason() const { return reason; }
+
+    // Residency and transitions since boot, accounted up to now_us
+    const Stats& getStats(int64_t now_us);
+
+    // Average supply current of one sensor over the residency (uA)
+    float getAverageCurrentUa(int64_t now_us);
+
+    static const char* levelName(Level level);
+
+private:
+    Config config;
+    Level level;
+    const char* reason;
+    int64_t level_since_us;
+    int64_t last_busy_us;          // Last cycle with movement (or FULL)
+    int64_t motors_stopped_us;     // Last cycle with the motors running
+    int64_t accounted_us;
+    Stats stats;
+
+    Level choose(const Inputs& inputs, int64_t now_us);
+};
@@ -0,0 +1,163 @@
+#include "trajectory_planner.hpp"
+#include <cmath>
+
+TrajectoryPlanner::TrajectoryPlanner(const Config& config_param)
+    : config(config_param), origin(), delta(), accel_limit(0), start_us(0), segments(),
+      segment_count(0), duration_s(0) {
+    if (config.axis_count > MAX_AXES) {
+        config.axis_count = MAX_AXES;
+    }
+}
+
+void TrajectoryPlanner::reset(const float* positions) {
+    for (int i = 0; i < config.axis_count; i++) {
+        origin[i] = positions[i];
+        delta[i] = 0;
+    }
+    segment_count = 0;
+    duration_s = 0;
+    accel_limit = 0;
+}
+
+void TrajectoryPlanner::setMaxVelocity(const float* max_velocity) {
+    for (int i = 0; i < config.axis_count; i++) {
+        config.max_velocity[i] = max_velocity[i];
+    }
+}
+
+void TrajectoryPlanner::addSegment(float duration, float accel, float* s, float* v) {
+    if (duration <= 0) {
+        return;
+    }
+    segments[segment_count++] = Segment{duration, accel, *s, *v};
+    *s += *v * duration + 0.5f * accel * duration * duration;
+    *v += accel * duration;
+    duration_s += duration;
+}
+
+void TrajectoryPlanner::plan(int64_t now_us, const float* targets) {
+    Setpoint current;
+    sample(now_us, &current);
+
+    // New line from the current setpoint; the limits in s are set by the
+    // axis with the least headroom
+    float v_limit = INFINITY;
+    float a_limit = INFINITY;
+    float dot_vd = 0;
+    float dot_dd = 0;
+    for (int i = 0; i < config.axis_count; i++) {
+        origin[i] = current.position[i];
+        delta[i] = targets[i] - current.position[i];
+        float length = fabsf(delta[i]);
+        if (length > 0) {
+            v_limit = fminf(v_limit, config.max_velocity[i] / length);
+            a_limit = fminf(a_limit, config.max_acceleration[i] / length);
+        }
+        dot_vd += current.velocity[i] * delta[i];
+        dot_dd += delta[i] * delta[i];
+    }
+
+    start_us = now_us;
+    segment_count = 0;
+    duration_s = 0;
+    if (dot_dd == 0) {
+        accel_limit = 0;  // Already there (any motion is dropped)
+        return;
+    }
+    accel_limit = a_limit;
+
+    // Carry the velocity component along the new line over
+    float s = 0;
+    float v = dot_vd / dot_dd;
+
+    // Moving away, or too fast to stop by s = 1: brake to rest first
+    float stop_s = v * fabsf(v) / (2 * a_limit);
+    if (v < 0 || stop_s > 1) {
+        float direction = v < 0 ? -1.0f : 1.0f;
+        addSegment(fabsf(v) / a_limit, -direction * a_limit, &s, &v);
+        v = 0;
+    }
+
+    // Trapezoid (or triangle) over what is left, in the direction of travel
+    float remaining = 1 - s;
+    float direction = remaining < 0 ? -1.0f : 1.0f;
+    float distance = fabsf(remaining);
+    float u = v * direction;
+
+    // Entering above the cruise limit (limits lowered by the new line)
+    if (u > v_limit) {
+        float brake = (u - v_limit) / a_limit;
+        addSegment(brake, -direction * a_limit, &s, &v);
+        distance -= (u * u - v_limit * v_limit) / (2 * a_limit);
+        u = v_limit;
+    }
+
+    float peak = sqrtf(a_limit * distance + 0.5f * u * u);
+    peak = fminf(peak, v_limit);
+    peak = fmaxf(peak, u);
+    float accel_time = (peak - u) / a_limit;
+    float decel_time = peak / a_limit;
+    float ramp_distance = (peak * peak - u * u) / (2 * a_limit) + peak * peak / (2 * a_limit);
+    float cruise_time = peak > 0 ? fmaxf(distance - ramp_distance, 0.0f) / peak : 0.0f;
+
+    addSegment(accel_time, direction * a_limit, &s, &v);
+    addSegment(cruise_time, 0.0f, &s, &v);
+    addSegment(decel_time, -direction * a_limit, &s, &v);
+}
+
+void TrajectoryPlanner::stop(int64_t now_us) {
+    float s, v;
+    evaluate(now_us, &s, &v);
+    if (v == 0 || accel_limit == 0) {
+        float targets[MAX_AXES];
+        for (int i = 0; i < config.axis_count; i++) {
+            targets[i] = origin[i] + delta[i] * s;
+        }
+        plan(now_us, targets);
+        return;
+    }
+
+    // Stopping point on the current line at the current deceleration; the
+    // new line is parallel, so plan() only brakes
+    float stop_s = s + v * fabsf(v) / (2 * accel_limit);
+    float targets[MAX_AXES];
+    for (int i = 0; i < config.axis_count; i++) {
+        targets[i] = origin[i] + delta[i] * stop_s;
+    }
+    plan(now_us, targets);
+}
+
+void TrajectoryPlanner::evaluate(int64_t now_us, float* s, float* v) const {
+    float t = (now_us - start_us) * 1e-6f;
+    if (segment_count == 0 || t >= duration_s) {
+        *s = segment_count ? 1.0f : 0.0f;
+        *v = 0;
+        return;
+    }
+    if (t < 0) {
+        t = 0;
+    }
+
+    int i = 0;
+    while (i < segment_count - 1 && t >= segments[i].duration) {
+        t -= segments[i].duration;
+        i++;
+    }
+    const Segment& segment = segments[i];
+    *s = segment.s0 + segment.v0 * t + 0.5f * segment.accel * t * t;
+    *v = segment.v0 + segment.accel * t;
+}
+
+void TrajectoryPlanner::sample(int64_t now_us, Setpoint* setpoint) const {
+    float s, v;
+    evaluate(now_us, &s, &v);
+    for (int i = 0; i < config.axis_count; i++) {
+        setpoint->position[i] = origin[i] + delta[i] * s;
+        setpoint->velocity[i] = delta[i] * v;
+    }
+    setpoint->done = isDone(now_us);
+}
+
+bool TrajectoryPlanner::isDone(int64_t now_us) const {
+    return segment_count == 0 || (now_us - start_us) * 1e-6f >= duration_s;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+// ============================================================================
+// TrajectoryPlanner - Synchronized trapezoidal moves for several axes
+// ============================================================================
+// A move is a straight line in joint space from the current setpoint to the
+// targets, parameterized by s = 0..1: axis i sits at origin_i + delta_i * s.
+// One trapezoidal velocity profile is planned for s, with its velocity and
+// acceleration limits scaled so no axis exceeds its own, so every axis
+// starts, cruises and stops together and the frame never racks.
+//
+// plan() can be called at any time: it starts from the current setpoint and
+// carries the current velocity over (projected onto the new line, which is
+// exact when the new line is parallel, e.g. Up/Down release or reverse).
+// Overshoot and reversal are handled by braking to zero first. Planning is
+// closed form with at most four constant-acceleration segments, so its cost
+// is bounded and independent of the move: one pass over the axes and at most
+// MAX_SEGMENTS segments, no iteration. host/planner_runner holds the p99.9
+// of plan()/stop() under HOST_PLAN_BOUND_NS over random replans; on target
+// motor_task logs the worst plan time per report.
+class TrajectoryPlanner {
+public:
+    static constexpr int MAX_AXES = 4;
+    static constexpr int MAX_SEGMENTS = 4;
+    static constexpr int HOST_PLAN_BOUND_NS = 2000;
+
+    struct Config {
+        int axis_count;
+        float max_velocity[MAX_AXES];       // Per axis (units/s)
+        float max_acceleration[MAX_AXES];   // Per axis (units/s^2)
+    };
+
+    struct Setpoint {
+        float position[MAX_AXES];
+        float velocity[MAX_AXES];
+        bool done;                          // At the targets, at rest
+    };
+
+    explicit TrajectoryPlanner(const Config& config);
+
+    // Hold at positions (no motion)
+    void reset(const float* positions);
+
+    // Per-axis velocity limits for moves planned from now on
+    void setMaxVelocity(const float* max_velocity);
+
+    // Move from the setpoint at now_us to targets
+    void plan(int64_t now_us, const float* targets);
+
+    // Decelerate to rest along the current line as fast as the limits allow
+    void stop(int64_t now_us);
+
+    // Setpoint at now_us
+    void sample(int64_t now_us, Setpoint* setpoint) const;
+
+    bool isDone(int64_t now_us) const;
+
+    // Length of the current plan (seconds from its start)
+    float getDuration() const { return duration_s; }
+
+private:
+    struct Segment {
+        float duration;     // s
+        float accel;        // d2s/dt2
+        float s0;           // s at the segment start
+        float v0;           // ds/dt at the segment start
+    };
+
+    Config config;
+    float origin[MAX_AXES];
+    float delta[MAX_AXES];
+    float accel_limit;      // Scaled d2s/dt2 limit of the current line
+    int64_t start_us;
+    Segment segments[MAX_SEGMENTS];
+    int segment_count;
+    float duration_s;
+
+    void evaluate(int64_t now_us, float* s, float* v) const;
+    void addSegment(float duration, float accel, float* s, float* v);
+};
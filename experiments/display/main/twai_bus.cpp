@@ -0,0 +1,126 @@
+#include "twai_bus.hpp"
+#include <cstring>
+#include "esp_log.h"
+#include "freertos/task.h"
+
+static const char* TAG = "TwaiBus";
+
+bool TwaiBus::init(const Config& config) {
+    twai_general_config_t general = TWAI_GENERAL_CONFIG_DEFAULT(config.tx_io_num, config.rx_io_num, TWAI_MODE_NORMAL);
+    general.tx_queue_len = config.tx_queue_len;
+    general.rx_queue_len = config.rx_queue_len;
+    twai_timing_config_t timing = TWAI_TIMING_CONFIG_1MBITS();
+    twai_filter_config_t filter = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+
+    esp_err_t err = twai_driver_install(&general, &timing, &filter);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Driver install failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    err = twai_start();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Start failed: %s", esp_err_to_name(err));
+        twai_driver_uninstall();
+        return false;
+    }
+    twai_reconfigure_alerts(ALERTS, NULL);
+    running = true;
+    return true;
+}
+
+int TwaiBus::transmit(const CanFrame* frames, int count) {
+    if (!running) {
+        tx_refused += count;
+        return 0;
+    }
+
+    int sent = 0;
+    while (sent < count) {
+        const CanFrame& frame = frames[sent];
+        twai_message_t message = {};
+        message.extd = frame.extended;
+        message.identifier = frame.id;
+        message.data_length_code = frame.len;
+        memcpy(message.data, frame.data, frame.len);
+        if (twai_transmit(&message, 0) != ESP_OK) {
+            break;
+        }
+        sent++;
+    }
+    tx_frames += sent;
+    tx_refused += count - sent;
+    return sent;
+}
+
+bool TwaiBus::receive(CanFrame* frame, TickType_t timeout) {
+    twai_message_t message;
+    if (!running || twai_receive(&message, timeout) != ESP_OK) {
+        return false;
+    }
+    frame->id = message.identifier;
+    frame->extended = message.extd;
+    frame->len = message.data_length_code > 8 ? 8 : message.data_length_code;
+    memcpy(frame->data, message.data, frame->len);
+    rx_frames++;
+    return true;
+}
+
+bool TwaiBus::waitForReceive(TickType_t timeout) {
+    if (!running) {
+        vTaskDelay(timeout);
+        return false;
+    }
+
+    uint32_t alerts = 0;
+    if (twai_read_alerts(&alerts, timeout) != ESP_OK) {
+        return false;
+    }
+    if (alerts & TWAI_ALERT_RX_QUEUE_FULL) {
+        rx_queue_full++;
+    }
+    if (alerts & TWAI_ALERT_BUS_ERROR) {
+        bus_errors++;
+    }
+    if (alerts & TWAI_ALERT_ERR_PASS) {
+        ESP_LOGW(TAG, "Controller error passive");
+    }
+    if (alerts & TWAI_ALERT_BUS_OFF) {
+        ESP_LOGE(TAG, "Bus off");
+    }
+    return alerts & (TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL);
+}
+
+TwaiBus::Stats TwaiBus::takeStats() {
+    Stats snapshot = {};
+    snapshot.tx_frames = tx_frames.exchange(0);
+    snapshot.tx_refused = tx_refused.exchange(0);
+    snapshot.rx_frames = rx_frames.exchange(0);
+    snapshot.rx_queue_full = rx_queue_full.exchange(0);
+    snapshot.bus_errors = bus_errors.exchange(0);
+
+    // Hardware counters are cumulative
+    twai_status_info_t status;
+    if (running && twai_get_status_info(&status) == ESP_OK) {
+        uint32_t missed = status.rx_missed_count + status.rx_overrun_count;
+        snapshot.rx_missed = missed - last_rx_missed;
+        last_rx_missed = missed;
+    }
+    return snapshot;
+}
+
+bool TwaiBus::readStatus(CanBusStatus* status) {
+    twai_status_info_t info;
+    if (!running || twai_get_status_info(&info) != ESP_OK) {
+        return false;
+    }
+    status->bus_off = info.state == TWAI_STATE_BUS_OFF;
+    status->msgs_to_tx = info.msgs_to_tx;
+    status->msgs_to_rx = info.msgs_to_rx;
+    status->tx_error_counter = info.tx_error_counter;
+    status->rx_error_counter = info.rx_error_counter;
+    status->tx_failed_count = info.tx_failed_count;
+    status->rx_missed_count = info.rx_missed_count + info.rx_overrun_count;
+    status->arb_lost_count = info.arb_lost_count;
+    status->bus_error_count = info.bus_error_count;
+    return true;
+}
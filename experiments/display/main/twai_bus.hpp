@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "driver/gpio.h"
+#include "driver/twai.h"
+#include "freertos/FreeRTOS.h"
+#include "can_frame.hpp"
+#include "can_telemetry.hpp"
+
+// ============================================================================
+// TwaiBus - The ESP32 TWAI (CAN 2.0) controller at 1 Mbit/s
+// ============================================================================
+// Installed once and shared by everything on the bus. transmit() never
+// blocks: frames that don't fit in the driver's TX queue are refused and
+// counted, so a stalled bus can't hold up the caller's cycle. One task
+// receives: it sleeps in waitForReceive() until the driver raises an RX
+// alert, then drains with receive(). Frames lost to a full RX queue or a
+// hardware FIFO overrun are counted.
+class TwaiBus {
+public:
+    struct Config {
+        gpio_num_t tx_io_num;
+        gpio_num_t rx_io_num;
+        uint32_t tx_queue_len;
+        uint32_t rx_queue_len;
+    };
+
+    struct Stats {
+        uint32_t tx_frames;
+        uint32_t tx_refused;     // TX queue full or bus off
+        uint32_t rx_frames;
+        uint32_t rx_queue_full;  // RX queue-full alerts (driver dropped a frame)
+        uint32_t rx_missed;      // Frames lost in hardware (FIFO full / overrun)
+        uint32_t bus_errors;
+    };
+
+    bool init(const Config& config);
+
+    // Queue frames without blocking; returns how many were accepted (in order)
+    int transmit(const CanFrame* frames, int count);
+
+    // Block until a frame arrives (or timeout); true if frames are waiting
+    bool waitForReceive(TickType_t timeout);
+
+    // Next received frame, waiting up to timeout
+    bool receive(CanFrame* frame, TickType_t timeout);
+
+    // Snapshot and reset statistics (safe alongside transmit and receive)
+    Stats takeStats();
+
+    // Controller state, queue depths and cumulative error counters
+    bool readStatus(CanBusStatus* status);
+
+private:
+    static constexpr uint32_t ALERTS = TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL |
+                                       TWAI_ALERT_BUS_ERROR | TWAI_ALERT_ERR_PASS | TWAI_ALERT_BUS_OFF;
+
+    bool running = false;
+    std::atomic<uint32_t> tx_frames{0};
+    std::atomic<uint32_t> tx_refused{0};
+    std::atomic<uint32_t> rx_frames{0};
+    std::atomic<uint32_t> rx_queue_full{0};
+    std::atomic<uint32_t> bus_errors{0};
+    uint32_t last_rx_missed = 0;
+};
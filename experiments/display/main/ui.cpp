@@ -1,6 +1,7 @@
 #include "ui.hpp"
 #include "config.hpp"
 #include "assets/icons.hpp"
+#include <cstdio>
 #include <cstring>
 #include <cstring>  // for strcmp in icon lookup
 
@@ -59,6 +60,16 @@ void StatusBar::draw() {
             current_x += MONITOR_ICON_SIZE + icon_spacing;
         }
     }
+
+    // CAN bus load, right-aligned (dev mode only)
+    if (monitors_->dev_mode && monitors_->bus_load_pct >= 0) {
+        char text[12];
+        snprintf(text, sizeof(text), "CAN %d%%", monitors_->bus_load_pct);
+        gfx->setTextColor(monitors_->bus_load_pct >= 70 ? COLOR_ORANGE : COLOR_LIGHTGREY);
+        gfx->setTextSize(1);
+        gfx->setTextDatum(middle_right);
+        gfx->drawString(text, x_ + w_ - 4, y_ + h_ / 2);
+    }
 }
 
 // ============================================================================
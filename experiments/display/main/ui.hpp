@@ -25,19 +25,7 @@ private:
 // ============================================================================
 // ModePanel - Left panel showing current mode with icon
 // ============================================================================
-enum class OperationMode {
-    UP_DOWN = 0,    // Manual up/down control
-    ROLL,           // Roll adjustment
-    PITCH,          // Pitch adjustment
-    TORSION,        // Torsion adjustment
-    LEVEL,          // Level mode
-    MOTOR_1,        // Individual motor 1 control
-    MOTOR_2,        // Individual motor 2 control
-    MOTOR_3,        // Individual motor 3 control
-    MOTOR_4,        // Individual motor 4 control
-    MODE_COUNT      // For cycling - must be last
-};
-
+// OperationMode is defined in config.hpp alongside MODE_CONFIGS
 class ModePanel {
 public:
     ModePanel();
@@ -1,5 +1,6 @@
 #include "ui_manager.hpp"
 #include "config.hpp"
+#include "mode_state_machine.hpp"
 #include "esp_log.h"
 
 static const char* TAG = "UIManager";
@@ -85,25 +86,8 @@ OperationMode UIManager::getMode() const {
 }
 
 void UIManager::cycleMode() {
-    int current = (int)getMode();
-    int next_mode = current;
-
-    // Find next available mode (skip dev_only modes if dev_flag is false)
-    do {
-        next_mode = (next_mode + 1) % (int)OperationMode::MODE_COUNT;
-
-        // If we've cycled back to current mode, we're stuck (shouldn't happen)
-        if (next_mode == current) {
-            break;
-        }
-
-        // Check if this mode is available
-        if (!MODE_CONFIGS[next_mode].dev_only || dev_flag) {
-            break;  // Mode is available
-        }
-    } while (true);
-
-    setMode((OperationMode)next_mode);
+    // Next available mode comes from the precomputed cycle table
+    setMode(mode_transition(dev_flag, getMode(), ModeEvent::MODE_PRESS).next);
 }
 
 void UIManager::setButtonState(int button_index, bool pressed) {